@@ -1,5 +1,7 @@
 #include <citro2d.h>
 #include <vector>
+#include "game.h"
+#include "presets.h"
 
 const int TOP_SCREEN_WIDTH = 400;
 const int BOTTOM_SCREEN_WIDTH = 320;
@@ -9,7 +11,6 @@ C3D_RenderTarget *topScreen = nullptr;
 C3D_RenderTarget *bottomScreen = nullptr;
 
 bool isGamePaused;
-bool isAutoPlayMode = true;
 
 C2D_TextBuf scoresBuffer;
 C2D_TextBuf livesBuffer;
@@ -25,124 +26,18 @@ const u32 GREEN = C2D_Color32(0x00, 0xFF, 0x00, 0xFF);
 const u32 RED = C2D_Color32(0xFF, 0x00, 0x00, 0xFF);
 const u32 BLUE = C2D_Color32(0x00, 0x00, 0xFF, 0xFF);
 
-typedef struct
-{
-	float x;
-	float y;
-	float z;
-	float w;
-	float h;
-	unsigned int color;
-	bool isDestroyed;
-	int brickPoints;
-} Rectangle;
-
-Rectangle player = {BOTTOM_SCREEN_WIDTH / 2, SCREEN_HEIGHT - 16, 0, 40, 8, WHITE};
-Rectangle ball = {BOTTOM_SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 0, 10, 10, WHITE};
-Rectangle touchBounds = {0, 0, 0, 8, 8, WHITE};
-
-const int PLAYER_SPEED = 10;
-
-int ballVelocityX = 5;
-int ballVelocityY = 5;
-
-int playerScore;
-int playerLives = 2;
-
-std::vector<Rectangle> createBricks()
-{
-	std::vector<Rectangle> bricks;
-	bricks.reserve(70);
-
-	int brickPoints = 10;
-	int positionX;
-	int positionY = 20;
-
-	for (int row = 0; row < 10; row++)
-	{
-		positionX = 0;
-
-		for (int column = 0; column < 7; column++)
-		{
-			unsigned int color = RED;
-
-			if (row % 2 == 0)
-			{
-				color = BLUE;
-			}
-
-			Rectangle actualBrick = {(float)positionX, (float)positionY, 0, 41, 8, color, false, brickPoints};
+Game game;
 
-			bricks.push_back(actualBrick);
-			positionX += 43;
-		}
-
-		brickPoints--;
-		positionY += 10;
-	}
-
-	return bricks;
-}
-
-std::vector<Rectangle> bricks = createBricks();
-
-bool hasCollision(Rectangle &bounds, Rectangle &ball)
-{
-	return bounds.x < ball.x + ball.w && bounds.x + bounds.w > ball.x &&
-		   bounds.y < ball.y + ball.h && bounds.y + bounds.h > ball.y;
-}
+Bounds touchBounds = {0, 0, 8, 8};
 
 void update()
 {
 	int keyHeld = hidKeysHeld();
 
-	if (keyHeld & KEY_LEFT && player.x > 0)
-	{
-		player.x -= PLAYER_SPEED;
-	}
-
-	else if (keyHeld & KEY_RIGHT && player.x < BOTTOM_SCREEN_WIDTH - player.w)
-	{
-		player.x += PLAYER_SPEED;
-	}
+	GameInput input = {(keyHeld & KEY_LEFT) != 0, (keyHeld & KEY_RIGHT) != 0};
 
-	if (ball.y > SCREEN_HEIGHT + ball.h)
-	{
-		ball.x = BOTTOM_SCREEN_WIDTH / 2;
-		ball.y = SCREEN_HEIGHT / 2;
-
-		ballVelocityX *= -1;
-
-		if (playerLives > 0)
-		{
-			playerLives--;
-		}
-	}
-
-	if (ball.x < 0 || ball.x > BOTTOM_SCREEN_WIDTH - ball.w)
-	{
-		ballVelocityX *= -1;
-	}
-
-	else if (hasCollision(player, ball) || ball.y < 0)
-	{
-		ballVelocityY *= -1;
-	}
-
-	for (Rectangle &brick : bricks)
-	{
-		if (!brick.isDestroyed && hasCollision(brick, ball))
-		{
-			ballVelocityY *= -1;
-			brick.isDestroyed = true;
-			playerScore += brick.brickPoints;
-
-			break;
-		}
-	}
-
-	ball.x += ballVelocityX;
-	ball.y += ballVelocityY;
+	// speeds in the preset are per frame, so each frame is one unit of time.
+	updateGame(game, input, 1);
 }
 
 void renderTopScreen()
@@ -156,14 +51,14 @@ void renderTopScreen()
 
 	char buffer[160];
 	C2D_Text dynamicText;
-	snprintf(buffer, sizeof(buffer), "Score: %d", playerScore);
+	snprintf(buffer, sizeof(buffer), "Score: %d", game.playerScore);
 	C2D_TextParse(&dynamicText, scoresBuffer, buffer);
 	C2D_TextOptimize(&dynamicText);
 	C2D_DrawText(&dynamicText, C2D_AlignCenter | C2D_WithColor, 100, 175, 0, textSize, textSize, WHITE);
 
 	char buffer2[160];
 	C2D_Text dynamicText2;
-	snprintf(buffer2, sizeof(buffer2), "Lives: %d", playerLives);
+	snprintf(buffer2, sizeof(buffer2), "Lives: %d", game.playerLives);
 	C2D_TextParse(&dynamicText2, livesBuffer, buffer2);
 	C2D_TextOptimize(&dynamicText2);
 	C2D_DrawText(&dynamicText2, C2D_AlignCenter | C2D_WithColor, 275, 175, 0, textSize, textSize, WHITE);
@@ -182,17 +77,25 @@ void renderBottomScreen()
 	C2D_TargetClear(bottomScreen, BLACK);
 	C2D_SceneBegin(bottomScreen);
 
-	for (Rectangle &brick : bricks)
+	for (int row = 0; row < game.bricks.rows; row++)
 	{
-		if (!brick.isDestroyed)
+		u32 color = RED;
+
+		if (row % 2 == 0)
 		{
-			C2D_DrawRectSolid(brick.x, brick.y, brick.z, brick.w, brick.h, brick.color);
+			color = BLUE;
+		}
+
+		for (int column = findNextBrick(game.bricks, row, 0); column >= 0; column = findNextBrick(game.bricks, row, column + 1))
+		{
+			Bounds brick = getBrickBounds(game.config, row, column);
+			C2D_DrawRectSolid(brick.x, brick.y, 0, brick.w, brick.h, color);
 		}
 	}
 
-	C2D_DrawRectSolid(ball.x, ball.y, ball.z, ball.w, ball.h, ball.color);
+	C2D_DrawRectSolid(game.ball.x, game.ball.y, 0, game.ball.w, game.ball.h, WHITE);
 
-	C2D_DrawRectSolid(player.x, player.y, player.z, player.w, player.h, player.color);
+	C2D_DrawRectSolid(game.player.x, game.player.y, 0, game.player.w, game.player.h, WHITE);
 
 	C3D_FrameEnd(0);
 }
@@ -215,6 +118,8 @@ int main(int argc, char *argv[])
 	C2D_TextParse(&gamePauseTexts[0], gamePausedBuffer, "Game Paused");
 	C2D_TextOptimize(&gamePauseTexts[0]);
 
+	initGame(game, N3DS_CONFIG);
+
 	touchPosition touch;
 
 	while (aptMainLoop())
@@ -223,9 +128,9 @@ int main(int argc, char *argv[])
 
 		hidTouchRead(&touch);
 
-		if (touch.px > 0 && touch.py > 0 && touch.px < BOTTOM_SCREEN_WIDTH - player.w)
+		if (touch.px > 0 && touch.py > 0 && touch.px < BOTTOM_SCREEN_WIDTH - game.player.w)
 		{
-			player.x = touch.px;
+			game.player.x = touch.px;
 		}
 
 		touchBounds.x = touch.px;
@@ -239,12 +144,7 @@ int main(int argc, char *argv[])
 
 		if (keyDown & KEY_A)
 		{
-			isAutoPlayMode = !isAutoPlayMode;
-		}
-
-		if (isAutoPlayMode && ball.x < BOTTOM_SCREEN_WIDTH - player.w)
-		{
-			player.x = ball.x;
+			game.isAutoPlayMode = !game.isAutoPlayMode;
 		}
 
 		if (!isGamePaused)
@@ -1,4 +1,5 @@
 #include "starter.h"
+#include "presets.h"
 #include <iostream>
 #include <vector>
 
@@ -32,111 +33,51 @@ const int RED = RGB15(255, 0, 0);
 const int BLUE = RGB15(0, 0, 255);
 
 bool isGamePaused;
-bool isAutoPlayMode = true;
 
-Rectangle player = {HALF_WIDTH, SCREEN_HEIGHT - 16, 35, 8, WHITE};
-Rectangle ball = {HALF_WIDTH, HALF_HEIGHT, 8, 8, WHITE};
+Game game;
 
-const int PLAYER_SPEED = 5;
+// ARM9 cycles spent in updateGame(), averaged over a second and shown on the top screen, so
+// this build and a soft-float one (make NUMBER=float) can be compared on the hardware.
+const int UPDATE_TIMER = 2;
+const int TIMED_UPDATES = 60;
 
-int ballVelocityX = 2;
-int ballVelocityY = 2;
+u32 updateTicks = 0;
+int timedUpdates = 0;
+u32 cyclesPerUpdate = 0;
 
-int playerScore;
-int playerLives = 2;
-
-std::vector<Rectangle> createBricks()
-{
-	std::vector<Rectangle> bricks;
-	bricks.reserve(49);
-
-	int brickPoints = 10;
-	int positionX;
-	int positionY = 20;
-
-	for (int row = 0; row < 7; row++)
-	{
-		positionX = 0;
-
-		for (int column = 0; column < 7; column++)
-		{
-			unsigned int color = RED;
-
-			if (row % 2 == 0)
-			{
-				color = BLUE;
-			}
-
-			Rectangle actualBrick = {(float)positionX, (float)positionY, 35, 8, color, false, brickPoints};
-
-			bricks.push_back(actualBrick);
-			positionX += 37;
-		}
-
-		brickPoints--;
-		positionY += 10;
-	}
-
-	return bricks;
-}
-
-std::vector<Rectangle> bricks = createBricks();
+#ifdef BREAKOUT_FIXED_POINT
+const char *NUMBER_NAME = "FIXED";
+#else
+const char *NUMBER_NAME = "FLOAT";
+#endif
 
 void update()
 {
 	int keyHeld = keysHeld();
 
-	if (keyHeld & KEY_LEFT && player.x > 0)
-	{
-		player.x -= PLAYER_SPEED;
-	}
+	GameInput input = {(keyHeld & KEY_LEFT) != 0, (keyHeld & KEY_RIGHT) != 0};
 
-	else if (keyHeld & KEY_RIGHT && player.x < SCREEN_WIDTH - player.w)
-	{
-		player.x += PLAYER_SPEED;
-	}
+	cpuStartTiming(UPDATE_TIMER);
 
-	if (ball.y > SCREEN_HEIGHT + ball.h)
-	{
-		ball.x = HALF_WIDTH;
-		ball.y = HALF_HEIGHT;
+	// speeds in the preset are per frame, so each frame is one unit of time.
+	int events = updateGame(game, input, 1);
 
-		ballVelocityX *= -1;
-
-		if (playerLives > 0)
-		{
-			playerLives--;
-		}
-	}
+	updateTicks += cpuEndTiming();
+	timedUpdates++;
 
-	if (ball.x < 0 || ball.x > SCREEN_WIDTH - ball.w)
+	if (timedUpdates == TIMED_UPDATES)
 	{
-		ballVelocityX *= -1;
-		mmEffectEx(&collisionSound);
-	}
+		// The timers count at the bus clock, half the ARM9's.
+		cyclesPerUpdate = updateTicks * 2 / TIMED_UPDATES;
 
-	else if (hasCollision(player, ball) || ball.y < 0)
-	{
-		ballVelocityY *= -1;
-		mmEffectEx(&collisionSound);
+		updateTicks = 0;
+		timedUpdates = 0;
 	}
 
-	for (Rectangle &brick : bricks)
+	if (events & (GAME_EVENT_WALL_HIT | GAME_EVENT_CEILING_HIT | GAME_EVENT_PLAYER_HIT | GAME_EVENT_BRICK_HIT))
 	{
-		if (!brick.isDestroyed && hasCollision(brick, ball))
-		{
-			mmEffectEx(&collisionSound);
-
-			ballVelocityY *= -1;
-			brick.isDestroyed = true;
-			playerScore += brick.brickPoints;
-
-			break;
-		}
+		mmEffectEx(&collisionSound);
 	}
-
-	ball.x += ballVelocityX;
-	ball.y += ballVelocityY;
 }
 
 void renderTopScreen()
@@ -150,14 +91,18 @@ void renderTopScreen()
 
 	glColor(RGB15(0, 31, 31));
 
-	std::string scoreString = "SCORE: " + std::to_string(playerScore);
+	std::string scoreString = "SCORE: " + std::to_string(game.playerScore);
 
 	Font.Print(20, SCREEN_HEIGHT - 16, scoreString.c_str());
 
-	std::string livesString = "LIVES: " + std::to_string(playerLives);
+	std::string livesString = "LIVES: " + std::to_string(game.playerLives);
 
 	Font.Print(HALF_WIDTH + 40, SCREEN_HEIGHT - 16, livesString.c_str());
 
+	std::string cyclesString = std::string(NUMBER_NAME) + " UPDATE: " + std::to_string(cyclesPerUpdate) + " CYCLES";
+
+	Font.Print(20, 8, cyclesString.c_str());
+
 	if (isGamePaused)
 	{
 		Font.PrintCentered(0, HALF_HEIGHT, "GAME PAUSED");
@@ -175,16 +120,23 @@ void renderBottomScreen()
 	
 	glBegin2D();
 
-	for (Rectangle &brick : bricks)
+	for (int row = 0; row < game.bricks.rows; row++)
 	{
-		if (!brick.isDestroyed)
+		unsigned int color = RED;
+
+		if (row % 2 == 0)
 		{
-			drawRectangle(brick);
+			color = BLUE;
+		}
+
+		for (int column = findNextBrick(game.bricks, row, 0); column >= 0; column = findNextBrick(game.bricks, row, column + 1))
+		{
+			drawRectangle(getBrickBounds(game.config, row, column), color);
 		}
 	}
 
-	drawRectangle(player);
-	drawRectangle(ball);
+	drawRectangle(game.player, WHITE);
+	drawRectangle(game.ball, WHITE);
 
 	glEnd2D();
 }
@@ -242,6 +194,8 @@ int main(int argc, char *argv[])
 		255,
 	};
 
+	initGame(game, NDS_CONFIG);
+
 	int frame = 0;
 
 	touchPosition touch;
@@ -254,9 +208,9 @@ int main(int argc, char *argv[])
 
 		touchRead(&touch);
 
-		if (touch.px > 0 && touch.py > 0 && touch.px < SCREEN_WIDTH - player.w)
+		if (touch.px > 0 && touch.py > 0 && touch.px < SCREEN_WIDTH - game.player.w)
 		{
-			player.x = touch.px;
+			game.player.x = touch.px;
 		}
 
 		int keyDown = keysDown();
@@ -270,12 +224,7 @@ int main(int argc, char *argv[])
 
 		if (keyDown & KEY_A)
 		{
-			isAutoPlayMode = !isAutoPlayMode;
-		}
-
-		if (isAutoPlayMode && ball.x < SCREEN_WIDTH - player.w)
-		{
-			player.x = ball.x;
+			game.isAutoPlayMode = !game.isAutoPlayMode;
 		}
 
 		if (!isGamePaused)
@@ -1,14 +1,8 @@
 #include "starter.h"
 
-void drawRectangle(Rectangle &rectangle)
+void drawRectangle(const Bounds &bounds, unsigned int color)
 {
-	glBoxFilled(rectangle.x, rectangle.y, rectangle.x + rectangle.w, rectangle.y + rectangle.h, rectangle.color);
-}
-
-bool hasCollision(Rectangle &bounds, Rectangle &ball)
-{
-	return bounds.x < ball.x + ball.w && bounds.x + bounds.w > ball.x &&
-		   bounds.y < ball.y + ball.h && bounds.y + bounds.h > ball.y;
+	glBoxFilled((int)bounds.x, (int)bounds.y, (int)(bounds.x + bounds.w), (int)(bounds.y + bounds.h), color);
 }
 
 void initSubSprites()
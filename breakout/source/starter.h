@@ -2,20 +2,8 @@
 
 #include <nds.h>
 #include <gl2d.h>
+#include "game.h"
 
-typedef struct
-{
-	float x;
-	float y;
-	float w;
-	float h;
-	unsigned int color;
-	bool isDestroyed;
-	int brickPoints;
-} Rectangle;
-
-void drawRectangle(Rectangle &rectangle);
-
-bool hasCollision(Rectangle &bounds, Rectangle &ball);
+void drawRectangle(const Bounds &bounds, unsigned int color);
 
 void initSubSprites();
@@ -0,0 +1,43 @@
+#include "cook_profile.h"
+#include <cstring>
+
+const std::vector<CookProfile> &getCookProfiles()
+{
+    // The PC port opens its device at 48 kHz, and the Switch port opens SDL_mixer at 48 kHz
+    // 16-bit stereo, so its cooked sounds go to Mix_QuickLoad_RAW() as they are.
+    static const std::vector<CookProfile> profiles = {
+        {
+            "pc",
+            "pc/bin/debug/res",
+            48000,
+            false,
+            512,
+            {{"sounds/magic.wav", "cooked/magic.pcm"}, {"sounds/drop.wav", "cooked/drop.pcm"}},
+            {{"fonts/square_sans_serif_7.ttf", 32, "cooked/square_sans_serif_7.font"}},
+        },
+        {
+            "switch",
+            "switch/romfs/data",
+            48000,
+            false,
+            512,
+            {{"pop1.wav", "cooked/pop1.pcm"}, {"pop2.wav", "cooked/pop2.pcm"}},
+            {{"LeroyLetteringLightBeta01.ttf", 36, "cooked/LeroyLetteringLightBeta01.font"}},
+        },
+    };
+
+    return profiles;
+}
+
+const CookProfile *findCookProfile(const char *name)
+{
+    for (const CookProfile &profile : getCookProfiles())
+    {
+        if (strcmp(profile.name, name) == 0)
+        {
+            return &profile;
+        }
+    }
+
+    return nullptr;
+}
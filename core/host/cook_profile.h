@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+// What breakout_cook prepares for one port, and in which format.
+
+typedef struct
+{
+    const char *source;
+    const char *cooked;
+} CookSound;
+
+typedef struct
+{
+    const char *source;
+    int size;
+    const char *cooked;
+} CookFont;
+
+typedef struct
+{
+    const char *name;
+
+    // Relative to the repository. The sources and cooked files are relative to it, the
+    // way the port opens them.
+    const char *assetDirectory;
+
+    // The rate the port's mixer runs at; sounds are always cooked as 16-bit stereo.
+    int rate;
+    bool isBigEndian;
+
+    // The atlas width the port's bakeGlyphAtlas() packs into.
+    int atlasWidth;
+
+    std::vector<CookSound> sounds;
+    std::vector<CookFont> fonts;
+} CookProfile;
+
+const std::vector<CookProfile> &getCookProfiles();
+
+// nullptr when there is no profile called name.
+const CookProfile *findCookProfile(const char *name);
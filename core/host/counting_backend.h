@@ -0,0 +1,35 @@
+#pragma once
+
+#include "render_list.h"
+
+// A RenderBackend that draws nothing and counts what a real one would be asked to do,
+// so the state changes and draw calls of a frame can be measured without a GPU.
+class CountingBackend : public RenderBackend
+{
+public:
+    CountingBackend() : textureChanges(0), colorChanges(0), drawCalls(0), primitives(0) {}
+
+    void setTexture(int) override { textureChanges++; }
+    void setColor(uint32_t) override { colorChanges++; }
+
+    void fillRects(const AtlasRect *, int count) override
+    {
+        drawCalls++;
+        primitives += count;
+    }
+
+    void copyQuads(const GlyphQuad *, int count) override
+    {
+        drawCalls++;
+        primitives += count;
+    }
+
+    int stateChanges() const { return textureChanges + colorChanges; }
+
+    long long textureChanges;
+    long long colorChanges;
+    long long drawCalls;
+
+    // Rects and quads in all the draw calls.
+    long long primitives;
+};
@@ -0,0 +1,109 @@
+#include "font_raster.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+bool rasterizeFont(const char *path, int size, int atlasWidth, CookedFont &font)
+{
+    FT_Library library;
+
+    if (FT_Init_FreeType(&library) != 0)
+    {
+        printf("Unable to initialize FreeType!\n");
+        return false;
+    }
+
+    FT_Face face;
+
+    if (FT_New_Face(library, path, 0, &face) != 0 || FT_Set_Pixel_Sizes(face, 0, size) != 0)
+    {
+        printf("Unable to open %s!\n", path);
+        FT_Done_FreeType(library);
+        return false;
+    }
+
+    GlyphAtlas &atlas = font.atlas;
+
+    int ascent = (int)((face->size->metrics.ascender + 63) >> 6);
+    int descent = (int)(face->size->metrics.descender >> 6);
+    atlas.lineHeight = ascent - descent;
+
+    // Where each glyph's bitmap goes in its cell, kept for the copy after packing.
+    int offsetsX[GLYPH_COUNT];
+    std::vector<std::vector<uint8_t>> bitmaps(GLYPH_COUNT);
+    std::vector<int> bitmapWidths(GLYPH_COUNT, 0);
+    std::vector<int> bitmapTops(GLYPH_COUNT, 0);
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        AtlasRect &glyph = atlas.glyphs[i];
+        glyph.w = 0;
+        glyph.h = 0;
+        atlas.advances[i] = 0;
+        offsetsX[i] = 0;
+
+        if (FT_Load_Char(face, FIRST_GLYPH + i, FT_LOAD_RENDER) != 0)
+        {
+            continue;
+        }
+
+        FT_GlyphSlot slot = face->glyph;
+        const FT_Bitmap &bitmap = slot->bitmap;
+
+        int advance = (int)((slot->advance.x + 63) >> 6);
+        int left = slot->bitmap_left > 0 ? slot->bitmap_left : 0;
+        int width = left + (int)bitmap.width;
+
+        atlas.advances[i] = advance;
+        glyph.w = width > advance ? width : advance;
+        glyph.h = atlas.lineHeight;
+        offsetsX[i] = left;
+        bitmapWidths[i] = (int)bitmap.width;
+        bitmapTops[i] = ascent - slot->bitmap_top;
+
+        bitmaps[i].resize((size_t)bitmap.width * bitmap.rows);
+
+        for (unsigned int row = 0; row < bitmap.rows; row++)
+        {
+            const uint8_t *source = bitmap.buffer + row * abs(bitmap.pitch);
+            std::copy(source, source + bitmap.width, bitmaps[i].begin() + row * bitmap.width);
+        }
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+
+    if (!packGlyphAtlas(atlas, atlasWidth))
+    {
+        printf("%s at %d pixels doesn't fit an atlas %d pixels wide!\n", path, size, atlasWidth);
+        return false;
+    }
+
+    font.alpha.assign((size_t)atlas.width * atlas.height, 0);
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        const AtlasRect &glyph = atlas.glyphs[i];
+        int rows = bitmapWidths[i] > 0 ? (int)bitmaps[i].size() / bitmapWidths[i] : 0;
+
+        for (int row = 0; row < rows; row++)
+        {
+            int y = bitmapTops[i] + row;
+
+            // Glyphs reaching above the ascent or below the descent are clipped to the line.
+            if (y < 0 || y >= glyph.h)
+            {
+                continue;
+            }
+
+            const uint8_t *source = &bitmaps[i][row * bitmapWidths[i]];
+            uint8_t *destination = &font.alpha[(size_t)(glyph.y + y) * atlas.width + glyph.x + offsetsX[i]];
+
+            std::copy(source, source + bitmapWidths[i], destination);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "cooked.h"
+
+// Renders the printable ASCII glyphs of the font at path, size pixels tall, with FreeType
+// and packs them into an atlas atlasWidth pixels wide. Each glyph is a cell as tall as the
+// font's line with the glyph on the baseline, like the ones SDL_ttf renders for the SDL
+// ports' bakeGlyphAtlas(), so text lays out the same from a cooked atlas.
+bool rasterizeFont(const char *path, int size, int atlasWidth, CookedFont &font);
@@ -0,0 +1,198 @@
+#include "frame_capture.h"
+#include <chrono>
+#include <cstring>
+
+static bool hasExtension(const char *path, const char *extension)
+{
+    size_t pathLength = strlen(path);
+    size_t extensionLength = strlen(extension);
+
+    return pathLength >= extensionLength && strcmp(path + pathLength - extensionLength, extension) == 0;
+}
+
+FrameCapture::FrameCapture()
+    : file(nullptr), captureFormat(CAPTURE_FORMAT_RAW), width(0), height(0), writeIndex(0), readIndex(0), isStopping(false),
+      hasWriteFailed(false), submitted(0), dropped(0), written(0), seconds(0)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    close();
+}
+
+bool FrameCapture::open(const char *path, int frameWidth, int frameHeight, int framesPerSecond, int bufferCount)
+{
+    close();
+
+    if (frameWidth <= 0 || frameHeight <= 0 || framesPerSecond <= 0 || bufferCount <= 0)
+    {
+        printf("Invalid capture size, rate or buffer count!\n");
+        return false;
+    }
+
+    file = fopen(path, "wb");
+
+    if (file == nullptr)
+    {
+        printf("Unable to open %s for the capture!\n", path);
+        return false;
+    }
+
+    captureFormat = hasExtension(path, ".y4m") ? CAPTURE_FORMAT_Y4M : CAPTURE_FORMAT_RAW;
+    width = frameWidth;
+    height = frameHeight;
+
+    // Every buffer is allocated up front, submit() never allocates.
+    buffers.assign(bufferCount, std::vector<uint32_t>(width * height));
+    writeIndex = 0;
+    readIndex = 0;
+
+    if (captureFormat == CAPTURE_FORMAT_Y4M)
+    {
+        planes.resize(width * height * 3);
+        fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, framesPerSecond);
+    }
+
+    submitted = 0;
+    dropped = 0;
+    written = 0;
+    seconds = 0;
+    isStopping = false;
+    hasWriteFailed = false;
+
+    writer = std::thread(&FrameCapture::writerLoop, this);
+
+    return true;
+}
+
+bool FrameCapture::submit(const uint32_t *pixels)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    submitted++;
+
+    unsigned int index = writeIndex.load(std::memory_order_relaxed);
+    bool isQueued = file != nullptr && index - readIndex.load(std::memory_order_acquire) < buffers.size();
+
+    if (isQueued)
+    {
+        memcpy(buffers[index % buffers.size()].data(), pixels, width * height * sizeof(uint32_t));
+        writeIndex.store(index + 1, std::memory_order_release);
+
+        // The writer never sleeps for long, so this doesn't need the lock.
+        frameReady.notify_one();
+    }
+    else
+    {
+        dropped++;
+    }
+
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return isQueued;
+}
+
+void FrameCapture::close()
+{
+    if (file == nullptr)
+    {
+        return;
+    }
+
+    isStopping = true;
+    frameReady.notify_one();
+    writer.join();
+
+    if (fclose(file) != 0 || hasWriteFailed)
+    {
+        printf("Writing the capture failed, it is incomplete!\n");
+    }
+
+    file = nullptr;
+    buffers.clear();
+}
+
+int FrameCapture::format() const
+{
+    return captureFormat;
+}
+
+long long FrameCapture::submittedFrames() const
+{
+    return submitted;
+}
+
+long long FrameCapture::writtenFrames() const
+{
+    return written;
+}
+
+long long FrameCapture::droppedFrames() const
+{
+    return dropped;
+}
+
+double FrameCapture::submitSeconds() const
+{
+    return seconds;
+}
+
+void FrameCapture::writerLoop()
+{
+    while (true)
+    {
+        unsigned int index = readIndex.load(std::memory_order_relaxed);
+
+        if (index == writeIndex.load(std::memory_order_acquire))
+        {
+            if (isStopping)
+            {
+                return;
+            }
+
+            // submit() notifies without the lock, so a wakeup can be missed; the timeout
+            // bounds how long a frame can wait for it.
+            std::unique_lock<std::mutex> lock(mutex);
+            frameReady.wait_for(lock, std::chrono::milliseconds(1));
+            continue;
+        }
+
+        if (!hasWriteFailed && !writeFrame(buffers[index % buffers.size()].data()))
+        {
+            hasWriteFailed = true;
+        }
+
+        written++;
+        readIndex.store(index + 1, std::memory_order_release);
+    }
+}
+
+bool FrameCapture::writeFrame(const uint32_t *pixels)
+{
+    int pixelCount = width * height;
+
+    if (captureFormat == CAPTURE_FORMAT_RAW)
+    {
+        // 0xAARRGGBB in little-endian memory is already B, G, R, A.
+        return fwrite(pixels, sizeof(uint32_t), pixelCount, file) == (size_t)pixelCount;
+    }
+
+    uint8_t *yPlane = planes.data();
+    uint8_t *uPlane = yPlane + pixelCount;
+    uint8_t *vPlane = uPlane + pixelCount;
+
+    // BT.601 studio range in 8-bit fixed point.
+    for (int i = 0; i < pixelCount; i++)
+    {
+        int r = (pixels[i] >> 16) & 0xff;
+        int g = (pixels[i] >> 8) & 0xff;
+        int b = pixels[i] & 0xff;
+
+        yPlane[i] = (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        uPlane[i] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        vPlane[i] = (uint8_t)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    return fputs("FRAME\n", file) >= 0 && fwrite(planes.data(), 1, planes.size(), file) == planes.size();
+}
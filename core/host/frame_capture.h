@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+enum CaptureFormat
+{
+    CAPTURE_FORMAT_RAW,
+    CAPTURE_FORMAT_Y4M,
+};
+
+// Writes rendered frames to a file on its own thread. submit() copies a frame into one of
+// a fixed ring of buffers allocated by open() and returns straight away; the writer
+// thread empties the ring to disk. When every buffer is still waiting to be written the
+// frame is dropped and counted instead, so a slow disk never stalls the simulation.
+//
+// A path ending in .y4m gets a YUV4MPEG2 (4:4:4) stream any video player can open;
+// anything else gets the raw pixels, four bytes per pixel in B, G, R, A order, e.g.
+// ffmpeg -f rawvideo -pixel_format bgra -video_size 960x544 -framerate 60 -i out.raw out.mp4
+// Host only.
+class FrameCapture
+{
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    // Opens path and starts the writer. Pixels are 0xAARRGGBB, like a Framebuffer.
+    bool open(const char *path, int width, int height, int framesPerSecond, int bufferCount);
+
+    // Queues a copy of width * height pixels, or drops the frame if the ring is full.
+    // Returns false when the frame was dropped. Only one thread may submit.
+    bool submit(const uint32_t *pixels);
+
+    // Writes every queued frame, stops the writer and closes the file.
+    void close();
+
+    int format() const;
+
+    long long submittedFrames() const;
+    long long writtenFrames() const;
+    long long droppedFrames() const;
+
+    // Time spent in submit(), in seconds, which is what capture costs the simulation.
+    double submitSeconds() const;
+
+private:
+    void writerLoop();
+    bool writeFrame(const uint32_t *pixels);
+
+    FILE *file;
+    int captureFormat;
+    int width;
+    int height;
+
+    // The ring: submit() fills the buffer at writeIndex, the writer empties the one at
+    // readIndex. Both only ever grow; the buffer is the index modulo the ring size.
+    std::vector<std::vector<uint32_t>> buffers;
+    std::atomic<unsigned int> writeIndex;
+    std::atomic<unsigned int> readIndex;
+
+    // Y4M planes, converted on the writer thread.
+    std::vector<uint8_t> planes;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::atomic<bool> isStopping;
+    std::atomic<bool> hasWriteFailed;
+
+    long long submitted;
+    long long dropped;
+    std::atomic<long long> written;
+    double seconds;
+};
@@ -0,0 +1,44 @@
+#include "scene.h"
+
+const int GLYPH_WIDTH = 18;
+const int GLYPH_HEIGHT = 32;
+
+void createTestGlyphs(GlyphAtlas &atlas, AlphaImage &mask)
+{
+    atlas.lineHeight = GLYPH_HEIGHT;
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        atlas.glyphs[i].w = GLYPH_WIDTH;
+        atlas.glyphs[i].h = GLYPH_HEIGHT;
+        atlas.advances[i] = GLYPH_WIDTH + 2;
+    }
+
+    packGlyphAtlas(atlas, 512);
+
+    mask.width = atlas.width;
+    mask.height = atlas.height;
+    mask.alpha.assign(mask.width * mask.height, 0);
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        const AtlasRect &glyph = atlas.glyphs[i];
+
+        for (int y = 2; y < glyph.h - 2; y++)
+        {
+            for (int x = 2; x < glyph.w - 2; x++)
+            {
+                int value = (x * 37 + y * 91 + i * 53) & 0x1ff;
+
+                mask.alpha[(glyph.y + y) * mask.width + glyph.x + x] = (uint8_t)(value > 255 ? 255 : value);
+            }
+        }
+    }
+}
+
+AtlasRect scaleBounds(const Bounds &bounds, float scaleX, float scaleY)
+{
+    AtlasRect rect = {(int)(bounds.x * scaleX), (int)(bounds.y * scaleY), (int)(bounds.w * scaleX), (int)(bounds.h * scaleY)};
+
+    return rect;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "game.h"
+#include "soft_renderer.h"
+#include "text.h"
+#include <cstdio>
+#include <stdint.h>
+#include <vector>
+
+// The PC port's picture of a game (HUD text, bricks, paddle and ball) for the host tools
+// that render without SDL, scaled to any screen size.
+
+const uint32_t SCENE_BLACK = 0xff000000;
+const uint32_t SCENE_CYAN = 0xff00ffff;
+const uint32_t SCENE_WHITE = 0xffffffff;
+
+// Made-up 18x32 glyphs with full, partial and no coverage, so every blend path runs
+// without a font library.
+void createTestGlyphs(GlyphAtlas &atlas, AlphaImage &mask);
+
+AtlasRect scaleBounds(const Bounds &bounds, float scaleX, float scaleY);
+
+// Draws game on anything with begin(color), drawGlyphs(quads, color), fillRects(rects, color) and end().
+template <typename Canvas>
+void drawGameScene(Canvas &canvas, const Game &game, const GlyphAtlas &atlas, float scaleX, float scaleY)
+{
+    static std::vector<AtlasRect> rects;
+    static std::vector<GlyphQuad> quads;
+
+    canvas.begin(SCENE_BLACK);
+
+    char text[32];
+    quads.clear();
+
+    snprintf(text, sizeof(text), "score: %d", game.playerScore);
+    layoutText(atlas, text, (int)(200 * scaleX), 0, quads);
+
+    snprintf(text, sizeof(text), "lives: %d", game.playerLives);
+    layoutText(atlas, text, (int)(600 * scaleX), 0, quads);
+
+    canvas.drawGlyphs(quads, SCENE_WHITE);
+
+    rects.clear();
+
+    for (int row = 0; row < game.bricks.rows; row++)
+    {
+        for (int column = findNextBrick(game.bricks, row, 0); column >= 0; column = findNextBrick(game.bricks, row, column + 1))
+        {
+            rects.push_back(scaleBounds(getBrickBounds(game.config, row, column), scaleX, scaleY));
+        }
+    }
+
+    canvas.fillRects(rects, SCENE_CYAN);
+
+    rects.clear();
+    rects.push_back(scaleBounds(game.player, scaleX, scaleY));
+    rects.push_back(scaleBounds(game.ball, scaleX, scaleY));
+
+    canvas.fillRects(rects, SCENE_WHITE);
+
+    canvas.end();
+}
+
+// drawGameScene() onto a SoftRenderer.
+class SoftCanvas
+{
+public:
+    SoftCanvas(SoftRenderer &renderer, const AlphaImage &mask) : renderer(renderer), mask(mask) {}
+
+    void begin(uint32_t color) { renderer.begin(color); }
+    void drawGlyphs(const std::vector<GlyphQuad> &quads, uint32_t color) { renderer.drawGlyphs(quads, mask, color); }
+    void end() { renderer.end(); }
+
+    void fillRects(const std::vector<AtlasRect> &rects, uint32_t color)
+    {
+        for (const AtlasRect &rect : rects)
+        {
+            renderer.fillRect(rect, color);
+        }
+    }
+
+private:
+    SoftRenderer &renderer;
+    const AlphaImage &mask;
+};
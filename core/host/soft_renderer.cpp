@@ -0,0 +1,268 @@
+#include "soft_renderer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Wide tiles keep spans long; 64 rows keep a tile's pixels in L2.
+const int TILE_WIDTH = 128;
+const int TILE_HEIGHT = 64;
+
+void fillSpanScalar(uint32_t *pixels, int count, uint32_t color)
+{
+    for (int i = 0; i < count; i++)
+    {
+        pixels[i] = color;
+    }
+}
+
+// (source * alpha + destination * (255 - alpha)) / 255 rounded, per 8-bit channel. The
+// SIMD path does the same integer math, so both give identical pixels.
+static inline uint32_t blendChannel(uint32_t source, uint32_t destination, uint32_t alpha)
+{
+    uint32_t total = source * alpha + destination * (255 - alpha) + 128;
+
+    return (total + (total >> 8)) >> 8;
+}
+
+static inline uint32_t blendPixel(uint32_t destination, uint32_t color, uint32_t alpha)
+{
+    uint32_t pixel = 0;
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        pixel |= blendChannel((color >> shift) & 0xff, (destination >> shift) & 0xff, alpha) << shift;
+    }
+
+    return pixel;
+}
+
+void blendSpanScalar(uint32_t *pixels, const uint8_t *alpha, int count, uint32_t color)
+{
+    for (int i = 0; i < count; i++)
+    {
+        pixels[i] = blendPixel(pixels[i], color, alpha[i]);
+    }
+}
+
+void fillSpan(uint32_t *pixels, int count, uint32_t color)
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256i colors = _mm256_set1_epi32((int)color);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_si256((__m256i *)(pixels + i), colors);
+    }
+#elif defined(__SSE2__)
+    __m128i colors = _mm_set1_epi32((int)color);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_si128((__m128i *)(pixels + i), colors);
+    }
+#endif
+
+    fillSpanScalar(pixels + i, count - i, color);
+}
+
+void blendSpan(uint32_t *pixels, const uint8_t *alpha, int count, uint32_t color)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    // Two pixels per 16-bit half: channels widened to 16 bits so the products fit.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i colors = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t coverage;
+        memcpy(&coverage, alpha + i, 4);
+
+        if (coverage == 0)
+        {
+            continue;
+        }
+
+        __m128i destination = _mm_loadu_si128((const __m128i *)(pixels + i));
+
+        // Each coverage byte repeated over its pixel's four channels.
+        __m128i alphas = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)coverage), zero);
+        alphas = _mm_unpacklo_epi16(alphas, alphas);
+        __m128i alphasLow = _mm_unpacklo_epi32(alphas, alphas);
+        __m128i alphasHigh = _mm_unpackhi_epi32(alphas, alphas);
+
+        __m128i destinationLow = _mm_unpacklo_epi8(destination, zero);
+        __m128i destinationHigh = _mm_unpackhi_epi8(destination, zero);
+
+        __m128i totalLow = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(colors, alphasLow),
+                                                       _mm_mullo_epi16(destinationLow, _mm_sub_epi16(full, alphasLow))), half);
+        __m128i totalHigh = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(colors, alphasHigh),
+                                                        _mm_mullo_epi16(destinationHigh, _mm_sub_epi16(full, alphasHigh))), half);
+
+        totalLow = _mm_srli_epi16(_mm_add_epi16(totalLow, _mm_srli_epi16(totalLow, 8)), 8);
+        totalHigh = _mm_srli_epi16(_mm_add_epi16(totalHigh, _mm_srli_epi16(totalHigh, 8)), 8);
+
+        _mm_storeu_si128((__m128i *)(pixels + i), _mm_packus_epi16(totalLow, totalHigh));
+    }
+#endif
+
+    blendSpanScalar(pixels + i, alpha + i, count - i, color);
+}
+
+void drawSoftCommand(Framebuffer &framebuffer, const SoftCommand &command, const AtlasRect &clip)
+{
+    const AtlasRect &rect = command.destination;
+
+    int left = std::max(rect.x, clip.x);
+    int top = std::max(rect.y, clip.y);
+    int right = std::min(rect.x + rect.w, clip.x + clip.w);
+    int bottom = std::min(rect.y + rect.h, clip.y + clip.h);
+
+    if (left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    for (int y = top; y < bottom; y++)
+    {
+        uint32_t *row = &framebuffer.pixels[y * framebuffer.width + left];
+
+        if (command.type == SOFT_COMMAND_FILL)
+        {
+            fillSpan(row, right - left, command.color);
+        }
+        else
+        {
+            const AlphaImage &mask = *command.mask;
+            const uint8_t *coverage = &mask.alpha[(command.maskY + y - rect.y) * mask.width + command.maskX + left - rect.x];
+
+            blendSpan(row, coverage, right - left, command.color);
+        }
+    }
+}
+
+SoftRenderer::SoftRenderer(int width, int height, ThreadPool *pool)
+    : pool(pool),
+      tileColumns((width + TILE_WIDTH - 1) / TILE_WIDTH),
+      tileRows((height + TILE_HEIGHT - 1) / TILE_HEIGHT)
+{
+    target.width = width;
+    target.height = height;
+    target.pixels.assign(width * height, 0);
+
+    tileCommands.resize(tileColumns * tileRows);
+}
+
+void SoftRenderer::begin(uint32_t clearColor)
+{
+    commands.clear();
+
+    for (std::vector<int> &tile : tileCommands)
+    {
+        tile.clear();
+    }
+
+    // Clearing is a fill like any other, so it is split over the tiles too.
+    AtlasRect screen = {0, 0, target.width, target.height};
+    fillRect(screen, clearColor);
+}
+
+void SoftRenderer::fillRect(const AtlasRect &rect, uint32_t color)
+{
+    SoftCommand command = {SOFT_COMMAND_FILL, color, rect, nullptr, 0, 0};
+
+    addCommand(command);
+}
+
+void SoftRenderer::drawGlyphs(const std::vector<GlyphQuad> &quads, const AlphaImage &mask, uint32_t color)
+{
+    for (const GlyphQuad &quad : quads)
+    {
+        // Glyphs are blitted at their baked size.
+        AtlasRect destination = {quad.destination.x, quad.destination.y, quad.source.w, quad.source.h};
+        SoftCommand command = {SOFT_COMMAND_BLEND_MASK, color, destination, &mask, quad.source.x, quad.source.y};
+
+        addCommand(command);
+    }
+}
+
+void SoftRenderer::addCommand(const SoftCommand &command)
+{
+    const AtlasRect &rect = command.destination;
+
+    if (rect.w <= 0 || rect.h <= 0 || rect.x + rect.w <= 0 || rect.y + rect.h <= 0 || rect.x >= target.width || rect.y >= target.height)
+    {
+        return;
+    }
+
+    int firstColumn = std::max(rect.x, 0) / TILE_WIDTH;
+    int firstRow = std::max(rect.y, 0) / TILE_HEIGHT;
+    int lastColumn = std::min((rect.x + rect.w - 1) / TILE_WIDTH, tileColumns - 1);
+    int lastRow = std::min((rect.y + rect.h - 1) / TILE_HEIGHT, tileRows - 1);
+
+    int index = (int)commands.size();
+    commands.push_back(command);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            tileCommands[row * tileColumns + column].push_back(index);
+        }
+    }
+}
+
+void SoftRenderer::rasterizeTile(int tile)
+{
+    int column = tile % tileColumns;
+    int row = tile / tileColumns;
+
+    AtlasRect clip = {
+        column * TILE_WIDTH,
+        row * TILE_HEIGHT,
+        std::min(TILE_WIDTH, target.width - column * TILE_WIDTH),
+        std::min(TILE_HEIGHT, target.height - row * TILE_HEIGHT),
+    };
+
+    for (int index : tileCommands[tile])
+    {
+        drawSoftCommand(target, commands[index], clip);
+    }
+}
+
+void SoftRenderer::end()
+{
+    int tileCount = tileColumns * tileRows;
+
+    if (pool == nullptr)
+    {
+        for (int tile = 0; tile < tileCount; tile++)
+        {
+            rasterizeTile(tile);
+        }
+
+        return;
+    }
+
+    pool->run(tileCount, [this](int tile, int worker) { rasterizeTile(tile); });
+}
+
+const Framebuffer &SoftRenderer::framebuffer() const
+{
+    return target;
+}
+
+int SoftRenderer::commandCount() const
+{
+    return (int)commands.size();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "text.h"
+#include "thread_pool.h"
+#include <stdint.h>
+#include <vector>
+
+// Pixels are 0xAARRGGBB, row by row.
+typedef struct
+{
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+} Framebuffer;
+
+// One coverage byte per pixel, e.g. a glyph atlas baked without a font library's colors.
+typedef struct
+{
+    int width;
+    int height;
+    std::vector<uint8_t> alpha;
+} AlphaImage;
+
+enum SoftCommandType
+{
+    SOFT_COMMAND_FILL,
+    SOFT_COMMAND_BLEND_MASK,
+};
+
+typedef struct
+{
+    int type;
+    uint32_t color;
+    AtlasRect destination;
+
+    // Where the coverage comes from for SOFT_COMMAND_BLEND_MASK; the same size as destination.
+    const AlphaImage *mask;
+    int maskX;
+    int maskY;
+} SoftCommand;
+
+// Span routines, exposed so the bench can check the SIMD versions against plain loops.
+void fillSpan(uint32_t *pixels, int count, uint32_t color);
+void blendSpan(uint32_t *pixels, const uint8_t *alpha, int count, uint32_t color);
+void fillSpanScalar(uint32_t *pixels, int count, uint32_t color);
+void blendSpanScalar(uint32_t *pixels, const uint8_t *alpha, int count, uint32_t color);
+
+// Draws command, clipped to clip, with the span routines.
+void drawSoftCommand(Framebuffer &framebuffer, const SoftCommand &command, const AtlasRect &clip);
+
+// Draws filled rects and alpha-blended glyphs into a Framebuffer without a GPU. A frame's
+// commands are recorded between begin() and end(); end() sorts them into screen tiles
+// and rasterizes the tiles in parallel on pool. Every tile replays its commands in the
+// order they were recorded, so the picture is the same as drawing them one by one.
+// Host only, like the pool.
+class SoftRenderer
+{
+public:
+    // pool can be nullptr to rasterize every tile on the calling thread.
+    SoftRenderer(int width, int height, ThreadPool *pool);
+
+    void begin(uint32_t clearColor);
+
+    void fillRect(const AtlasRect &rect, uint32_t color);
+
+    // One blend per quad, taking coverage from mask at each quad's source rect.
+    void drawGlyphs(const std::vector<GlyphQuad> &quads, const AlphaImage &mask, uint32_t color);
+
+    void end();
+
+    const Framebuffer &framebuffer() const;
+
+    int commandCount() const;
+
+private:
+    void addCommand(const SoftCommand &command);
+    void rasterizeTile(int tile);
+
+    Framebuffer target;
+    ThreadPool *pool;
+
+    int tileColumns;
+    int tileRows;
+
+    std::vector<SoftCommand> commands;
+    std::vector<std::vector<int>> tileCommands;
+};
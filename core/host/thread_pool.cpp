@@ -0,0 +1,176 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : queues(new WorkerQueue[threadCount > 0 ? threadCount : 1]()),
+      currentTask(nullptr),
+      generation(0),
+      isStopping(false),
+      activeWorkers(0),
+      remainingTasks(0),
+      steals(0)
+{
+    if (threadCount < 1)
+    {
+        threadCount = 1;
+    }
+
+    threads.reserve(threadCount);
+
+    for (int worker = 0; worker < threadCount; worker++)
+    {
+        threads.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+
+    workReady.notify_all();
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+int ThreadPool::threadCount() const
+{
+    return (int)threads.size();
+}
+
+long long ThreadPool::stealCount() const
+{
+    return steals.load();
+}
+
+void ThreadPool::run(int taskCount, const std::function<void(int, int)> &task)
+{
+    if (taskCount <= 0)
+    {
+        return;
+    }
+
+    int workerCount = threadCount();
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    remainingTasks = taskCount;
+    currentTask = &task;
+    generation++;
+
+    // The queues are filled after the run is published and under the same lock, so a
+    // worker can't find this run's tasks before it can see the task they belong to.
+    // Contiguous slices, so neighbouring tasks stay on one worker until someone steals.
+    for (int worker = 0; worker < workerCount; worker++)
+    {
+        int first = (int)((long long)taskCount * worker / workerCount);
+        int last = (int)((long long)taskCount * (worker + 1) / workerCount);
+
+        std::lock_guard<std::mutex> queueLock(queues[worker].mutex);
+
+        queues[worker].generation = generation;
+
+        for (int index = first; index < last; index++)
+        {
+            queues[worker].tasks.push_back(index);
+        }
+    }
+
+    workReady.notify_all();
+    // Also wait for every worker to leave the task loop, so none of them can pick up
+    // the next run's tasks while still holding this run's task.
+    workDone.wait(lock, [this] { return remainingTasks.load() == 0 && activeWorkers == 0; });
+
+    currentTask = nullptr;
+}
+
+bool ThreadPool::popTask(int worker, unsigned int taskGeneration, int &task)
+{
+    {
+        WorkerQueue &own = queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+
+        if (own.generation == taskGeneration && !own.tasks.empty())
+        {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+
+            return true;
+        }
+    }
+
+    int workerCount = threadCount();
+
+    for (int offset = 1; offset < workerCount; offset++)
+    {
+        WorkerQueue &victim = queues[(worker + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (victim.generation == taskGeneration && !victim.tasks.empty())
+        {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            steals++;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(int worker)
+{
+    unsigned int seenGeneration = 0;
+
+    while (true)
+    {
+        const std::function<void(int, int)> *task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workReady.wait(lock, [&] { return isStopping || generation != seenGeneration; });
+
+            if (isStopping)
+            {
+                return;
+            }
+
+            seenGeneration = generation;
+            task = currentTask;
+
+            // The run this worker was woken for already finished without it.
+            if (task == nullptr)
+            {
+                continue;
+            }
+
+            activeWorkers++;
+        }
+
+        int index;
+
+        while (popTask(worker, seenGeneration, index))
+        {
+            (*task)(index, worker);
+
+            if (--remainingTasks == 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                workDone.notify_all();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        activeWorkers--;
+
+        if (activeWorkers == 0)
+        {
+            workDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a batch of independent tasks on a fixed set of worker threads. Every worker
+// starts with its own slice of the tasks and takes work from the back of its own
+// queue; when it runs dry it steals from the front of another worker's queue, so
+// uneven tasks (games that end early, games that run long) still keep every core busy.
+// Host only: the console ports never compile this.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    // Calls task(index, worker) once for every index in [0, taskCount) and returns
+    // when all of them are done. worker is in [0, threadCount()) and can be used to
+    // pick per-thread scratch state.
+    void run(int taskCount, const std::function<void(int, int)> &task);
+
+    int threadCount() const;
+
+    // Tasks taken from another worker's queue since the pool was created.
+    long long stealCount() const;
+
+private:
+    // generation is the run the tasks belong to, so a worker only takes tasks of the
+    // run it picked up the task function for.
+    typedef struct
+    {
+        std::mutex mutex;
+        unsigned int generation;
+        std::deque<int> tasks;
+    } WorkerQueue;
+
+    void workerLoop(int worker);
+    bool popTask(int worker, unsigned int taskGeneration, int &task);
+
+    std::vector<std::thread> threads;
+    std::unique_ptr<WorkerQueue[]> queues;
+
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+
+    const std::function<void(int, int)> *currentTask;
+    unsigned int generation;
+    bool isStopping;
+    int activeWorkers;
+
+    std::atomic<int> remainingTasks;
+    std::atomic<long long> steals;
+};
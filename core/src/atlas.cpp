@@ -0,0 +1,98 @@
+#include "atlas.h"
+#include <algorithm>
+
+// The rects' indices, tallest first. Stable, so rects of the same height keep the order they came in.
+static std::vector<int> sortByHeight(const std::vector<AtlasRect> &rects)
+{
+    std::vector<int> order(rects.size());
+
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&rects](int a, int b) { return rects[a].h > rects[b].h; });
+
+    return order;
+}
+
+int packAtlas(std::vector<AtlasRect> &rects, int width, int padding)
+{
+    std::vector<int> order = sortByHeight(rects);
+
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (int index : order)
+    {
+        AtlasRect &rect = rects[index];
+
+        if (rect.w > width)
+        {
+            return -1;
+        }
+
+        if (shelfX + rect.w > width)
+        {
+            shelfX = 0;
+            shelfY += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+
+        rect.x = shelfX;
+        rect.y = shelfY;
+
+        shelfX += rect.w + padding;
+        shelfHeight = std::max(shelfHeight, rect.h);
+    }
+
+    return shelfY + shelfHeight;
+}
+
+int packAtlasPages(std::vector<AtlasRect> &rects, std::vector<int> &pages, int width, int height, int padding)
+{
+    std::vector<int> order = sortByHeight(rects);
+
+    pages.assign(rects.size(), 0);
+
+    int page = 0;
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (int index : order)
+    {
+        AtlasRect &rect = rects[index];
+
+        if (rect.w > width || rect.h > height)
+        {
+            return -1;
+        }
+
+        if (shelfX + rect.w > width)
+        {
+            shelfX = 0;
+            shelfY += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+
+        // The rects only get shorter, so a shelf that doesn't fit means a new page.
+        if (shelfY + rect.h > height)
+        {
+            page++;
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        rect.x = shelfX;
+        rect.y = shelfY;
+        pages[index] = page;
+
+        shelfX += rect.w + padding;
+        shelfHeight = std::max(shelfHeight, rect.h);
+    }
+
+    return rects.empty() ? 0 : page + 1;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+typedef struct
+{
+    int x;
+    int y;
+    int w;
+    int h;
+} AtlasRect;
+
+// Places rects on shelves in an atlas width pixels wide, tallest first, leaving padding
+// pixels between them. Reads w and h and writes x and y. Returns the height the atlas
+// needs, or -1 when a rect doesn't fit in the width.
+int packAtlas(std::vector<AtlasRect> &rects, int width, int padding);
+
+// Like packAtlas() but onto as many pages of width x height as it takes, e.g. the sprite
+// images of a port on textures no bigger than its GPU allows. Writes each rect's page to
+// pages. Returns the number of pages, or -1 when a rect doesn't fit on an empty page.
+int packAtlasPages(std::vector<AtlasRect> &rects, std::vector<int> &pages, int width, int height, int padding);
@@ -0,0 +1,112 @@
+#include "audio_stage.h"
+
+void initAudioStage(AudioStage &stage, int voiceCount)
+{
+    StageVoice idle = {-1, 0, 0, 0};
+
+    stage.sounds.clear();
+    stage.voices.assign(voiceCount, idle);
+    stage.soundFrames.clear();
+    stage.frame = 0;
+    stage.startDelay = 0;
+
+    stage.events = 0;
+    stage.played = 0;
+    stage.coalesced = 0;
+    stage.stolen = 0;
+    stage.dropped = 0;
+}
+
+int addStageSound(AudioStage &stage, int priority, double seconds)
+{
+    StageSound sound = {priority, seconds};
+
+    stage.sounds.push_back(sound);
+    stage.soundFrames.push_back(-1);
+
+    return (int)stage.sounds.size() - 1;
+}
+
+// A free voice at startTime, else the one to steal, else -1 when every voice plays something
+// more important than priority.
+static int pickVoice(const AudioStage &stage, int priority, double startTime, bool &isStealing)
+{
+    int victim = -1;
+
+    for (int i = 0; i < (int)stage.voices.size(); i++)
+    {
+        const StageVoice &voice = stage.voices[i];
+
+        if (voice.sound < 0 || voice.endTime <= startTime)
+        {
+            isStealing = false;
+            return i;
+        }
+
+        if (victim < 0 || voice.priority < stage.voices[victim].priority ||
+            (voice.priority == stage.voices[victim].priority && voice.startTime < stage.voices[victim].startTime))
+        {
+            victim = i;
+        }
+    }
+
+    isStealing = true;
+
+    return victim >= 0 && stage.voices[victim].priority <= priority ? victim : -1;
+}
+
+void runAudioStage(AudioStage &stage, SpscQueue<SoundEvent> &queue, double now, std::vector<VoiceStart> &starts)
+{
+    stage.frame++;
+
+    SoundEvent event;
+
+    while (queue.pop(event))
+    {
+        stage.events++;
+
+        if (event.sound < 0 || event.sound >= (int)stage.sounds.size())
+        {
+            stage.dropped++;
+            continue;
+        }
+
+        if (stage.soundFrames[event.sound] == stage.frame)
+        {
+            stage.coalesced++;
+            continue;
+        }
+
+        const StageSound &sound = stage.sounds[event.sound];
+
+        // Where the mixer will start it: a late one starts right away.
+        double startTime = now;
+
+        if (stage.startDelay > 0 && event.time + stage.startDelay > now)
+        {
+            startTime = event.time + stage.startDelay;
+        }
+
+        bool isStealing = false;
+        int voice = pickVoice(stage, sound.priority, startTime, isStealing);
+
+        if (voice < 0)
+        {
+            stage.dropped++;
+            continue;
+        }
+
+        stage.stolen += isStealing ? 1 : 0;
+        stage.played++;
+        stage.soundFrames[event.sound] = stage.frame;
+
+        StageVoice &playing = stage.voices[voice];
+        playing.sound = event.sound;
+        playing.priority = sound.priority;
+        playing.startTime = startTime;
+        playing.endTime = startTime + sound.seconds;
+
+        VoiceStart start = {voice, event.sound, event.time};
+        starts.push_back(start);
+    }
+}
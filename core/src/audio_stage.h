@@ -0,0 +1,75 @@
+#pragma once
+
+#include "spsc_queue.h"
+#include <vector>
+
+// Sound effects go through a queue instead of straight to the mixer: the game pushes a
+// SoundEvent wherever a sound should play, from any one thread, and the audio stage
+// drains the queue once per frame. A sound queued several times in one frame plays once,
+// and when every voice is busy the stage steals the one playing the least important
+// sound, oldest first, or drops the new sound if everything playing matters more.
+
+typedef struct
+{
+    int sound;
+
+    // When the sound was caused, in seconds of the port's clock, for a mixer that starts
+    // sounds at the frame they were caused at. Passed through to VoiceStart::time.
+    double time;
+} SoundEvent;
+
+typedef struct
+{
+    // Higher wins a voice.
+    int priority;
+
+    // How long the sound plays, so the stage knows when its voice is free again.
+    double seconds;
+} StageSound;
+
+typedef struct
+{
+    // -1 when the voice has never played.
+    int sound;
+    int priority;
+    double startTime;
+    double endTime;
+} StageVoice;
+
+// Start sound on voice, cutting off whatever the voice was playing.
+typedef struct
+{
+    int voice;
+    int sound;
+    double time;
+} VoiceStart;
+
+typedef struct
+{
+    std::vector<StageSound> sounds;
+    std::vector<StageVoice> voices;
+
+    // The frame each sound last started in, for coalescing.
+    std::vector<long long> soundFrames;
+    long long frame;
+
+    // The mixer's Mixer::startDelay. With one set, a voice plays from its event's time plus
+    // the delay, so the stage frees voices when the mixer really finishes them. runAudioStage()
+    // must then get now on the same clock as SoundEvent::time. 0 (the default) starts voices at now.
+    double startDelay;
+
+    long long events;
+    long long played;
+    long long coalesced;
+    long long stolen;
+    long long dropped;
+} AudioStage;
+
+void initAudioStage(AudioStage &stage, int voiceCount);
+
+// Returns the sound's id for SoundEvent::sound.
+int addStageSound(AudioStage &stage, int priority, double seconds);
+
+// Drains queue as one frame at now seconds and appends the voices to start to starts.
+// Events for sounds that were never added are counted as dropped.
+void runAudioStage(AudioStage &stage, SpscQueue<SoundEvent> &queue, double now, std::vector<VoiceStart> &starts);
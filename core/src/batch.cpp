@@ -0,0 +1,320 @@
+#include "batch.h"
+
+// The SIMD lanes hold floats, so fixed-point builds always take the scalar loop.
+#if !defined(BREAKOUT_FIXED_POINT) && defined(__AVX2__)
+#define BATCH_AVX2
+#elif !defined(BREAKOUT_FIXED_POINT) && defined(__SSE2__)
+#define BATCH_SSE2
+#endif
+
+#if defined(BATCH_AVX2)
+#include <immintrin.h>
+#elif defined(BATCH_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(BATCH_AVX2)
+
+typedef __m256 Lanes;
+typedef __m256i IntLanes;
+
+const int LANE_COUNT = 8;
+
+static inline Lanes loadLanes(const float *values) { return _mm256_loadu_ps(values); }
+static inline void storeLanes(float *values, Lanes lanes) { _mm256_storeu_ps(values, lanes); }
+static inline IntLanes loadIntLanes(const int *values) { return _mm256_loadu_si256((const __m256i *)values); }
+static inline void storeIntLanes(int *values, IntLanes lanes) { _mm256_storeu_si256((__m256i *)values, lanes); }
+static inline Lanes broadcast(float value) { return _mm256_set1_ps(value); }
+static inline IntLanes broadcastInt(int value) { return _mm256_set1_epi32(value); }
+static inline Lanes add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+static inline Lanes multiply(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+static inline Lanes lessThan(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline Lanes greaterThan(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline Lanes both(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+static inline Lanes either(Lanes a, Lanes b) { return _mm256_or_ps(a, b); }
+static inline Lanes bothNot(Lanes mask, Lanes a) { return _mm256_andnot_ps(mask, a); }
+static inline Lanes select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+static inline Lanes negateWhere(Lanes mask, Lanes a) { return _mm256_xor_ps(a, _mm256_and_ps(mask, _mm256_set1_ps(-0.0f))); }
+static inline bool any(Lanes mask) { return _mm256_movemask_ps(mask) != 0; }
+static inline Lanes toMask(IntLanes lanes) { return _mm256_castsi256_ps(lanes); }
+static inline IntLanes toIntMask(Lanes mask) { return _mm256_castps_si256(mask); }
+static inline IntLanes addInt(IntLanes a, IntLanes b) { return _mm256_add_epi32(a, b); }
+static inline IntLanes bothInt(IntLanes a, IntLanes b) { return _mm256_and_si256(a, b); }
+static inline IntLanes greaterThanInt(IntLanes a, IntLanes b) { return _mm256_cmpgt_epi32(a, b); }
+
+#elif defined(BATCH_SSE2)
+
+typedef __m128 Lanes;
+typedef __m128i IntLanes;
+
+const int LANE_COUNT = 4;
+
+static inline Lanes loadLanes(const float *values) { return _mm_loadu_ps(values); }
+static inline void storeLanes(float *values, Lanes lanes) { _mm_storeu_ps(values, lanes); }
+static inline IntLanes loadIntLanes(const int *values) { return _mm_loadu_si128((const __m128i *)values); }
+static inline void storeIntLanes(int *values, IntLanes lanes) { _mm_storeu_si128((__m128i *)values, lanes); }
+static inline Lanes broadcast(float value) { return _mm_set1_ps(value); }
+static inline IntLanes broadcastInt(int value) { return _mm_set1_epi32(value); }
+static inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+static inline Lanes multiply(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+static inline Lanes lessThan(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+static inline Lanes greaterThan(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+static inline Lanes both(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+static inline Lanes either(Lanes a, Lanes b) { return _mm_or_ps(a, b); }
+static inline Lanes bothNot(Lanes mask, Lanes a) { return _mm_andnot_ps(mask, a); }
+static inline Lanes select(Lanes mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline Lanes negateWhere(Lanes mask, Lanes a) { return _mm_xor_ps(a, _mm_and_ps(mask, _mm_set1_ps(-0.0f))); }
+static inline bool any(Lanes mask) { return _mm_movemask_ps(mask) != 0; }
+static inline Lanes toMask(IntLanes lanes) { return _mm_castsi128_ps(lanes); }
+static inline IntLanes toIntMask(Lanes mask) { return _mm_castps_si128(mask); }
+static inline IntLanes addInt(IntLanes a, IntLanes b) { return _mm_add_epi32(a, b); }
+static inline IntLanes bothInt(IntLanes a, IntLanes b) { return _mm_and_si128(a, b); }
+static inline IntLanes greaterThanInt(IntLanes a, IntLanes b) { return _mm_cmpgt_epi32(a, b); }
+
+#else
+
+const int LANE_COUNT = 1;
+
+#endif
+
+int gameBatchLaneCount()
+{
+    return LANE_COUNT;
+}
+
+void initGameBatch(GameBatch &batch, const GameConfig &config, int gameCount, unsigned int firstSeed)
+{
+    batch.config = config;
+    batch.config.useDiscreteCollision = true;
+    batch.gameCount = gameCount;
+    batch.paddedGameCount = (gameCount + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+
+    int count = batch.paddedGameCount;
+
+    batch.ballX.resize(count);
+    batch.ballY.resize(count);
+    batch.ballVelocityX.resize(count);
+    batch.ballVelocityY.resize(count);
+    batch.playerX.resize(count);
+    batch.playerScore.assign(count, 0);
+    batch.playerLives.assign(count, config.playerLives);
+
+    Game game;
+    initGame(game, config);
+
+    for (int i = 0; i < count; i++)
+    {
+        serveBall(game, firstSeed + i);
+
+        batch.ballX[i] = game.ball.x;
+        batch.ballY[i] = game.ball.y;
+        batch.ballVelocityX[i] = game.ballVelocityX;
+        batch.ballVelocityY[i] = game.ballVelocityY;
+        batch.playerX[i] = game.player.x;
+    }
+
+    batch.brickBounds.clear();
+    batch.brickPoints.clear();
+
+    for (int row = 0; row < config.brickRows; row++)
+    {
+        for (int column = 0; column < config.brickColumns; column++)
+        {
+            batch.brickBounds.push_back(getBrickBounds(config, row, column));
+            batch.brickPoints.push_back(game.bricks.rowPoints[row]);
+        }
+    }
+
+    batch.brickAlive.assign(batch.brickBounds.size() * count, -1);
+}
+
+#if defined(BATCH_AVX2) || defined(BATCH_SSE2)
+
+void stepGameBatch(GameBatch &batch, Number deltaTime)
+{
+    const GameConfig &config = batch.config;
+
+    const int count = batch.paddedGameCount;
+
+    const Lanes zero = broadcast(0);
+    const Lanes playerY = broadcast(config.player.y);
+    const Lanes playerW = broadcast(config.player.w);
+    const Lanes playerH = broadcast(config.player.h);
+    const Lanes ballW = broadcast(config.ball.w);
+    const Lanes ballH = broadcast(config.ball.h);
+    const Lanes autoPlayLimit = broadcast(config.screenWidth - config.player.w);
+    const Lanes wallLimit = broadcast(config.screenWidth - config.ball.w);
+    const Lanes floorLimit = broadcast(config.screenHeight + config.ball.h);
+    const Lanes serveX = broadcast(config.ball.x);
+    const Lanes serveY = broadcast(config.ball.y);
+    const Lanes step = broadcast(deltaTime);
+    const IntLanes noLives = broadcastInt(0);
+    const IntLanes minusOne = broadcastInt(-1);
+    const Lanes bandBottom = broadcast(config.brickOffsetY + config.brickSpacingY * config.brickRows);
+
+    for (int game = 0; game < count; game += LANE_COUNT)
+    {
+        Lanes ballX = loadLanes(&batch.ballX[game]);
+        Lanes ballY = loadLanes(&batch.ballY[game]);
+        Lanes velocityX = loadLanes(&batch.ballVelocityX[game]);
+        Lanes velocityY = loadLanes(&batch.ballVelocityY[game]);
+        Lanes playerX = loadLanes(&batch.playerX[game]);
+        IntLanes lives = loadIntLanes(&batch.playerLives[game]);
+        IntLanes score = loadIntLanes(&batch.playerScore[game]);
+
+        playerX = select(lessThan(ballX, autoPlayLimit), ballX, playerX);
+
+        Lanes fell = greaterThan(ballY, floorLimit);
+
+        if (any(fell))
+        {
+            ballX = select(fell, serveX, ballX);
+            ballY = select(fell, serveY, ballY);
+            velocityX = negateWhere(fell, velocityX);
+
+            IntLanes loseLife = bothInt(toIntMask(fell), greaterThanInt(lives, noLives));
+            lives = addInt(lives, bothInt(loseLife, minusOne));
+        }
+
+        velocityX = negateWhere(either(lessThan(ballX, zero), greaterThan(ballX, wallLimit)), velocityX);
+
+        Lanes ballRight = add(ballX, ballW);
+        Lanes ballBottom = add(ballY, ballH);
+
+        Lanes playerHit = both(both(lessThan(playerX, ballRight), greaterThan(add(playerX, playerW), ballX)),
+                               both(lessThan(playerY, ballBottom), greaterThan(add(playerY, playerH), ballY)));
+
+        velocityY = negateWhere(either(playerHit, lessThan(ballY, zero)), velocityY);
+
+        // Each lane only tests the cells its ball can touch, like updateGame(), and the whole
+        // group skips the bricks while every ball is below them. The balls of a group are
+        // rarely near the same bricks, so the test itself runs per lane.
+        int laneHits[LANE_COUNT] = {};
+        int lanePoints[LANE_COUNT] = {};
+
+        if (any(lessThan(ballY, bandBottom)))
+        {
+            float laneX[LANE_COUNT];
+            float laneY[LANE_COUNT];
+
+            storeLanes(laneX, ballX);
+            storeLanes(laneY, ballY);
+
+            for (int lane = 0; lane < LANE_COUNT; lane++)
+            {
+                Bounds ball = {laneX[lane], laneY[lane], config.ball.w, config.ball.h};
+                int firstRow, lastRow, firstColumn, lastColumn;
+
+                if (!findBrickCells(config, ball, firstRow, lastRow, firstColumn, lastColumn))
+                {
+                    continue;
+                }
+
+                // Only the first standing brick a game touches counts, like the break in updateGame().
+                for (int row = firstRow; row <= lastRow && !laneHits[lane]; row++)
+                {
+                    for (int column = firstColumn; column <= lastColumn && !laneHits[lane]; column++)
+                    {
+                        int brick = row * config.brickColumns + column;
+                        int &alive = batch.brickAlive[brick * count + game + lane];
+
+                        if (alive && hasCollision(batch.brickBounds[brick], ball))
+                        {
+                            alive = 0;
+                            laneHits[lane] = -1;
+                            lanePoints[lane] = batch.brickPoints[brick];
+                        }
+                    }
+                }
+            }
+        }
+
+        score = addInt(score, loadIntLanes(lanePoints));
+        velocityY = negateWhere(toMask(loadIntLanes(laneHits)), velocityY);
+
+        ballX = add(ballX, multiply(velocityX, step));
+        ballY = add(ballY, multiply(velocityY, step));
+
+        storeLanes(&batch.ballX[game], ballX);
+        storeLanes(&batch.ballY[game], ballY);
+        storeLanes(&batch.ballVelocityX[game], velocityX);
+        storeLanes(&batch.ballVelocityY[game], velocityY);
+        storeLanes(&batch.playerX[game], playerX);
+        storeIntLanes(&batch.playerLives[game], lives);
+        storeIntLanes(&batch.playerScore[game], score);
+    }
+}
+
+#else
+
+void stepGameBatch(GameBatch &batch, Number deltaTime)
+{
+    const GameConfig &config = batch.config;
+
+    const int count = batch.paddedGameCount;
+
+    for (int game = 0; game < count; game++)
+    {
+        Bounds player = {batch.playerX[game], config.player.y, config.player.w, config.player.h};
+        Bounds ball = {batch.ballX[game], batch.ballY[game], config.ball.w, config.ball.h};
+
+        if (ball.x < config.screenWidth - player.w)
+        {
+            player.x = ball.x;
+        }
+
+        if (ball.y > config.screenHeight + ball.h)
+        {
+            ball.x = config.ball.x;
+            ball.y = config.ball.y;
+
+            batch.ballVelocityX[game] *= -1;
+
+            if (batch.playerLives[game] > 0)
+            {
+                batch.playerLives[game]--;
+            }
+        }
+
+        if (ball.x < 0 || ball.x > config.screenWidth - ball.w)
+        {
+            batch.ballVelocityX[game] *= -1;
+        }
+
+        if (hasCollision(player, ball) || ball.y < 0)
+        {
+            batch.ballVelocityY[game] *= -1;
+        }
+
+        int firstRow, lastRow, firstColumn, lastColumn;
+
+        if (findBrickCells(config, ball, firstRow, lastRow, firstColumn, lastColumn))
+        {
+            bool isBrickHit = false;
+
+            for (int row = firstRow; row <= lastRow && !isBrickHit; row++)
+            {
+                for (int column = firstColumn; column <= lastColumn && !isBrickHit; column++)
+                {
+                    int brick = row * config.brickColumns + column;
+                    int &alive = batch.brickAlive[brick * count + game];
+
+                    if (alive && hasCollision(batch.brickBounds[brick], ball))
+                    {
+                        batch.ballVelocityY[game] *= -1;
+                        alive = 0;
+                        batch.playerScore[game] += batch.brickPoints[brick];
+
+                        isBrickHit = true;
+                    }
+                }
+            }
+        }
+
+        batch.ballX[game] = ball.x + batch.ballVelocityX[game] * deltaTime;
+        batch.ballY[game] = ball.y + batch.ballVelocityY[game] * deltaTime;
+        batch.playerX[game] = player.x;
+    }
+}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "game.h"
+#include <vector>
+
+// Many independent games stepped together, stored as structure-of-arrays so the
+// ball, paddle and wall tests run over several games per instruction; bricks are looked
+// up per game through the brick grid. Every game plays on autoplay with no input, which
+// is what the Monte Carlo sweeps need.
+// gameCount is rounded up to a multiple of the SIMD width; the extra games are
+// simulated too but never reported.
+typedef struct
+{
+    GameConfig config;
+
+    int gameCount;
+    int paddedGameCount;
+
+    std::vector<Number> ballX;
+    std::vector<Number> ballY;
+    std::vector<Number> ballVelocityX;
+    std::vector<Number> ballVelocityY;
+    std::vector<Number> playerX;
+
+    std::vector<int> playerScore;
+    std::vector<int> playerLives;
+
+    std::vector<Bounds> brickBounds;
+    std::vector<int> brickPoints;
+
+    // brickAlive[brick * paddedGameCount + game] is -1 while the brick stands and 0 once destroyed.
+    std::vector<int> brickAlive;
+} GameBatch;
+
+// Game i is served with serveBall(firstSeed + i). The batch always plays the discrete
+// collision rules (GameConfig::useDiscreteCollision), which map onto SIMD lanes.
+void initGameBatch(GameBatch &batch, const GameConfig &config, int gameCount, unsigned int firstSeed);
+
+// Same rules as updateGame() with useDiscreteCollision, on autoplay with no input.
+void stepGameBatch(GameBatch &batch, Number deltaTime);
+
+// Number of games one SIMD instruction handles in this build, 1 without SSE2/AVX2
+// and in fixed-point builds.
+int gameBatchLaneCount();
@@ -0,0 +1,183 @@
+#include "cooked.h"
+#include <cstdio>
+
+static bool isHostBigEndian()
+{
+    const uint16_t probe = 1;
+
+    return *(const uint8_t *)&probe == 0;
+}
+
+static uint32_t swap32(uint32_t value)
+{
+    return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+}
+
+// Buffers a file's words in the byte order it is cooked for.
+typedef struct
+{
+    bool isSwapped;
+    std::vector<uint32_t> words;
+} CookedHeader;
+
+static void addWord(CookedHeader &header, uint32_t value)
+{
+    header.words.push_back(header.isSwapped ? swap32(value) : value);
+}
+
+static bool writeCookedFile(const char *path, const CookedHeader &header, const void *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == nullptr)
+    {
+        printf("Unable to create %s!\n", path);
+        return false;
+    }
+
+    bool isWritten = fwrite(header.words.data(), sizeof(uint32_t), header.words.size(), file) == header.words.size() &&
+                     (size == 0 || fwrite(data, 1, size, file) == size);
+
+    if (fclose(file) != 0 || !isWritten)
+    {
+        printf("Unable to write %s!\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+// Reads count header words and checks the magic and version.
+static FILE *openCookedFile(const char *path, uint32_t magic, uint32_t *words, int count)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (fread(words, sizeof(uint32_t), count, file) != (size_t)count || words[0] != magic || words[1] != COOKED_VERSION)
+    {
+        printf("%s wasn't cooked for this build!\n", path);
+        fclose(file);
+        return nullptr;
+    }
+
+    return file;
+}
+
+bool writeCookedPcm(const char *path, const PcmSound &sound, bool isBigEndian)
+{
+    CookedHeader header = {isBigEndian != isHostBigEndian(), {}};
+
+    addWord(header, COOKED_PCM_MAGIC);
+    addWord(header, COOKED_VERSION);
+    addWord(header, (uint32_t)sound.rate);
+    addWord(header, (uint32_t)sound.channels);
+    addWord(header, (uint32_t)pcmFrameCount(sound));
+
+    std::vector<int16_t> samples = sound.samples;
+
+    if (header.isSwapped)
+    {
+        for (int16_t &sample : samples)
+        {
+            sample = (int16_t)(((uint16_t)sample >> 8) | ((uint16_t)sample << 8));
+        }
+    }
+
+    return writeCookedFile(path, header, samples.data(), samples.size() * sizeof(int16_t));
+}
+
+bool loadCookedPcm(const char *path, PcmSound &sound)
+{
+    uint32_t words[5];
+    FILE *file = openCookedFile(path, COOKED_PCM_MAGIC, words, 5);
+
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    sound.rate = (int)words[2];
+    sound.channels = (int)words[3];
+    sound.samples.resize((size_t)words[4] * sound.channels);
+
+    bool isRead = fread(sound.samples.data(), sizeof(int16_t), sound.samples.size(), file) == sound.samples.size();
+    fclose(file);
+
+    if (!isRead)
+    {
+        printf("%s is cut short!\n", path);
+        sound.samples.clear();
+    }
+
+    return isRead;
+}
+
+// Every field of GlyphAtlas is an int, so it is written as words in field order.
+const int FONT_HEADER_WORDS = 2 + 3 + GLYPH_COUNT * 5;
+
+bool writeCookedFont(const char *path, const CookedFont &font, bool isBigEndian)
+{
+    CookedHeader header = {isBigEndian != isHostBigEndian(), {}};
+    const GlyphAtlas &atlas = font.atlas;
+
+    addWord(header, COOKED_FONT_MAGIC);
+    addWord(header, COOKED_VERSION);
+    addWord(header, (uint32_t)atlas.width);
+    addWord(header, (uint32_t)atlas.height);
+    addWord(header, (uint32_t)atlas.lineHeight);
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        addWord(header, (uint32_t)atlas.glyphs[i].x);
+        addWord(header, (uint32_t)atlas.glyphs[i].y);
+        addWord(header, (uint32_t)atlas.glyphs[i].w);
+        addWord(header, (uint32_t)atlas.glyphs[i].h);
+        addWord(header, (uint32_t)atlas.advances[i]);
+    }
+
+    return writeCookedFile(path, header, font.alpha.data(), font.alpha.size());
+}
+
+bool loadCookedFont(const char *path, CookedFont &font)
+{
+    uint32_t words[FONT_HEADER_WORDS];
+    FILE *file = openCookedFile(path, COOKED_FONT_MAGIC, words, FONT_HEADER_WORDS);
+
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    GlyphAtlas &atlas = font.atlas;
+    atlas.width = (int)words[2];
+    atlas.height = (int)words[3];
+    atlas.lineHeight = (int)words[4];
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        const uint32_t *glyph = &words[5 + i * 5];
+
+        atlas.glyphs[i].x = (int)glyph[0];
+        atlas.glyphs[i].y = (int)glyph[1];
+        atlas.glyphs[i].w = (int)glyph[2];
+        atlas.glyphs[i].h = (int)glyph[3];
+        atlas.advances[i] = (int)glyph[4];
+    }
+
+    font.alpha.resize((size_t)atlas.width * atlas.height);
+
+    bool isRead = fread(font.alpha.data(), 1, font.alpha.size(), file) == font.alpha.size();
+    fclose(file);
+
+    if (!isRead)
+    {
+        printf("%s is cut short!\n", path);
+        font.alpha.clear();
+    }
+
+    return isRead;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pcm.h"
+#include "text.h"
+#include <stdint.h>
+#include <vector>
+
+// Assets breakout_cook prepared offline for one port, so startup reads them instead of
+// decoding WAVs and rasterizing fonts. Each file is a small header followed by the data
+// exactly as the port uses it, in the port's byte order: loading is one read into memory
+// the game keeps. A file cooked for the other byte order, or by another version, fails
+// to load and the port falls back to its source assets.
+
+// "BPCM" and "BFNT" when read in the byte order the file was cooked for.
+const uint32_t COOKED_PCM_MAGIC = 0x4d435042;
+const uint32_t COOKED_FONT_MAGIC = 0x544e4642;
+const uint32_t COOKED_VERSION = 1;
+
+// A glyph atlas with one coverage byte per pixel of the texture, row by row.
+typedef struct
+{
+    GlyphAtlas atlas;
+    std::vector<uint8_t> alpha;
+} CookedFont;
+
+bool writeCookedPcm(const char *path, const PcmSound &sound, bool isBigEndian);
+bool loadCookedPcm(const char *path, PcmSound &sound);
+
+bool writeCookedFont(const char *path, const CookedFont &font, bool isBigEndian);
+bool loadCookedFont(const char *path, CookedFont &font);
@@ -0,0 +1,595 @@
+#include "game.h"
+
+static int countSetBits(uint32_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(bits);
+#else
+    int count = 0;
+
+    while (bits != 0)
+    {
+        bits &= bits - 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+void initBrickField(BrickField &field, const GameConfig &config)
+{
+    field.rows = config.brickRows;
+    field.columns = config.brickColumns;
+    field.wordsPerRow = (config.brickColumns + BRICK_MASK_BITS - 1) / BRICK_MASK_BITS;
+
+    field.aliveMasks.assign(field.rows * field.wordsPerRow, 0);
+    field.rowPoints.resize(field.rows);
+
+    for (int row = 0; row < field.rows; row++)
+    {
+        for (int column = 0; column < field.columns; column++)
+        {
+            field.aliveMasks[row * field.wordsPerRow + column / BRICK_MASK_BITS] |= 1u << (column % BRICK_MASK_BITS);
+        }
+
+        field.rowPoints[row] = config.firstRowPoints - row;
+    }
+}
+
+Bounds getBrickBounds(const GameConfig &config, int row, int column)
+{
+    Bounds bounds = {
+        config.brickOffsetX + config.brickSpacingX * column,
+        config.brickOffsetY + config.brickSpacingY * row,
+        config.brickWidth,
+        config.brickHeight,
+    };
+
+    return bounds;
+}
+
+bool isBrickAlive(const BrickField &field, int row, int column)
+{
+    return (field.aliveMasks[row * field.wordsPerRow + column / BRICK_MASK_BITS] >> (column % BRICK_MASK_BITS)) & 1;
+}
+
+void destroyBrick(BrickField &field, int row, int column)
+{
+    field.aliveMasks[row * field.wordsPerRow + column / BRICK_MASK_BITS] &= ~(1u << (column % BRICK_MASK_BITS));
+}
+
+int countBricks(const BrickField &field)
+{
+    int count = 0;
+
+    for (uint32_t mask : field.aliveMasks)
+    {
+        count += countSetBits(mask);
+    }
+
+    return count;
+}
+
+bool findClearedBricks(const GameConfig &config, const BrickField &drawn, const BrickField &field, std::vector<Bounds> &cleared)
+{
+    if (drawn.aliveMasks.size() != field.aliveMasks.size())
+    {
+        return false;
+    }
+
+    for (int row = 0; row < field.rows; row++)
+    {
+        for (int word = 0; word < field.wordsPerRow; word++)
+        {
+            int index = row * field.wordsPerRow + word;
+
+            if (field.aliveMasks[index] & ~drawn.aliveMasks[index])
+            {
+                return false;
+            }
+
+            uint32_t bits = drawn.aliveMasks[index] & ~field.aliveMasks[index];
+
+            while (bits != 0)
+            {
+                cleared.push_back(getBrickBounds(config, row, word * BRICK_MASK_BITS + countTrailingZeros(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool findCellRange(Number start, Number size, Number offset, Number spacing, int count, int &first, int &last)
+{
+    Number end = start + size;
+    Number fieldEnd = offset + spacing * count;
+
+    if (end < offset || start >= fieldEnd)
+    {
+        return false;
+    }
+
+    first = start <= offset ? 0 : (int)((start - offset) / spacing);
+    last = end >= fieldEnd ? count - 1 : (int)((end - offset) / spacing);
+
+    return true;
+}
+
+bool findBrickCells(const GameConfig &config, const Bounds &area, int &firstRow, int &lastRow, int &firstColumn, int &lastColumn)
+{
+    return findCellRange(area.y, area.h, config.brickOffsetY, config.brickSpacingY, config.brickRows, firstRow, lastRow) &&
+           findCellRange(area.x, area.w, config.brickOffsetX, config.brickSpacingX, config.brickColumns, firstColumn, lastColumn);
+}
+
+void initGame(Game &game, const GameConfig &config)
+{
+    game.config = config;
+
+    game.player = config.player;
+    game.ball = config.ball;
+
+    game.ballVelocityX = config.ballVelocityX;
+    game.ballVelocityY = config.ballVelocityY;
+
+    game.playerScore = 0;
+    game.playerLives = config.playerLives;
+    game.destroyedBricks = 0;
+
+    game.isAutoPlayMode = true;
+
+    initBrickField(game.bricks, config);
+
+    for (Number &time : game.eventTimes)
+    {
+        time = 0;
+    }
+}
+
+static unsigned int nextRandom(unsigned int &state)
+{
+    // xorshift32, state must never be 0.
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+void serveBall(Game &game, unsigned int seed)
+{
+    const GameConfig &config = game.config;
+
+    unsigned int state = seed * 2654435761u + 1;
+
+    if (state == 0)
+    {
+        state = 1;
+    }
+
+    int range = config.screenWidth - (int)game.ball.w;
+
+    game.ball.x = (int)(nextRandom(state) % range);
+    game.ball.y = config.ball.y;
+
+    game.ballVelocityX = (nextRandom(state) & 1) ? config.ballVelocityX : -config.ballVelocityX;
+    game.ballVelocityY = config.ballVelocityY;
+}
+
+bool hasCollision(const Bounds &bounds, const Bounds &ball)
+{
+    return bounds.x < ball.x + ball.w && bounds.x + bounds.w > ball.x &&
+           bounds.y < ball.y + ball.h && bounds.y + bounds.h > ball.y;
+}
+
+// How much of the step [0, 1] the moving span overlaps the target span on one axis.
+static bool sweepAxis(Number position, Number size, Number delta, Number targetPosition, Number targetSize, Number &enter, Number &leave)
+{
+    if (delta == 0)
+    {
+        enter = 0;
+        leave = 1;
+
+        return position < targetPosition + targetSize && position + size > targetPosition;
+    }
+
+    // Mirror movement to the left/up so only the positive direction needs handling.
+    if (delta < 0)
+    {
+        return sweepAxis(-(position + size), size, -delta, -(targetPosition + targetSize), targetSize, enter, leave);
+    }
+
+    Number enterDistance = targetPosition - (position + size);
+    Number leaveDistance = targetPosition + targetSize - position;
+
+    if (leaveDistance <= 0 || enterDistance >= delta)
+    {
+        return false;
+    }
+
+    enter = enterDistance <= 0 ? Number(0) : enterDistance / delta;
+    leave = leaveDistance >= delta ? Number(1) : leaveDistance / delta;
+
+    return true;
+}
+
+bool sweepBounds(const Bounds &moving, Number deltaX, Number deltaY, const Bounds &target, Number &time, bool &isSideHit)
+{
+    Number enterX, leaveX, enterY, leaveY;
+
+    if (!sweepAxis(moving.x, moving.w, deltaX, target.x, target.w, enterX, leaveX) ||
+        !sweepAxis(moving.y, moving.h, deltaY, target.y, target.h, enterY, leaveY))
+    {
+        return false;
+    }
+
+    Number enter = enterX > enterY ? enterX : enterY;
+    Number leave = leaveX < leaveY ? leaveX : leaveY;
+
+    if (enter >= leave)
+    {
+        return false;
+    }
+
+    time = enter;
+    isSideHit = enterX > enterY;
+
+    return true;
+}
+
+static int moveBallDiscrete(Game &game, Number deltaTime)
+{
+    const GameConfig &config = game.config;
+
+    Bounds &player = game.player;
+    Bounds &ball = game.ball;
+
+    int events = GAME_EVENT_NONE;
+
+    if (ball.x < 0 || ball.x > config.screenWidth - ball.w)
+    {
+        game.ballVelocityX *= -1;
+        events |= GAME_EVENT_WALL_HIT;
+    }
+
+    if (hasCollision(player, ball))
+    {
+        game.ballVelocityY *= -1;
+        events |= GAME_EVENT_PLAYER_HIT;
+    }
+
+    else if (ball.y < 0)
+    {
+        game.ballVelocityY *= -1;
+        events |= GAME_EVENT_CEILING_HIT;
+    }
+
+    int firstRow, lastRow, firstColumn, lastColumn;
+
+    // Only the first brick overlapping the ball is destroyed, see GameConfig::useDiscreteCollision.
+    if (findBrickCells(config, ball, firstRow, lastRow, firstColumn, lastColumn))
+    {
+        bool isBrickHit = false;
+
+        for (int row = firstRow; row <= lastRow && !isBrickHit; row++)
+        {
+            for (int column = findNextBrick(game.bricks, row, firstColumn); column >= 0 && column <= lastColumn && !isBrickHit;
+                 column = findNextBrick(game.bricks, row, column + 1))
+            {
+                if (hasCollision(getBrickBounds(config, row, column), ball))
+                {
+                    game.ballVelocityY *= -1;
+                    destroyBrick(game.bricks, row, column);
+                    game.playerScore += game.bricks.rowPoints[row];
+                    game.destroyedBricks++;
+                    events |= GAME_EVENT_BRICK_HIT;
+
+                    isBrickHit = true;
+                }
+            }
+        }
+    }
+
+    ball.x += game.ballVelocityX * deltaTime;
+    ball.y += game.ballVelocityY * deltaTime;
+
+    return events;
+}
+
+// Enough for the ball bouncing between a brick and a wall in one step; whatever is
+// left of the step after that many contacts is dropped.
+const int MAX_CONTACTS_PER_STEP = 8;
+
+static Number absolute(Number value)
+{
+    return value < 0 ? -value : value;
+}
+
+// Keeps the time of the first time event happens in the step.
+static void addEvent(Game &game, int &events, int event, Number time)
+{
+    if ((events & event) == 0)
+    {
+        game.eventTimes[countTrailingZeros(event)] = time;
+    }
+
+    events |= event;
+}
+
+static int moveBallSwept(Game &game, Number deltaTime)
+{
+    const GameConfig &config = game.config;
+
+    Bounds &player = game.player;
+    Bounds &ball = game.ball;
+
+    int events = GAME_EVENT_NONE;
+
+    // The paddle can be moved onto the ball (autoplay, touch); push the ball up and out
+    // instead of letting it fall through or bounce inside the paddle every step.
+    if (hasCollision(player, ball) && game.ballVelocityY > 0)
+    {
+        game.ballVelocityY *= -1;
+        addEvent(game, events, GAME_EVENT_PLAYER_HIT, 0);
+    }
+
+    // Distance still to travel on each axis this step; bounces only change direction.
+    Number travelX = absolute(game.ballVelocityX * deltaTime);
+    Number travelY = absolute(game.ballVelocityY * deltaTime);
+    Number travel = travelX + travelY;
+
+    for (int contact = 0; contact < MAX_CONTACTS_PER_STEP && (travelX > 0 || travelY > 0); contact++)
+    {
+        Number deltaX = game.ballVelocityX < 0 ? -travelX : travelX;
+        Number deltaY = game.ballVelocityY < 0 ? -travelY : travelY;
+
+        enum
+        {
+            CONTACT_NONE,
+            CONTACT_WALL,
+            CONTACT_CEILING,
+            CONTACT_PLAYER,
+            CONTACT_BRICK,
+        } contactType = CONTACT_NONE;
+
+        Number firstTime = 1;
+        bool isSideHit = false;
+        int hitRow = 0;
+        int hitColumn = 0;
+        Bounds target = {0, 0, 0, 0};
+
+        Number rightWall = config.screenWidth - ball.w;
+
+        if (deltaX < 0 && ball.x + deltaX < 0)
+        {
+            firstTime = ball.x <= 0 ? Number(0) : -ball.x / deltaX;
+            contactType = CONTACT_WALL;
+            isSideHit = true;
+        }
+        else if (deltaX > 0 && ball.x + deltaX > rightWall)
+        {
+            firstTime = ball.x >= rightWall ? Number(0) : (rightWall - ball.x) / deltaX;
+            contactType = CONTACT_WALL;
+            isSideHit = true;
+        }
+
+        if (deltaY < 0 && ball.y + deltaY < 0)
+        {
+            Number time = ball.y <= 0 ? Number(0) : -ball.y / deltaY;
+
+            if (time < firstTime)
+            {
+                firstTime = time;
+                contactType = CONTACT_CEILING;
+                isSideHit = false;
+            }
+        }
+
+        Number time;
+        bool isSide;
+
+        // The paddle only bounces a ball coming down onto it.
+        if (deltaY > 0 && sweepBounds(ball, deltaX, deltaY, player, time, isSide) && time < firstTime)
+        {
+            firstTime = time;
+            contactType = CONTACT_PLAYER;
+            isSideHit = isSide;
+            target = player;
+        }
+
+        // Only the cells under the box the ball sweeps this step can hold a brick it hits.
+        Bounds sweptArea = {
+            deltaX < 0 ? ball.x + deltaX : ball.x,
+            deltaY < 0 ? ball.y + deltaY : ball.y,
+            ball.w + absolute(deltaX),
+            ball.h + absolute(deltaY),
+        };
+
+        int firstRow, lastRow, firstColumn, lastColumn;
+
+        if (findBrickCells(config, sweptArea, firstRow, lastRow, firstColumn, lastColumn))
+        {
+            for (int row = firstRow; row <= lastRow; row++)
+            {
+                for (int column = findNextBrick(game.bricks, row, firstColumn); column >= 0 && column <= lastColumn;
+                     column = findNextBrick(game.bricks, row, column + 1))
+                {
+                    Bounds brick = getBrickBounds(config, row, column);
+
+                    if (sweepBounds(ball, deltaX, deltaY, brick, time, isSide) && time < firstTime)
+                    {
+                        firstTime = time;
+                        contactType = CONTACT_BRICK;
+                        isSideHit = isSide;
+                        hitRow = row;
+                        hitColumn = column;
+                        target = brick;
+                    }
+                }
+            }
+        }
+
+        if (contactType == CONTACT_NONE)
+        {
+            ball.x += deltaX;
+            ball.y += deltaY;
+
+            break;
+        }
+
+        // Move the ball until it is exactly against what it hit. The other axis moves by
+        // the slope times that distance rather than by the time of impact, so a 45 degree
+        // ball stays on the same positions in float and in fixed point.
+        if (firstTime > 0 && isSideHit)
+        {
+            Number surfaceX;
+
+            if (contactType == CONTACT_WALL)
+            {
+                surfaceX = deltaX < 0 ? Number(0) : rightWall;
+            }
+            else
+            {
+                surfaceX = deltaX > 0 ? target.x - ball.w : target.x + target.w;
+            }
+
+            Number movedX = surfaceX - ball.x;
+            Number movedY = movedX * (deltaY / deltaX);
+
+            ball.x = surfaceX;
+            ball.y += movedY;
+
+            travelX -= absolute(movedX);
+            travelY -= absolute(movedY);
+        }
+        else if (firstTime > 0)
+        {
+            Number surfaceY;
+
+            if (contactType == CONTACT_CEILING)
+            {
+                surfaceY = 0;
+            }
+            else
+            {
+                surfaceY = deltaY > 0 ? target.y - ball.h : target.y + target.h;
+            }
+
+            Number movedY = surfaceY - ball.y;
+            Number movedX = movedY * (deltaX / deltaY);
+
+            ball.x += movedX;
+            ball.y = surfaceY;
+
+            travelX -= absolute(movedX);
+            travelY -= absolute(movedY);
+        }
+
+        if (isSideHit)
+        {
+            game.ballVelocityX *= -1;
+        }
+        else
+        {
+            game.ballVelocityY *= -1;
+        }
+
+        // The ball moves at the same speed all step, so the share of the distance it has
+        // covered is the share of the step that has passed.
+        Number contactTime = travel > 0 ? 1 - (travelX + travelY) / travel : Number(0);
+
+        if (contactType == CONTACT_WALL)
+        {
+            addEvent(game, events, GAME_EVENT_WALL_HIT, contactTime);
+        }
+        else if (contactType == CONTACT_CEILING)
+        {
+            addEvent(game, events, GAME_EVENT_CEILING_HIT, contactTime);
+        }
+        else if (contactType == CONTACT_PLAYER)
+        {
+            addEvent(game, events, GAME_EVENT_PLAYER_HIT, contactTime);
+        }
+        else
+        {
+            destroyBrick(game.bricks, hitRow, hitColumn);
+            game.playerScore += game.bricks.rowPoints[hitRow];
+            game.destroyedBricks++;
+            addEvent(game, events, GAME_EVENT_BRICK_HIT, contactTime);
+        }
+    }
+
+    return events;
+}
+
+int updateGame(Game &game, const GameInput &input, Number deltaTime)
+{
+    const GameConfig &config = game.config;
+
+    Bounds &player = game.player;
+    Bounds &ball = game.ball;
+
+    int events = GAME_EVENT_NONE;
+
+    for (Number &time : game.eventTimes)
+    {
+        time = 0;
+    }
+
+    if (game.isAutoPlayMode && ball.x < config.screenWidth - player.w)
+    {
+        player.x = ball.x;
+    }
+
+    if (input.moveLeft && player.x > 0)
+    {
+        player.x -= config.playerSpeed * deltaTime;
+    }
+
+    else if (input.moveRight && player.x < config.screenWidth - player.w)
+    {
+        player.x += config.playerSpeed * deltaTime;
+    }
+
+    if (ball.y > config.screenHeight + ball.h)
+    {
+        ball.x = config.ball.x;
+        ball.y = config.ball.y;
+
+        game.ballVelocityX *= -1;
+
+        if (game.playerLives > 0)
+        {
+            game.playerLives--;
+            events |= GAME_EVENT_LIFE_LOST;
+        }
+    }
+
+    if (config.useDiscreteCollision)
+    {
+        events |= moveBallDiscrete(game, deltaTime);
+    }
+    else
+    {
+        events |= moveBallSwept(game, deltaTime);
+    }
+
+    return events;
+}
+
+Number firstEventTime(const Game &game, int events)
+{
+    Number first = 1;
+
+    for (int type = 0; type < GAME_EVENT_TYPES; type++)
+    {
+        if ((events & (1 << type)) != 0 && game.eventTimes[type] < first)
+        {
+            first = game.eventTimes[type];
+        }
+    }
+
+    return (events & ((1 << GAME_EVENT_TYPES) - 1)) != 0 ? first : Number(0);
+}
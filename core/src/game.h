@@ -0,0 +1,194 @@
+#pragma once
+
+#include "number.h"
+#include <stdint.h>
+#include <vector>
+
+typedef struct
+{
+    Number x;
+    Number y;
+    Number w;
+    Number h;
+} Bounds;
+
+// Everything that differs between the ports: screen size, paddle and ball sizes,
+// speeds and the brick layout. Speeds are in pixels per second for the ports that
+// use deltaTime, and in pixels per frame for the ones that pass a deltaTime of 1.
+typedef struct
+{
+    int screenWidth;
+    int screenHeight;
+
+    Bounds player;
+    Bounds ball;
+
+    Number playerSpeed;
+    Number ballVelocityX;
+    Number ballVelocityY;
+
+    int playerLives;
+
+    int brickRows;
+    int brickColumns;
+    Number brickWidth;
+    Number brickHeight;
+    Number brickOffsetX;
+    Number brickOffsetY;
+    Number brickSpacingX;
+    Number brickSpacingY;
+    int firstRowPoints;
+
+    // false (the default) moves the ball with swept collision: it stops at the first
+    // wall, paddle or brick it would touch during the step, bounces and carries on with
+    // the rest of the step, so nothing is skipped however large deltaTime gets.
+    // true keeps the original rules: move, then test for overlaps. It destroys one brick
+    // per step, as the original 3DS, Wii, GameCube and NDS loops did. The original SDL
+    // loops destroyed every brick the ball overlapped and flipped the ball once for each,
+    // so two bricks hit at once cancelled the bounce; that is not kept.
+    bool useDiscreteCollision;
+} GameConfig;
+
+typedef struct
+{
+    bool moveLeft;
+    bool moveRight;
+} GameInput;
+
+// update() returns a mask of these so each port can play its own sounds and
+// refresh its own score/lives text.
+enum GameEvent
+{
+    GAME_EVENT_NONE = 0,
+    GAME_EVENT_WALL_HIT = 1 << 0,
+    GAME_EVENT_CEILING_HIT = 1 << 1,
+    GAME_EVENT_PLAYER_HIT = 1 << 2,
+    GAME_EVENT_BRICK_HIT = 1 << 3,
+    GAME_EVENT_LIFE_LOST = 1 << 4,
+};
+
+const int GAME_EVENT_TYPES = 5;
+
+const int BRICK_MASK_BITS = 32;
+
+// The grid gives every brick's bounds and each row is worth the same points, so a
+// brick is only its bit in the row's alive masks: bit c % 32 of word c / 32 for column c.
+typedef struct
+{
+    int rows;
+    int columns;
+    int wordsPerRow;
+    std::vector<uint32_t> aliveMasks;
+    std::vector<int> rowPoints;
+} BrickField;
+
+typedef struct
+{
+    GameConfig config;
+
+    Bounds player;
+    Bounds ball;
+
+    Number ballVelocityX;
+    Number ballVelocityY;
+
+    int playerScore;
+    int playerLives;
+    int destroyedBricks;
+
+    bool isAutoPlayMode;
+
+    BrickField bricks;
+
+    // When each event of the last step first happened, as a fraction of the step, indexed
+    // by the event's bit. Read them with firstEventTime().
+    Number eventTimes[GAME_EVENT_TYPES];
+} Game;
+
+void initBrickField(BrickField &field, const GameConfig &config);
+
+Bounds getBrickBounds(const GameConfig &config, int row, int column);
+
+bool isBrickAlive(const BrickField &field, int row, int column);
+
+void destroyBrick(BrickField &field, int row, int column);
+
+inline int countTrailingZeros(uint32_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    int count = 0;
+
+    while ((bits & 1) == 0)
+    {
+        bits >>= 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+// The first standing brick in row at or after column, or -1 when there is none. Walk a
+// row with: for (c = findNextBrick(f, r, 0); c >= 0; c = findNextBrick(f, r, c + 1))
+// Inline because it runs once per standing brick in every pass over the field.
+inline int findNextBrick(const BrickField &field, int row, int column)
+{
+    if (column >= field.columns)
+    {
+        return -1;
+    }
+
+    const uint32_t *masks = &field.aliveMasks[row * field.wordsPerRow];
+
+    int word = column / BRICK_MASK_BITS;
+    uint32_t bits = masks[word] & (~0u << (column % BRICK_MASK_BITS));
+
+    while (bits == 0)
+    {
+        word++;
+
+        if (word == field.wordsPerRow)
+        {
+            return -1;
+        }
+
+        bits = masks[word];
+    }
+
+    return word * BRICK_MASK_BITS + countTrailingZeros(bits);
+}
+
+int countBricks(const BrickField &field);
+
+// Adds the bounds of every brick standing in drawn but gone from field to cleared, e.g. to
+// erase them from a cached picture of drawn. Returns false when field has a brick that
+// drawn doesn't, which can't be patched by erasing and needs a full redraw.
+bool findClearedBricks(const GameConfig &config, const BrickField &drawn, const BrickField &field, std::vector<Bounds> &cleared);
+
+// The brick layout is a uniform grid, so the bricks an area can touch are found from
+// its bounds alone. Gives the range of rows and columns whose cells overlap area,
+// clamped to the field, or returns false when area is clear of the brick band.
+bool findBrickCells(const GameConfig &config, const Bounds &area, int &firstRow, int &lastRow, int &firstColumn, int &lastColumn);
+
+void initGame(Game &game, const GameConfig &config);
+
+// Starts the ball from a position and direction picked from the seed, so runs
+// without any input can still cover different games. The same seed always gives the same game.
+void serveBall(Game &game, unsigned int seed);
+
+bool hasCollision(const Bounds &bounds, const Bounds &ball);
+
+// Swept AABB test of moving (displaced by deltaX, deltaY over the step) against a
+// still target. On a hit returns true with the fraction of the step at first contact
+// in time and whether the moving box hit a left/right side (isSideHit) or top/bottom.
+// A box that starts inside the target hits it at time 0.
+bool sweepBounds(const Bounds &moving, Number deltaX, Number deltaY, const Bounds &target, Number &time, bool &isSideHit);
+
+int updateGame(Game &game, const GameInput &input, Number deltaTime);
+
+// When the first of events happened during the last updateGame() step, from 0 at its start
+// to 1 at its end, e.g. to start a sound at the moment of the hit instead of at the tick.
+// Always 0 with discrete collision, which finds hits after moving the whole step.
+Number firstEventTime(const Game &game, int events);
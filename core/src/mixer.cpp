@@ -0,0 +1,230 @@
+#include "mixer.h"
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MIXER_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MIXER_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIXER_NEON
+#endif
+
+static int16_t saturate(int value)
+{
+    return (int16_t)(value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+}
+
+// Volumes are scaled as (sample * (volume << 7)) >> 15, which is what the high and low
+// halves of a 16-bit multiply give in SIMD, so every path produces the same samples.
+static int scaleSample(int sample, int volume)
+{
+    return (sample * (volume << 7)) >> 15;
+}
+
+void addSaturatingScalar(int16_t *output, const int16_t *input, int count, int volume)
+{
+    if (volume == MIXER_FULL_VOLUME)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            output[i] = saturate(output[i] + input[i]);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            output[i] = saturate(output[i] + scaleSample(input[i], volume));
+        }
+    }
+}
+
+#if defined(MIXER_AVX2)
+
+static int addSaturatingWide(int16_t *output, const int16_t *input, int count, int volume)
+{
+    const __m256i scale = _mm256_set1_epi16((short)(volume << 7));
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i samples = _mm256_loadu_si256((const __m256i *)(input + i));
+        __m256i mixed = _mm256_loadu_si256((const __m256i *)(output + i));
+
+        if (volume != MIXER_FULL_VOLUME)
+        {
+            __m256i high = _mm256_mulhi_epi16(samples, scale);
+            __m256i low = _mm256_mullo_epi16(samples, scale);
+            samples = _mm256_or_si256(_mm256_slli_epi16(high, 1), _mm256_srli_epi16(low, 15));
+        }
+
+        _mm256_storeu_si256((__m256i *)(output + i), _mm256_adds_epi16(mixed, samples));
+    }
+
+    return i;
+}
+
+#elif defined(MIXER_SSE2)
+
+static int addSaturatingWide(int16_t *output, const int16_t *input, int count, int volume)
+{
+    const __m128i scale = _mm_set1_epi16((short)(volume << 7));
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i samples = _mm_loadu_si128((const __m128i *)(input + i));
+        __m128i mixed = _mm_loadu_si128((const __m128i *)(output + i));
+
+        if (volume != MIXER_FULL_VOLUME)
+        {
+            __m128i high = _mm_mulhi_epi16(samples, scale);
+            __m128i low = _mm_mullo_epi16(samples, scale);
+            samples = _mm_or_si128(_mm_slli_epi16(high, 1), _mm_srli_epi16(low, 15));
+        }
+
+        _mm_storeu_si128((__m128i *)(output + i), _mm_adds_epi16(mixed, samples));
+    }
+
+    return i;
+}
+
+#elif defined(MIXER_NEON)
+
+static int addSaturatingWide(int16_t *output, const int16_t *input, int count, int volume)
+{
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t samples = vld1q_s16(input + i);
+
+        if (volume != MIXER_FULL_VOLUME)
+        {
+            // (2 * sample * scale) >> 16, the same as scaleSample().
+            samples = vqdmulhq_n_s16(samples, (int16_t)(volume << 7));
+        }
+
+        vst1q_s16(output + i, vqaddq_s16(vld1q_s16(output + i), samples));
+    }
+
+    return i;
+}
+
+#else
+
+static int addSaturatingWide(int16_t *, const int16_t *, int, int)
+{
+    return 0;
+}
+
+#endif
+
+void addSaturating(int16_t *output, const int16_t *input, int count, int volume)
+{
+    int done = addSaturatingWide(output, input, count, volume);
+
+    addSaturatingScalar(output + done, input + done, count - done, volume);
+}
+
+void initMixer(Mixer &mixer, int rate, int voiceCount)
+{
+    mixer.rate = rate;
+    mixer.sounds.clear();
+    mixer.voices.assign(voiceCount, MixerVoice{-1, 0, MIXER_FULL_VOLUME, false, 0});
+    mixer.mixedFrames = 0;
+
+    mixer.startDelay = 0;
+    mixer.lateStarts = 0;
+}
+
+int addMixerSound(Mixer &mixer, PcmSound sound)
+{
+    if (sound.rate == mixer.rate && sound.channels == MIXER_CHANNELS)
+    {
+        mixer.sounds.push_back(std::move(sound));
+    }
+    else
+    {
+        mixer.sounds.push_back(PcmSound());
+        convertPcm(sound, mixer.rate, MIXER_CHANNELS, mixer.sounds.back());
+    }
+
+    return (int)mixer.sounds.size() - 1;
+}
+
+void mixAudio(Mixer &mixer, SpscQueue<MixerCommand> &commands, int16_t *output, int frames, double now)
+{
+    MixerCommand command;
+
+    while (commands.pop(command))
+    {
+        if (command.voice < 0 || command.voice >= (int)mixer.voices.size())
+        {
+            continue;
+        }
+
+        MixerVoice &voice = mixer.voices[command.voice];
+        bool isKnownSound = command.sound >= 0 && command.sound < (int)mixer.sounds.size();
+
+        voice.sound = isKnownSound ? command.sound : -1;
+        voice.position = 0;
+        voice.volume = command.volume;
+        voice.isWaiting = mixer.startDelay > 0;
+        voice.startTime = command.time + mixer.startDelay;
+
+        if (voice.isWaiting && voice.startTime < now)
+        {
+            voice.isWaiting = false;
+            mixer.lateStarts++;
+        }
+    }
+
+    memset(output, 0, frames * MIXER_CHANNELS * sizeof(int16_t));
+
+    for (MixerVoice &voice : mixer.voices)
+    {
+        if (voice.sound < 0)
+        {
+            continue;
+        }
+
+        // A voice starting inside the buffer leaves the frames before it to the others.
+        int start = 0;
+
+        if (voice.isWaiting)
+        {
+            double offset = floor((voice.startTime - now) * mixer.rate + 0.5);
+
+            if (offset >= frames)
+            {
+                continue;
+            }
+
+            start = offset > 0 ? (int)offset : 0;
+            voice.isWaiting = false;
+        }
+
+        const PcmSound &sound = mixer.sounds[voice.sound];
+        int remaining = pcmFrameCount(sound) - voice.position;
+        int count = remaining < frames - start ? remaining : frames - start;
+
+        if (count > 0)
+        {
+            addSaturating(output + start * MIXER_CHANNELS, &sound.samples[voice.position * MIXER_CHANNELS], count * MIXER_CHANNELS, voice.volume);
+            voice.position += count;
+        }
+
+        if (voice.position >= pcmFrameCount(sound))
+        {
+            voice.sound = -1;
+        }
+    }
+
+    mixer.mixedFrames += frames;
+}
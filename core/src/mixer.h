@@ -0,0 +1,87 @@
+#pragma once
+
+#include "pcm.h"
+#include "spsc_queue.h"
+#include <stdint.h>
+#include <vector>
+
+// A small sound effect mixer for an SDL_OpenAudioDevice() callback, instead of SDL_mixer.
+// Sounds are converted to the device's rate as signed 16-bit stereo when they are added,
+// so mixing is only saturating adds of samples that are already in the output format.
+// The game side never touches the voices: it pushes a MixerCommand, and mixAudio() takes
+// the commands at the start of the next buffer on the audio thread. With a startDelay, a
+// command starts its voice on the exact frame its time plus the delay falls on, instead of
+// at the start of whichever buffer takes it, so sounds keep the spacing of what caused them.
+
+const int MIXER_CHANNELS = 2;
+
+// A voice at this volume is added without scaling.
+const int MIXER_FULL_VOLUME = 256;
+
+// Start sound on voice, cutting off whatever the voice was playing.
+typedef struct
+{
+    int voice;
+    int sound;
+    int volume;
+
+    // When the sound was caused, in seconds of the clock passed to mixAudio(). Only used
+    // with a startDelay.
+    double time;
+} MixerCommand;
+
+typedef struct
+{
+    // -1 when the voice is free.
+    int sound;
+    int position;
+    int volume;
+
+    // The voice starts at startTime, inside this buffer or a later one.
+    bool isWaiting;
+    double startTime;
+} MixerVoice;
+
+typedef struct
+{
+    int rate;
+
+    // In the device format.
+    std::vector<PcmSound> sounds;
+    std::vector<MixerVoice> voices;
+
+    // Frames mixAudio() has written since initMixer().
+    long long mixedFrames;
+
+    // Seconds from a command's time to its voice starting, long enough for the command to
+    // reach the mixer. 0, the default, starts every command at the start of the buffer.
+    double startDelay;
+
+    // Commands that reached the mixer after the time they should have started at, and
+    // started at the start of the buffer instead.
+    long long lateStarts;
+} Mixer;
+
+void initMixer(Mixer &mixer, int rate, int voiceCount);
+
+// Converts sound to the mixer's format and returns its id for MixerCommand::sound. A
+// sound already in the format, e.g. a cooked one, is moved in as it is when passed with
+// std::move(). Sounds must all be added before the audio device starts.
+int addMixerSound(Mixer &mixer, PcmSound sound);
+
+inline double mixerSoundSeconds(const Mixer &mixer, int sound)
+{
+    return (double)pcmFrameCount(mixer.sounds[sound]) / mixer.rate;
+}
+
+// Audio thread only. Runs the queued commands and fills output with frames stereo frames.
+// now is the time of the call in seconds of the clock the commands' times are in, taken
+// as the time the buffer's first frame plays at: a waiting voice starts (startTime - now)
+// * rate frames into the buffer.
+void mixAudio(Mixer &mixer, SpscQueue<MixerCommand> &commands, int16_t *output, int frames, double now);
+
+// output[i] = saturate(output[i] + input[i] * volume / MIXER_FULL_VOLUME) over count samples.
+void addSaturating(int16_t *output, const int16_t *input, int count, int volume);
+
+// The same without SIMD, to check addSaturating() against.
+void addSaturatingScalar(int16_t *output, const int16_t *input, int count, int volume);
@@ -0,0 +1,714 @@
+#include "mod_player.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define MOD_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MOD_NEON
+#endif
+
+// The PAL Amiga's clock: a note at period p plays its sample at AMIGA_CLOCK / p Hz.
+const uint32_t AMIGA_CLOCK = 3546895;
+
+// The range ProTracker keeps slides in, B-3 to C-1.
+const int MIN_PERIOD = 113;
+const int MAX_PERIOD = 856;
+
+const int ROWS_PER_PATTERN = 64;
+const int PATTERN_BYTES = ROWS_PER_PATTERN * MOD_CHANNELS * 4;
+const int HEADER_BYTES = 1084;
+
+// Frames mixed at a time, at most one tick.
+const int MIX_CHUNK_FRAMES = 1024;
+
+// 2^(-n / 12) in 16.16: the period n semitones up, for arpeggio.
+const int SEMITONE_RATIOS[16] = {65536, 61858, 58386, 55109, 52016, 49097, 46341, 43740, 41285, 38968, 36781, 34716, 32768, 30929, 29193, 27554};
+
+// 2^(-finetune / 96) in 16.16 for finetunes -8 to 7.
+const int FINETUNE_RATIOS[16] = {69433, 68933, 68438, 67945, 67456, 66971, 66489, 66011, 65536, 65065, 64596, 64132, 63670, 63212, 62757, 62306};
+
+// ProTracker's vibrato sine, half a cycle.
+const int VIBRATO_SINE[32] = {0, 24, 49, 74, 97, 120, 141, 161, 180, 197, 212, 224, 235, 244, 250, 253,
+                              255, 253, 250, 244, 235, 224, 212, 197, 180, 161, 141, 120, 97, 74, 49, 24};
+
+static int16_t saturate(int value)
+{
+    return (int16_t)(value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+}
+
+static int readBig16(const uint8_t *bytes)
+{
+    return (bytes[0] << 8) | bytes[1];
+}
+
+// A 16-bit sample between two 8-bit ones. weight is 0 to 255; the result always fits in
+// 16 bits, which lets the SIMD paths compute it with wrapping 16-bit multiplies.
+static int interpolate(const int8_t *data, int position, uint32_t offset)
+{
+    int index = position + (int)(offset >> 16);
+    int weight = (int)((offset >> 8) & 0xff);
+    int first = data[index];
+
+    return first * 256 + (data[index + 1] - first) * weight;
+}
+
+void resampleAddScalar(const int8_t *data, int position, uint32_t fraction, uint32_t step, int volume, int16_t *output, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int value = interpolate(data, position, fraction + (uint32_t)i * step);
+
+        output[i] = saturate(output[i] + ((value * (volume << 8)) >> 16));
+    }
+}
+
+#if defined(MOD_SSE2) || defined(MOD_NEON)
+
+// Two neighbouring 8-bit samples, the first in the low byte.
+static int readPair(const int8_t *data)
+{
+    uint16_t pair;
+    memcpy(&pair, data, sizeof(pair));
+
+    return pair;
+}
+
+#if defined(MOD_SSE2)
+
+// Each lane's two samples are read as one 16-bit word and put in its lane, and the
+// interpolation, volume and mix are done eight frames at a time. Reading the words is
+// quicker than an AVX2 gather.
+static int resampleAddWide(const int8_t *data, int position, uint32_t fraction, uint32_t step, int volume, int16_t *output, int count)
+{
+    const __m128i scale = _mm_set1_epi16((short)(volume << 8));
+    const __m128i weightMask = _mm_set1_epi32(0xff);
+    const __m128i advance = _mm_set1_epi32((int)(step * 8));
+
+    __m128i low = _mm_add_epi32(_mm_set1_epi32((int)fraction), _mm_setr_epi32(0, (int)step, (int)(step * 2), (int)(step * 3)));
+    __m128i high = _mm_add_epi32(low, _mm_set1_epi32((int)(step * 4)));
+    const int8_t *start = data + position;
+    uint32_t offset = fraction;
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i pairs = _mm_cvtsi32_si128(readPair(start + (offset >> 16)));
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step) >> 16)), 1);
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step * 2) >> 16)), 2);
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step * 3) >> 16)), 3);
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step * 4) >> 16)), 4);
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step * 5) >> 16)), 5);
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step * 6) >> 16)), 6);
+        pairs = _mm_insert_epi16(pairs, readPair(start + ((offset + step * 7) >> 16)), 7);
+        offset += step * 8;
+
+        __m128i first = _mm_srai_epi16(_mm_slli_epi16(pairs, 8), 8);
+        __m128i next = _mm_srai_epi16(pairs, 8);
+        __m128i weight = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, 8), weightMask), _mm_and_si128(_mm_srli_epi32(high, 8), weightMask));
+
+        __m128i value = _mm_add_epi16(_mm_slli_epi16(first, 8), _mm_mullo_epi16(_mm_sub_epi16(next, first), weight));
+        __m128i mixed = _mm_loadu_si128((const __m128i *)(output + i));
+
+        _mm_storeu_si128((__m128i *)(output + i), _mm_adds_epi16(mixed, _mm_mulhi_epi16(value, scale)));
+
+        low = _mm_add_epi32(low, advance);
+        high = _mm_add_epi32(high, advance);
+    }
+
+    return i;
+}
+
+#else
+
+// The same eight frames at a time with NEON.
+static int resampleAddWide(const int8_t *data, int position, uint32_t fraction, uint32_t step, int volume, int16_t *output, int count)
+{
+    const int8_t *start = data + position;
+    uint32_t offset = fraction;
+    int16_t weights[8];
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t pairs = vdupq_n_s16(0);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + (offset >> 16)), pairs, 0);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step) >> 16)), pairs, 1);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step * 2) >> 16)), pairs, 2);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step * 3) >> 16)), pairs, 3);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step * 4) >> 16)), pairs, 4);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step * 5) >> 16)), pairs, 5);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step * 6) >> 16)), pairs, 6);
+        pairs = vsetq_lane_s16((int16_t)readPair(start + ((offset + step * 7) >> 16)), pairs, 7);
+
+        for (int lane = 0; lane < 8; lane++)
+        {
+            weights[lane] = (int16_t)(((offset + step * lane) >> 8) & 0xff);
+        }
+
+        offset += step * 8;
+
+        int16x8_t first = vshrq_n_s16(vshlq_n_s16(pairs, 8), 8);
+        int16x8_t next = vshrq_n_s16(pairs, 8);
+        int16x8_t value = vaddq_s16(vshlq_n_s16(first, 8), vmulq_s16(vsubq_s16(next, first), vld1q_s16(weights)));
+
+        // (2 * value * (volume << 7)) >> 16, the same as the scalar loop.
+        int16x8_t scaled = vqdmulhq_n_s16(value, (int16_t)(volume << 7));
+
+        vst1q_s16(output + i, vqaddq_s16(vld1q_s16(output + i), scaled));
+    }
+
+    return i;
+}
+
+#endif
+
+#else
+
+static int resampleAddWide(const int8_t *, int, uint32_t, uint32_t, int, int16_t *, int)
+{
+    return 0;
+}
+
+#endif
+
+void resampleAdd(const int8_t *data, int position, uint32_t fraction, uint32_t step, int volume, int16_t *output, int count)
+{
+    int done = resampleAddWide(data, position, fraction, step, volume, output, count);
+
+    resampleAddScalar(data, position, fraction + (uint32_t)done * step, step, volume, output + done, count - done);
+}
+
+void interleaveStereoScalar(const int16_t *left, const int16_t *right, int16_t *output, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        output[i * 2] = saturate(left[i] * 2);
+        output[i * 2 + 1] = saturate(right[i] * 2);
+    }
+}
+
+void interleaveStereo(const int16_t *left, const int16_t *right, int16_t *output, int count)
+{
+    int i = 0;
+
+#if defined(MOD_SSE2)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i leftSide = _mm_loadu_si128((const __m128i *)(left + i));
+        __m128i rightSide = _mm_loadu_si128((const __m128i *)(right + i));
+
+        leftSide = _mm_adds_epi16(leftSide, leftSide);
+        rightSide = _mm_adds_epi16(rightSide, rightSide);
+
+        _mm_storeu_si128((__m128i *)(output + i * 2), _mm_unpacklo_epi16(leftSide, rightSide));
+        _mm_storeu_si128((__m128i *)(output + i * 2 + 8), _mm_unpackhi_epi16(leftSide, rightSide));
+    }
+#elif defined(MOD_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8x2_t sides;
+        sides.val[0] = vld1q_s16(left + i);
+        sides.val[1] = vld1q_s16(right + i);
+        sides.val[0] = vqaddq_s16(sides.val[0], sides.val[0]);
+        sides.val[1] = vqaddq_s16(sides.val[1], sides.val[1]);
+
+        vst2q_s16(output + i * 2, sides);
+    }
+#endif
+
+    interleaveStereoScalar(left + i, right + i, output + i * 2, count - i);
+}
+
+ModPlayer::ModPlayer()
+    : songLength(0), restartOrder(0), rate(0), isLooping(false), isEnded(true), isScalarMixing(false), speed(6), tempo(125), tick(0), order(0),
+      row(0), nextOrder(-1), nextRow(0), tickFramesLeft(0), tickRemainder(0)
+{
+    memset(orders, 0, sizeof(orders));
+}
+
+bool ModPlayer::load(const uint8_t *data, size_t size, int rate, bool isLooping)
+{
+    const char *tags[] = {"M.K.", "M!K!", "4CHN", "FLT4"};
+    bool isFourChannels = false;
+
+    for (const char *tag : tags)
+    {
+        isFourChannels = isFourChannels || (size >= (size_t)HEADER_BYTES && memcmp(data + 1080, tag, 4) == 0);
+    }
+
+    if (!isFourChannels || rate <= 0)
+    {
+        return false;
+    }
+
+    songLength = data[950];
+    restartOrder = data[951];
+
+    if (songLength < 1 || songLength > 128)
+    {
+        return false;
+    }
+
+    int patternCount = 0;
+
+    for (int i = 0; i < 128; i++)
+    {
+        orders[i] = data[952 + i];
+        patternCount = orders[i] + 1 > patternCount ? orders[i] + 1 : patternCount;
+    }
+
+    size_t sampleOffset = HEADER_BYTES + (size_t)patternCount * PATTERN_BYTES;
+
+    if (sampleOffset > size)
+    {
+        return false;
+    }
+
+    patterns.assign(data + HEADER_BYTES, data + sampleOffset);
+    samples.assign(MOD_SAMPLES, ModSample());
+
+    for (int i = 0; i < MOD_SAMPLES; i++)
+    {
+        const uint8_t *header = data + 20 + i * 30;
+        ModSample &sample = samples[i];
+
+        int length = readBig16(header + 22) * 2;
+        // The last samples of some modules are cut short.
+        size_t remaining = sampleOffset < size ? size - sampleOffset : 0;
+        int available = remaining < (size_t)length ? (int)remaining : length;
+        int loopStart = readBig16(header + 26) * 2;
+        int loopLength = readBig16(header + 28) * 2;
+
+        sample.finetune = header[24] & 0x0f;
+        sample.volume = header[25] > 64 ? 64 : header[25];
+
+        // A loop of one word means the sample doesn't loop.
+        if (loopLength > 2 && loopStart < available)
+        {
+            sample.end = loopStart + loopLength < available ? loopStart + loopLength : available;
+            sample.loopStart = loopStart;
+            sample.loopLength = sample.end - loopStart;
+        }
+        else
+        {
+            sample.end = available;
+            sample.loopStart = 0;
+            sample.loopLength = 0;
+        }
+
+        sample.data.assign(MOD_GUARD_SAMPLES + sample.end, 0);
+        memcpy(sample.data.data(), data + sampleOffset, sample.end);
+
+        for (int guard = 0; guard < MOD_GUARD_SAMPLES && sample.loopLength > 0; guard++)
+        {
+            sample.data[sample.end + guard] = sample.data[sample.loopStart + guard % sample.loopLength];
+        }
+
+        sampleOffset += length;
+    }
+
+    for (ModChannel &channel : channels)
+    {
+        memset(&channel, 0, sizeof(channel));
+        channel.sample = -1;
+    }
+
+    this->rate = rate;
+    this->isLooping = isLooping;
+    isEnded = false;
+
+    speed = 6;
+    tempo = 125;
+    tick = 0;
+    order = 0;
+    row = 0;
+    nextOrder = -1;
+    nextRow = 0;
+    tickFramesLeft = 0;
+    tickRemainder = 0;
+
+    left.assign(MIX_CHUNK_FRAMES, 0);
+    right.assign(MIX_CHUNK_FRAMES, 0);
+
+    return true;
+}
+
+bool ModPlayer::loadFile(const char *path, int rate, bool isLooping)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr)
+    {
+        printf("Unable to open %s!\n", path);
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[16384];
+    size_t count;
+
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+
+    fclose(file);
+
+    if (!load(data.data(), data.size(), rate, isLooping))
+    {
+        printf("%s isn't a 4-channel module!\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+static int finetunePeriod(int period, int finetune)
+{
+    return (period * FINETUNE_RATIOS[(finetune ^ 8) & 15] + 32768) >> 16;
+}
+
+static void slideVolume(ModChannel &channel)
+{
+    int up = channel.param >> 4;
+    int down = channel.param & 0x0f;
+
+    channel.volume = up > 0 ? channel.volume + up : channel.volume - down;
+    channel.volume = channel.volume > 64 ? 64 : (channel.volume < 0 ? 0 : channel.volume);
+}
+
+static void slideToNote(ModChannel &channel)
+{
+    if (channel.portaTarget == 0)
+    {
+        return;
+    }
+
+    if (channel.period < channel.portaTarget)
+    {
+        channel.period = channel.period + channel.portaSpeed < channel.portaTarget ? channel.period + channel.portaSpeed : channel.portaTarget;
+    }
+    else
+    {
+        channel.period = channel.period - channel.portaSpeed > channel.portaTarget ? channel.period - channel.portaSpeed : channel.portaTarget;
+    }
+
+    channel.outputPeriod = channel.period;
+}
+
+static void vibrate(ModChannel &channel)
+{
+    int delta = VIBRATO_SINE[channel.vibratoPosition & 31] * channel.vibratoDepth >> 7;
+
+    channel.outputPeriod = channel.period + ((channel.vibratoPosition & 32) != 0 ? -delta : delta);
+    channel.vibratoPosition = (channel.vibratoPosition + channel.vibratoSpeed) & 63;
+}
+
+void ModPlayer::startNote(ModChannel &channel, const uint8_t *note)
+{
+    int sampleNumber = (note[0] & 0xf0) | (note[2] >> 4);
+    int period = ((note[0] & 0x0f) << 8) | note[1];
+
+    channel.effect = note[2] & 0x0f;
+    channel.param = note[3];
+
+    if (sampleNumber > 0 && sampleNumber <= MOD_SAMPLES)
+    {
+        channel.sample = sampleNumber - 1;
+        channel.volume = samples[channel.sample].volume;
+    }
+
+    if (period > 0 && channel.sample >= 0)
+    {
+        period = finetunePeriod(period, samples[channel.sample].finetune);
+
+        // Tone portamento slides to the note instead of playing it.
+        if (channel.effect == 0x3 || channel.effect == 0x5)
+        {
+            channel.portaTarget = period;
+        }
+        else
+        {
+            channel.period = period;
+            channel.position = 0;
+            channel.fraction = 0;
+            channel.isPlaying = true;
+            channel.vibratoPosition = 0;
+
+            if (channel.effect == 0x9)
+            {
+                channel.sampleOffset = channel.param > 0 ? channel.param * 256 : channel.sampleOffset;
+                channel.position = channel.sampleOffset;
+            }
+        }
+    }
+
+    channel.outputPeriod = channel.period;
+
+    int high = channel.param >> 4;
+    int low = channel.param & 0x0f;
+
+    switch (channel.effect)
+    {
+    case 0x3:
+        channel.portaSpeed = channel.param > 0 ? channel.param : channel.portaSpeed;
+        break;
+    case 0x4:
+        channel.vibratoSpeed = high > 0 ? high : channel.vibratoSpeed;
+        channel.vibratoDepth = low > 0 ? low : channel.vibratoDepth;
+        break;
+    case 0xb:
+        nextOrder = channel.param;
+        break;
+    case 0xc:
+        channel.volume = channel.param > 64 ? 64 : channel.param;
+        break;
+    case 0xd:
+        // The row is in decimal.
+        nextRow = high * 10 + low < ROWS_PER_PATTERN ? high * 10 + low : 0;
+        nextOrder = nextOrder < 0 ? order + 1 : nextOrder;
+        break;
+    case 0xe:
+        if (high == 0x1)
+        {
+            channel.period = channel.period - low > MIN_PERIOD ? channel.period - low : MIN_PERIOD;
+        }
+        else if (high == 0x2)
+        {
+            channel.period = channel.period + low < MAX_PERIOD ? channel.period + low : MAX_PERIOD;
+        }
+        else if (high == 0xa)
+        {
+            channel.volume = channel.volume + low < 64 ? channel.volume + low : 64;
+        }
+        else if (high == 0xb)
+        {
+            channel.volume = channel.volume - low > 0 ? channel.volume - low : 0;
+        }
+        else if (high == 0xc && low == 0)
+        {
+            channel.volume = 0;
+        }
+
+        channel.outputPeriod = channel.period;
+        break;
+    case 0xf:
+        if (channel.param > 0 && channel.param < 32)
+        {
+            speed = channel.param;
+        }
+        else if (channel.param >= 32)
+        {
+            tempo = channel.param;
+        }
+        break;
+    }
+}
+
+void ModPlayer::startRow()
+{
+    const uint8_t *notes = &patterns[((size_t)orders[order] * ROWS_PER_PATTERN + row) * MOD_CHANNELS * 4];
+
+    nextOrder = -1;
+    nextRow = 0;
+
+    for (int i = 0; i < MOD_CHANNELS; i++)
+    {
+        startNote(channels[i], notes + i * 4);
+    }
+}
+
+void ModPlayer::updateEffect(ModChannel &channel)
+{
+    int high = channel.param >> 4;
+    int low = channel.param & 0x0f;
+
+    channel.outputPeriod = channel.period;
+
+    switch (channel.effect)
+    {
+    case 0x0:
+        if (channel.param != 0)
+        {
+            int semitones = tick % 3 == 0 ? 0 : (tick % 3 == 1 ? high : low);
+            channel.outputPeriod = (channel.period * SEMITONE_RATIOS[semitones] + 32768) >> 16;
+        }
+        break;
+    case 0x1:
+        channel.period = channel.period - channel.param > MIN_PERIOD ? channel.period - channel.param : MIN_PERIOD;
+        channel.outputPeriod = channel.period;
+        break;
+    case 0x2:
+        channel.period = channel.period + channel.param < MAX_PERIOD ? channel.period + channel.param : MAX_PERIOD;
+        channel.outputPeriod = channel.period;
+        break;
+    case 0x3:
+        slideToNote(channel);
+        break;
+    case 0x4:
+        vibrate(channel);
+        break;
+    case 0x5:
+        slideToNote(channel);
+        slideVolume(channel);
+        break;
+    case 0x6:
+        vibrate(channel);
+        slideVolume(channel);
+        break;
+    case 0xa:
+        slideVolume(channel);
+        break;
+    case 0xe:
+        if (high == 0x9 && low > 0 && tick % low == 0)
+        {
+            channel.position = 0;
+            channel.fraction = 0;
+            channel.isPlaying = channel.sample >= 0;
+        }
+        else if (high == 0xc && tick == low)
+        {
+            channel.volume = 0;
+        }
+        break;
+    }
+}
+
+void ModPlayer::updateTick()
+{
+    if (tick == 0)
+    {
+        startRow();
+    }
+    else
+    {
+        for (ModChannel &channel : channels)
+        {
+            updateEffect(channel);
+        }
+    }
+
+    // A tick is 2.5 / tempo seconds; the remainder carries so ticks don't drift.
+    int frames = tickRemainder + rate * 5;
+    tickFramesLeft = frames / (tempo * 2);
+    tickRemainder = frames % (tempo * 2);
+
+    if (++tick < speed)
+    {
+        return;
+    }
+
+    tick = 0;
+
+    if (nextOrder >= 0)
+    {
+        // Jumping back is where a song that doesn't loop ends.
+        isEnded = !isLooping && nextOrder <= order;
+        order = nextOrder;
+        row = nextRow;
+    }
+    else if (++row == ROWS_PER_PATTERN)
+    {
+        row = 0;
+        order++;
+    }
+
+    if (order >= songLength)
+    {
+        isEnded = !isLooping;
+        order = restartOrder < songLength ? restartOrder : 0;
+    }
+}
+
+void ModPlayer::mixChannel(ModChannel &channel, int16_t *output, int frames)
+{
+    if (!channel.isPlaying || channel.sample < 0 || channel.outputPeriod <= 0)
+    {
+        return;
+    }
+
+    const ModSample &sample = samples[channel.sample];
+    uint32_t step = (uint32_t)(((uint64_t)AMIGA_CLOCK << 16) / ((uint64_t)channel.outputPeriod * rate));
+
+    for (int done = 0; done < frames;)
+    {
+        if (channel.position >= sample.end)
+        {
+            if (sample.loopLength == 0)
+            {
+                channel.isPlaying = false;
+                return;
+            }
+
+            channel.position = sample.loopStart + (channel.position - sample.loopStart) % sample.loopLength;
+        }
+
+        // Frames until the position passes the end, where it stops or loops.
+        uint64_t remaining = ((uint64_t)(sample.end - channel.position) << 16) - channel.fraction;
+        uint64_t untilEnd = (remaining + step - 1) / step;
+        int count = (uint64_t)(frames - done) < untilEnd ? frames - done : (int)untilEnd;
+
+        if (isScalarMixing)
+        {
+            resampleAddScalar(sample.data.data(), channel.position, channel.fraction, step, channel.volume, output + done, count);
+        }
+        else
+        {
+            resampleAdd(sample.data.data(), channel.position, channel.fraction, step, channel.volume, output + done, count);
+        }
+
+        uint64_t advanced = channel.fraction + (uint64_t)count * step;
+        channel.position += (int)(advanced >> 16);
+        channel.fraction = (uint32_t)(advanced & 0xffff);
+        done += count;
+    }
+}
+
+int ModPlayer::render(int16_t *output, int frames)
+{
+    int rendered = 0;
+
+    while (rendered < frames)
+    {
+        if (tickFramesLeft == 0)
+        {
+            if (isEnded)
+            {
+                break;
+            }
+
+            updateTick();
+            continue;
+        }
+
+        int count = frames - rendered;
+        count = count < tickFramesLeft ? count : tickFramesLeft;
+        count = count < MIX_CHUNK_FRAMES ? count : MIX_CHUNK_FRAMES;
+
+        memset(left.data(), 0, count * sizeof(int16_t));
+        memset(right.data(), 0, count * sizeof(int16_t));
+
+        // Channels 1 and 4 left, 2 and 3 right.
+        mixChannel(channels[0], left.data(), count);
+        mixChannel(channels[1], right.data(), count);
+        mixChannel(channels[2], right.data(), count);
+        mixChannel(channels[3], left.data(), count);
+
+        if (isScalarMixing)
+        {
+            interleaveStereoScalar(left.data(), right.data(), output + rendered * 2, count);
+        }
+        else
+        {
+            interleaveStereo(left.data(), right.data(), output + rendered * 2, count);
+        }
+
+        tickFramesLeft -= count;
+        rendered += count;
+    }
+
+    return rendered;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "music_stream.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Plays 4-channel ProTracker modules, like the NDS port's Darkstone.mod and
+// FlatOutLies.mod, as a MusicSource, so every port can stream the same few kilobytes of
+// music through its mixer. Channels 1 and 4 are on the left and 2 and 3 on the right, as
+// on the Amiga. Each channel's sample is resampled with linear interpolation, several
+// output frames per SIMD instruction. The effects the modules use are supported: arpeggio,
+// slides, tone portamento, vibrato, sample offset, volume, position jump, pattern break,
+// speed and tempo, and the fine slides, retrigger and note cut of the E effects.
+
+const int MOD_CHANNELS = 4;
+const int MOD_SAMPLES = 31;
+
+typedef struct
+{
+    int volume;
+    int finetune;
+
+    // Samples played before the sample stops, or goes back to loopStart when loopLength
+    // isn't 0.
+    int end;
+    int loopStart;
+    int loopLength;
+
+    // end samples, then MOD_GUARD_SAMPLES more: the start of the loop, or silence, so
+    // interpolating past the last sample needs no check.
+    std::vector<int8_t> data;
+} ModSample;
+
+typedef struct
+{
+    // -1 before the channel's first note.
+    int sample;
+    bool isPlaying;
+
+    int position;
+    uint32_t fraction;
+
+    int volume;
+    int period;
+
+    // The period after arpeggio and vibrato, which sets the pitch the channel plays at.
+    int outputPeriod;
+
+    int effect;
+    int param;
+
+    int portaTarget;
+    int portaSpeed;
+    int vibratoSpeed;
+    int vibratoDepth;
+    int vibratoPosition;
+    int sampleOffset;
+} ModChannel;
+
+// Sample bytes after a sample's end that resampling can read.
+const int MOD_GUARD_SAMPLES = 4;
+
+class ModPlayer : public MusicSource
+{
+public:
+    ModPlayer();
+
+    // Returns false when data isn't a 4-channel module ("M.K." and the like). A module
+    // that doesn't loop ends after its last pattern.
+    bool load(const uint8_t *data, size_t size, int rate, bool isLooping);
+    bool loadFile(const char *path, int rate, bool isLooping);
+
+    int render(int16_t *output, int frames) override;
+
+    bool hasEnded() const { return isEnded; }
+
+    // Mixes with the plain loops instead of SIMD, to check one against the other.
+    void setScalarMixing(bool isScalar) { isScalarMixing = isScalar; }
+
+private:
+    void startRow();
+    void startNote(ModChannel &channel, const uint8_t *note);
+    void updateTick();
+    void updateEffect(ModChannel &channel);
+    void mixChannel(ModChannel &channel, int16_t *output, int frames);
+
+    std::vector<ModSample> samples;
+    std::vector<uint8_t> patterns;
+    int orders[128];
+    int songLength;
+    int restartOrder;
+
+    ModChannel channels[MOD_CHANNELS];
+
+    int rate;
+    bool isLooping;
+    bool isEnded;
+    bool isScalarMixing;
+
+    int speed;
+    int tempo;
+    int tick;
+    int order;
+    int row;
+
+    // Where the next row is, when an effect of this row jumps.
+    int nextOrder;
+    int nextRow;
+
+    int tickFramesLeft;
+    int tickRemainder;
+
+    // Each side mixed on its own, then interleaved.
+    std::vector<int16_t> left;
+    std::vector<int16_t> right;
+};
+
+// output[i] = saturate(output[i] + the sample at position + i * step, scaled by volume out
+// of 64 and by a quarter), for count frames. position is in samples and fraction and step
+// are 16.16.
+void resampleAdd(const int8_t *data, int position, uint32_t fraction, uint32_t step, int volume, int16_t *output, int count);
+void resampleAddScalar(const int8_t *data, int position, uint32_t fraction, uint32_t step, int volume, int16_t *output, int count);
+
+// Interleaves the two sides into stereo frames at twice the level, saturating.
+void interleaveStereo(const int16_t *left, const int16_t *right, int16_t *output, int count);
+void interleaveStereoScalar(const int16_t *left, const int16_t *right, int16_t *output, int count);
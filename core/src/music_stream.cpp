@@ -0,0 +1,216 @@
+#include "music_stream.h"
+#include "mixer.h"
+
+// Frames decoded per read, from the file and into the ring.
+const int MUSIC_BLOCK_FRAMES = 1024;
+
+WavMusic::WavMusic() : file(nullptr), isLooping(false), isEnded(true), dataRead(0), blockFrames(0), blockPosition(0), step(0), fraction(0),
+      hasNext(false)
+{
+}
+
+WavMusic::~WavMusic()
+{
+    close();
+}
+
+bool WavMusic::open(const char *path, int rate, bool isLooping)
+{
+    close();
+
+    file = fopen(path, "rb");
+
+    if (file == nullptr)
+    {
+        printf("Unable to open %s!\n", path);
+        return false;
+    }
+
+    if (!readWavFormat(file, format) || fseek(file, format.dataOffset, SEEK_SET) != 0)
+    {
+        printf("%s isn't a WAV file this can read!\n", path);
+        close();
+        return false;
+    }
+
+    this->isLooping = isLooping;
+    isEnded = false;
+    dataRead = 0;
+
+    blockBytes.resize((size_t)MUSIC_BLOCK_FRAMES * format.channels * (format.bits / 8));
+    blockSamples.resize((size_t)MUSIC_BLOCK_FRAMES * format.channels);
+    blockFrames = 0;
+    blockPosition = 0;
+
+    step = (uint32_t)(((uint64_t)format.rate << 16) / rate);
+    fraction = 0;
+
+    if (!readFrame(current))
+    {
+        close();
+        return false;
+    }
+
+    hasNext = readFrame(next);
+
+    if (!hasNext)
+    {
+        next[0] = current[0];
+        next[1] = current[1];
+    }
+
+    return true;
+}
+
+void WavMusic::close()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+
+    isEnded = true;
+}
+
+bool WavMusic::readFrame(int16_t *frame)
+{
+    if (blockPosition == blockFrames)
+    {
+        if (isEnded)
+        {
+            return false;
+        }
+
+        if (dataRead == format.dataSize && isLooping)
+        {
+            fseek(file, format.dataOffset, SEEK_SET);
+            dataRead = 0;
+        }
+
+        int frameBytes = format.channels * (format.bits / 8);
+        long wanted = format.dataSize - dataRead < (long)blockBytes.size() ? format.dataSize - dataRead : (long)blockBytes.size();
+
+        blockFrames = (int)(fread(blockBytes.data(), 1, wanted, file) / frameBytes);
+        blockPosition = 0;
+        dataRead += (long)blockFrames * frameBytes;
+
+        // The file is shorter than its header says, so that is where it ends.
+        if (blockFrames * frameBytes < wanted)
+        {
+            dataRead = format.dataSize;
+        }
+
+        if (blockFrames == 0)
+        {
+            isEnded = !isLooping || dataRead == 0;
+            return false;
+        }
+
+        decodeWavSamples(blockBytes.data(), format, blockSamples.data(), blockFrames * format.channels);
+    }
+
+    const int16_t *samples = &blockSamples[(size_t)blockPosition * format.channels];
+    blockPosition++;
+
+    frame[0] = samples[0];
+    frame[1] = samples[format.channels > 1 ? 1 : 0];
+
+    return true;
+}
+
+int WavMusic::render(int16_t *output, int frames)
+{
+    if (file == nullptr)
+    {
+        return 0;
+    }
+
+    int rendered = 0;
+
+    for (; rendered < frames; rendered++)
+    {
+        output[rendered * 2] = (int16_t)(current[0] + (((next[0] - current[0]) * (int)fraction) >> 16));
+        output[rendered * 2 + 1] = (int16_t)(current[1] + (((next[1] - current[1]) * (int)fraction) >> 16));
+
+        fraction += step;
+
+        while (fraction >= 0x10000)
+        {
+            fraction -= 0x10000;
+
+            if (!hasNext)
+            {
+                close();
+                return rendered + 1;
+            }
+
+            current[0] = next[0];
+            current[1] = next[1];
+
+            // A second read goes on from the start of a looping track whose file ended
+            // before its header said. Failing twice is the end of the track, and the last
+            // frame plays out with next left the same as it.
+            hasNext = readFrame(next) || readFrame(next);
+        }
+    }
+
+    return rendered;
+}
+
+MusicStream::MusicStream(int ringFrames)
+    : ring(ringFrames, MIXER_CHANNELS), block(MUSIC_BLOCK_FRAMES * MIXER_CHANNELS), scratch((size_t)ringFrames * MIXER_CHANNELS), isEnded(false), underruns(0),
+      missingFrames(0)
+{
+}
+
+int MusicStream::fill(MusicSource &source)
+{
+    int added = 0;
+
+    while (!isEnded.load(std::memory_order_relaxed))
+    {
+        int space = ring.capacity() - ring.available();
+        int frames = space < MUSIC_BLOCK_FRAMES ? space : MUSIC_BLOCK_FRAMES;
+
+        if (frames == 0)
+        {
+            break;
+        }
+
+        int rendered = source.render(block.data(), frames);
+
+        added += ring.write(block.data(), rendered);
+
+        if (rendered < frames)
+        {
+            isEnded.store(true, std::memory_order_release);
+        }
+    }
+
+    return added;
+}
+
+void MusicStream::mix(int16_t *output, int frames, int volume)
+{
+    // Read before the ring, so frames written just before the track ended aren't missed.
+    bool wasEnded = isEnded.load(std::memory_order_acquire);
+    int missing = 0;
+
+    for (int done = 0; done < frames;)
+    {
+        int wanted = frames - done < (int)scratch.size() / MIXER_CHANNELS ? frames - done : (int)scratch.size() / MIXER_CHANNELS;
+        int count = ring.read(scratch.data(), wanted);
+
+        addSaturating(output + (size_t)done * MIXER_CHANNELS, scratch.data(), count * MIXER_CHANNELS, volume);
+
+        done += wanted;
+        missing += wanted - count;
+    }
+
+    if (missing > 0 && !wasEnded)
+    {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        missingFrames.fetch_add(missing, std::memory_order_relaxed);
+    }
+}
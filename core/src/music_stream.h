@@ -0,0 +1,94 @@
+#pragma once
+
+#include "pcm.h"
+#include "pcm_ring.h"
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Background music is decoded ahead into a fixed-size ring by a thread of the port's,
+// and the audio callback only copies out of the ring. However long the track, memory
+// doesn't grow, and neither the game thread nor the callback decodes anything. When the
+// decoder falls behind, the callback plays silence for what's missing and counts an
+// underrun.
+
+// Music rendered as 16-bit stereo at the mixer's rate.
+class MusicSource
+{
+public:
+    virtual ~MusicSource() {}
+
+    // Renders up to frames frames into output and returns how many. Fewer only at the end
+    // of a track that doesn't loop.
+    virtual int render(int16_t *output, int frames) = 0;
+};
+
+// Streams a WAV from disk a block at a time, resampling it on the way with linear
+// interpolation. Only the block is ever in memory.
+class WavMusic : public MusicSource
+{
+public:
+    WavMusic();
+    ~WavMusic();
+
+    // Returns false when path isn't a WAV parseWav() could read.
+    bool open(const char *path, int rate, bool isLooping);
+    void close();
+
+    int render(int16_t *output, int frames) override;
+
+private:
+    // The next source frame as stereo, false at the end.
+    bool readFrame(int16_t *frame);
+
+    FILE *file;
+    WavFormat format;
+    bool isLooping;
+    bool isEnded;
+    long dataRead;
+
+    std::vector<uint8_t> blockBytes;
+    std::vector<int16_t> blockSamples;
+    int blockFrames;
+    int blockPosition;
+
+    // Source frames per output frame and the position between current and next, 16.16.
+    uint32_t step;
+    uint32_t fraction;
+    int16_t current[2];
+    int16_t next[2];
+    bool hasNext;
+};
+
+class MusicStream
+{
+public:
+    // The decoder can fall behind by up to ringFrames before the callback runs dry.
+    explicit MusicStream(int ringFrames);
+
+    // Decode thread: renders into the ring until it's full and returns the frames added.
+    int fill(MusicSource &source);
+
+    // Audio callback: adds frames of music to output at volume (MIXER_FULL_VOLUME is
+    // unchanged) with saturating adds.
+    void mix(int16_t *output, int frames, int volume);
+
+    // Callbacks that found the ring short, and the frames they played as silence. A
+    // track that ended doesn't count.
+    long long underrunCount() const { return underruns.load(std::memory_order_relaxed); }
+    long long missingFrameCount() const { return missingFrames.load(std::memory_order_relaxed); }
+
+    bool hasEnded() const { return isEnded.load(std::memory_order_acquire); }
+
+private:
+    PcmRing ring;
+
+    // Owned by the decode thread and the callback respectively.
+    std::vector<int16_t> block;
+    std::vector<int16_t> scratch;
+
+    std::atomic<bool> isEnded;
+    std::atomic<long long> underruns;
+    std::atomic<long long> missingFrames;
+};
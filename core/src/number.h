@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+// Q16.16 fixed-point number: 16 integer bits, 16 fraction bits. Every operation is
+// plain integer math, so it is bit-exact on every compiler and target and needs no
+// FPU, which is what the NDS's ARM946E-S lacks.
+class Fixed
+{
+public:
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    Fixed() : raw(0) {}
+    Fixed(int value) : raw((int32_t)((uint32_t)value << FRACTION_BITS)) {}
+    Fixed(float value) : raw((int32_t)(value >= 0 ? value * ONE + 0.5f : value * ONE - 0.5f)) {}
+    Fixed(double value) : raw((int32_t)(value >= 0 ? value * ONE + 0.5 : value * ONE - 0.5)) {}
+
+    static Fixed fromRaw(int32_t raw)
+    {
+        Fixed fixed;
+        fixed.raw = raw;
+
+        return fixed;
+    }
+
+    int32_t toRaw() const { return raw; }
+
+    // Rounds towards minus infinity.
+    explicit operator int() const { return raw >> FRACTION_BITS; }
+    explicit operator float() const { return raw / (float)ONE; }
+    explicit operator double() const { return raw / (double)ONE; }
+
+    Fixed operator-() const { return fromRaw(-raw); }
+
+    Fixed &operator+=(Fixed other)
+    {
+        raw += other.raw;
+        return *this;
+    }
+
+    Fixed &operator-=(Fixed other)
+    {
+        raw -= other.raw;
+        return *this;
+    }
+
+    Fixed &operator*=(Fixed other)
+    {
+        raw = (int32_t)(((int64_t)raw * other.raw) >> FRACTION_BITS);
+        return *this;
+    }
+
+    // The quotient must fit in Q16.16; callers keep |a| below |b| * 32768.
+    Fixed &operator/=(Fixed other)
+    {
+        raw = (int32_t)(((int64_t)raw * ONE) / other.raw);
+        return *this;
+    }
+
+    friend Fixed operator+(Fixed a, Fixed b) { return a += b; }
+    friend Fixed operator-(Fixed a, Fixed b) { return a -= b; }
+    friend Fixed operator*(Fixed a, Fixed b) { return a *= b; }
+    friend Fixed operator/(Fixed a, Fixed b) { return a /= b; }
+
+    friend bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+    friend bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+    friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+
+private:
+    int32_t raw;
+};
+
+// The number type of all positions, sizes, speeds and time steps in the core.
+// Build with BREAKOUT_FIXED_POINT on targets without an FPU.
+#if defined(BREAKOUT_FIXED_POINT)
+typedef Fixed Number;
+#else
+typedef float Number;
+#endif
@@ -0,0 +1,232 @@
+#include "particles.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PARTICLES_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PARTICLES_SSE2
+#endif
+
+#if defined(PARTICLES_AVX2)
+const int LANE_COUNT = 8;
+#elif defined(PARTICLES_SSE2)
+const int LANE_COUNT = 4;
+#else
+const int LANE_COUNT = 1;
+#endif
+
+static unsigned int nextRandom(unsigned int &state)
+{
+    // xorshift32, state must never be 0.
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+// In [-1, 1].
+static float randomSigned(unsigned int &state)
+{
+    return (float)(nextRandom(state) >> 8) / (float)(1 << 23) - 1.0f;
+}
+
+void initParticlePool(ParticlePool &pool, int capacity, unsigned int seed)
+{
+    // The SIMD loop runs in whole lanes, so the arrays have room for the last partial one.
+    int paddedCapacity = (capacity + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+
+    pool.capacity = capacity;
+    pool.count = 0;
+
+    pool.x.assign(paddedCapacity, 0);
+    pool.y.assign(paddedCapacity, 0);
+    pool.velocityX.assign(paddedCapacity, 0);
+    pool.velocityY.assign(paddedCapacity, 0);
+    pool.life.assign(paddedCapacity, 0);
+    pool.color.assign(paddedCapacity, 0);
+
+    pool.randomState = seed * 2654435761u + 1;
+}
+
+int emitParticleBurst(ParticlePool &pool, const Bounds &area, int count, uint32_t color, float speed, float life)
+{
+    float centerX = (float)area.x + (float)area.w / 2;
+    float centerY = (float)area.y + (float)area.h / 2;
+
+    int emitted = 0;
+
+    for (; emitted < count && pool.count < pool.capacity; emitted++)
+    {
+        int i = pool.count++;
+
+        pool.x[i] = centerX + randomSigned(pool.randomState) * (float)area.w / 2;
+        pool.y[i] = centerY + randomSigned(pool.randomState) * (float)area.h / 2;
+
+        // Away from the center, faster the further out the particle starts.
+        pool.velocityX[i] = (pool.x[i] - centerX) / ((float)area.w / 2 + 1) * speed + randomSigned(pool.randomState) * speed / 4;
+        pool.velocityY[i] = (pool.y[i] - centerY) / ((float)area.h / 2 + 1) * speed + randomSigned(pool.randomState) * speed / 4;
+
+        pool.life[i] = life * (0.75f + randomSigned(pool.randomState) / 4);
+        pool.color[i] = color;
+    }
+
+    return emitted;
+}
+
+static void removeDeadParticles(ParticlePool &pool)
+{
+    int i = 0;
+
+    while (i < pool.count)
+    {
+        if (pool.life[i] > 0)
+        {
+            i++;
+            continue;
+        }
+
+        // Swap-remove: the last particle takes the dead one's place and is checked next.
+        int last = --pool.count;
+
+        pool.x[i] = pool.x[last];
+        pool.y[i] = pool.y[last];
+        pool.velocityX[i] = pool.velocityX[last];
+        pool.velocityY[i] = pool.velocityY[last];
+        pool.life[i] = pool.life[last];
+        pool.color[i] = pool.color[last];
+    }
+}
+
+void updateParticlesScalar(ParticlePool &pool, float deltaTime, float gravity)
+{
+    float gravityStep = gravity * deltaTime;
+
+    for (int i = 0; i < pool.count; i++)
+    {
+        pool.velocityY[i] += gravityStep;
+        pool.x[i] += pool.velocityX[i] * deltaTime;
+        pool.y[i] += pool.velocityY[i] * deltaTime;
+        pool.life[i] -= deltaTime;
+    }
+
+    removeDeadParticles(pool);
+}
+
+#if defined(PARTICLES_AVX2)
+
+void updateParticles(ParticlePool &pool, float deltaTime, float gravity)
+{
+    __m256 step = _mm256_set1_ps(deltaTime);
+    __m256 gravityStep = _mm256_set1_ps(gravity * deltaTime);
+
+    for (int i = 0; i < pool.count; i += LANE_COUNT)
+    {
+        __m256 velocityY = _mm256_add_ps(_mm256_loadu_ps(&pool.velocityY[i]), gravityStep);
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(&pool.x[i]), _mm256_mul_ps(_mm256_loadu_ps(&pool.velocityX[i]), step));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(&pool.y[i]), _mm256_mul_ps(velocityY, step));
+        __m256 life = _mm256_sub_ps(_mm256_loadu_ps(&pool.life[i]), step);
+
+        _mm256_storeu_ps(&pool.velocityY[i], velocityY);
+        _mm256_storeu_ps(&pool.x[i], x);
+        _mm256_storeu_ps(&pool.y[i], y);
+        _mm256_storeu_ps(&pool.life[i], life);
+    }
+
+    removeDeadParticles(pool);
+}
+
+#elif defined(PARTICLES_SSE2)
+
+void updateParticles(ParticlePool &pool, float deltaTime, float gravity)
+{
+    __m128 step = _mm_set1_ps(deltaTime);
+    __m128 gravityStep = _mm_set1_ps(gravity * deltaTime);
+
+    for (int i = 0; i < pool.count; i += LANE_COUNT)
+    {
+        __m128 velocityY = _mm_add_ps(_mm_loadu_ps(&pool.velocityY[i]), gravityStep);
+        __m128 x = _mm_add_ps(_mm_loadu_ps(&pool.x[i]), _mm_mul_ps(_mm_loadu_ps(&pool.velocityX[i]), step));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(&pool.y[i]), _mm_mul_ps(velocityY, step));
+        __m128 life = _mm_sub_ps(_mm_loadu_ps(&pool.life[i]), step);
+
+        _mm_storeu_ps(&pool.velocityY[i], velocityY);
+        _mm_storeu_ps(&pool.x[i], x);
+        _mm_storeu_ps(&pool.y[i], y);
+        _mm_storeu_ps(&pool.life[i], life);
+    }
+
+    removeDeadParticles(pool);
+}
+
+#else
+
+void updateParticles(ParticlePool &pool, float deltaTime, float gravity)
+{
+    updateParticlesScalar(pool, deltaTime, gravity);
+}
+
+#endif
+
+int writeParticleVertices(const ParticlePool &pool, float size, float *xy, uint8_t *rgba)
+{
+    for (int i = 0; i < pool.count; i++)
+    {
+        float left = pool.x[i];
+        float top = pool.y[i];
+        float right = left + size;
+        float bottom = top + size;
+
+        xy[0] = left;
+        xy[1] = top;
+        xy[2] = right;
+        xy[3] = top;
+        xy[4] = right;
+        xy[5] = bottom;
+        xy[6] = left;
+        xy[7] = bottom;
+        xy += 8;
+
+        uint32_t color = pool.color[i];
+        float fade = pool.life[i] < PARTICLE_FADE_SECONDS ? pool.life[i] / PARTICLE_FADE_SECONDS : 1.0f;
+
+        uint8_t corner[4] = {
+            (uint8_t)(color >> 16),
+            (uint8_t)(color >> 8),
+            (uint8_t)color,
+            (uint8_t)((color >> 24) * fade),
+        };
+
+        // The same color on all four corners, a word at a time.
+        uint32_t cornerBytes;
+        memcpy(&cornerBytes, corner, 4);
+
+        for (int vertex = 0; vertex < 4; vertex++)
+        {
+            memcpy(rgba, &cornerBytes, 4);
+            rgba += 4;
+        }
+    }
+
+    return pool.count * 4;
+}
+
+void makeParticleIndices(std::vector<int> &indices, int particleCount)
+{
+    indices.resize(particleCount * 6);
+
+    for (int i = 0; i < particleCount; i++)
+    {
+        int *triangles = &indices[i * 6];
+        int first = i * 4;
+
+        triangles[0] = first;
+        triangles[1] = first + 1;
+        triangles[2] = first + 2;
+        triangles[3] = first;
+        triangles[4] = first + 2;
+        triangles[5] = first + 3;
+    }
+}
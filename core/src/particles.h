@@ -0,0 +1,52 @@
+#pragma once
+
+#include "game.h"
+#include <stdint.h>
+#include <vector>
+
+// A fixed number of short-lived colored squares, e.g. the bursts of a destroyed brick.
+// Structure-of-arrays so updateParticles() moves several particles per SIMD instruction;
+// the live particles are always [0, count) and a dead one is replaced by the last one.
+// Particles are only for show, so they are plain floats in fixed-point builds too.
+typedef struct
+{
+    int capacity;
+    int count;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+
+    // Seconds left to live.
+    std::vector<float> life;
+
+    // 0xAARRGGBB.
+    std::vector<uint32_t> color;
+
+    unsigned int randomState;
+} ParticlePool;
+
+// Particles fade out over their last PARTICLE_FADE_SECONDS.
+const float PARTICLE_FADE_SECONDS = 0.25f;
+
+// Allocates everything the pool will ever use; nothing after this allocates.
+void initParticlePool(ParticlePool &pool, int capacity, unsigned int seed);
+
+// Adds up to count particles spread over area, flying out from its center at up to speed
+// pixels per second and living between half and all of life seconds. Returns how many
+// fit in the pool.
+int emitParticleBurst(ParticlePool &pool, const Bounds &area, int count, uint32_t color, float speed, float life);
+
+// Moves every particle with gravity in pixels per second squared, then removes the dead
+// ones. updateParticlesScalar() is the same without SIMD, for the bench to check against.
+void updateParticles(ParticlePool &pool, float deltaTime, float gravity);
+void updateParticlesScalar(ParticlePool &pool, float deltaTime, float gravity);
+
+// Writes four corners per live particle for an indexed triangle list, each particle a
+// square of size pixels: xy gets 8 floats and rgba 16 bytes (R, G, B, A, e.g. SDL_Color)
+// per particle. Returns the number of vertices.
+int writeParticleVertices(const ParticlePool &pool, float size, float *xy, uint8_t *rgba);
+
+// The two triangles of every particle's square, for particleCount particles.
+void makeParticleIndices(std::vector<int> &indices, int particleCount);
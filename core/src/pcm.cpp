@@ -0,0 +1,279 @@
+#include "pcm.h"
+#include <cstdio>
+#include <cstring>
+
+static uint32_t readLittle32(const uint8_t *bytes)
+{
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint16_t readLittle16(const uint8_t *bytes)
+{
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static int16_t readSample(const uint8_t *bytes, int bits, bool isFloat)
+{
+    if (isFloat)
+    {
+        uint32_t raw = readLittle32(bytes);
+        float value;
+        memcpy(&value, &raw, sizeof(value));
+
+        value = value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value);
+        return (int16_t)(value * 32767.0f);
+    }
+
+    switch (bits)
+    {
+    case 8:
+        return (int16_t)((bytes[0] - 128) << 8);
+    case 16:
+        return (int16_t)readLittle16(bytes);
+    case 24:
+        return (int16_t)readLittle16(bytes + 1);
+    default:
+        return (int16_t)readLittle16(bytes + 2);
+    }
+}
+
+// Fills in the fields of format that the fmt chunk holds. Returns false for a format
+// this doesn't read.
+static bool readFormatChunk(const uint8_t *body, size_t size, WavFormat &format)
+{
+    if (size < 16)
+    {
+        return false;
+    }
+
+    int tag = readLittle16(body);
+
+    // WAVE_FORMAT_EXTENSIBLE keeps the real format in the first two bytes of the GUID.
+    if (tag == 0xfffe && size >= 26)
+    {
+        tag = readLittle16(body + 24);
+    }
+
+    format.channels = readLittle16(body + 2);
+    format.rate = (int)readLittle32(body + 4);
+    format.bits = readLittle16(body + 14);
+    format.isFloat = tag == 3 && format.bits == 32;
+
+    bool isInteger = tag == 1 && (format.bits == 8 || format.bits == 16 || format.bits == 24 || format.bits == 32);
+
+    return (format.isFloat || isInteger) && format.channels > 0 && format.rate > 0;
+}
+
+void decodeWavSamples(const uint8_t *bytes, const WavFormat &format, int16_t *samples, int count)
+{
+    int sampleBytes = format.bits / 8;
+
+    for (int i = 0; i < count; i++)
+    {
+        samples[i] = readSample(bytes + (size_t)i * sampleBytes, format.bits, format.isFloat);
+    }
+}
+
+bool parseWav(const uint8_t *data, size_t size, PcmSound &sound)
+{
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+    {
+        return false;
+    }
+
+    WavFormat format = {};
+    bool hasFormat = false;
+
+    size_t offset = 12;
+
+    while (offset + 8 <= size)
+    {
+        const uint8_t *chunk = data + offset;
+        size_t chunkSize = readLittle32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+
+        if (chunkSize > size - offset - 8)
+        {
+            chunkSize = size - offset - 8;
+        }
+
+        if (memcmp(chunk, "fmt ", 4) == 0)
+        {
+            hasFormat = readFormatChunk(body, chunkSize, format);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            if (!hasFormat)
+            {
+                return false;
+            }
+
+            size_t sampleCount = chunkSize / (format.bits / 8) / format.channels * format.channels;
+
+            sound.rate = format.rate;
+            sound.channels = format.channels;
+            sound.samples.resize(sampleCount);
+
+            decodeWavSamples(body, format, sound.samples.data(), (int)sampleCount);
+
+            return true;
+        }
+
+        // Chunks are padded to an even size.
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return false;
+}
+
+bool readWavFormat(FILE *file, WavFormat &format)
+{
+    uint8_t header[12];
+
+    if (fseek(file, 0, SEEK_SET) != 0 || fread(header, 1, 12, file) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+    {
+        return false;
+    }
+
+    bool hasFormat = false;
+    uint8_t chunk[8];
+
+    while (fread(chunk, 1, 8, file) == 8)
+    {
+        long chunkSize = (long)readLittle32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0)
+        {
+            uint8_t body[40] = {};
+            size_t bodySize = chunkSize < (long)sizeof(body) ? (size_t)chunkSize : sizeof(body);
+
+            if (fread(body, 1, bodySize, file) != bodySize)
+            {
+                return false;
+            }
+
+            hasFormat = readFormatChunk(body, bodySize, format);
+            chunkSize -= (long)bodySize;
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            if (!hasFormat)
+            {
+                return false;
+            }
+
+            format.dataOffset = ftell(file);
+            format.dataSize = chunkSize / (format.bits / 8) / format.channels * (format.bits / 8) * format.channels;
+
+            return true;
+        }
+
+        if (fseek(file, chunkSize + (chunkSize & 1), SEEK_CUR) != 0)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool loadWavFile(const char *path, PcmSound &sound)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr)
+    {
+        printf("Unable to open %s!\n", path);
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[16384];
+    size_t count;
+
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+
+    fclose(file);
+
+    if (!parseWav(data.data(), data.size(), sound))
+    {
+        printf("%s isn't a WAV file this can read!\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+void convertPcm(const PcmSound &source, int rate, int channels, PcmSound &converted)
+{
+    int sourceFrames = pcmFrameCount(source);
+
+    converted.rate = rate;
+    converted.channels = channels;
+    converted.samples.clear();
+
+    if (sourceFrames == 0 || rate <= 0 || channels <= 0)
+    {
+        return;
+    }
+
+    // Mixed down to the output channels first: mono is the average, stereo keeps the
+    // first two channels and a mono source goes to both.
+    std::vector<int16_t> mapped(sourceFrames * channels);
+
+    for (int frame = 0; frame < sourceFrames; frame++)
+    {
+        const int16_t *in = &source.samples[frame * source.channels];
+
+        if (channels == 1)
+        {
+            int sum = 0;
+
+            for (int channel = 0; channel < source.channels; channel++)
+            {
+                sum += in[channel];
+            }
+
+            mapped[frame] = (int16_t)(sum / source.channels);
+        }
+        else
+        {
+            for (int channel = 0; channel < channels; channel++)
+            {
+                mapped[frame * channels + channel] = in[channel < source.channels ? channel : source.channels - 1];
+            }
+        }
+    }
+
+    if (rate == source.rate)
+    {
+        converted.samples.swap(mapped);
+        return;
+    }
+
+    // Steps through the source in 32.32 fixed point, so long sounds don't drift.
+    uint64_t step = ((uint64_t)source.rate << 32) / rate;
+    int frames = (int)(((uint64_t)sourceFrames * rate + source.rate - 1) / source.rate);
+
+    converted.samples.resize(frames * channels);
+
+    uint64_t position = 0;
+
+    for (int frame = 0; frame < frames; frame++, position += step)
+    {
+        int index = (int)(position >> 32);
+        int next = index + 1 < sourceFrames ? index + 1 : sourceFrames - 1;
+        int fraction = (int)((position >> 16) & 0xffff);
+
+        for (int channel = 0; channel < channels; channel++)
+        {
+            int a = mapped[index * channels + channel];
+            int b = mapped[next * channels + channel];
+
+            converted.samples[frame * channels + channel] = (int16_t)(a + (((b - a) * fraction) >> 16));
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+// Signed 16-bit samples, interleaved when there is more than one channel.
+typedef struct
+{
+    int rate;
+    int channels;
+    std::vector<int16_t> samples;
+} PcmSound;
+
+inline int pcmFrameCount(const PcmSound &sound)
+{
+    return sound.channels > 0 ? (int)sound.samples.size() / sound.channels : 0;
+}
+
+// Reads an uncompressed WAV (8, 16, 24 or 32-bit integer PCM, or 32-bit float) of any
+// rate and channel count into sound as 16-bit. Returns false for anything else.
+bool parseWav(const uint8_t *data, size_t size, PcmSound &sound);
+
+bool loadWavFile(const char *path, PcmSound &sound);
+
+// How a WAV file stores its samples and where they are, for streaming it a block at a
+// time instead of loading it whole.
+typedef struct
+{
+    int rate;
+    int channels;
+    int bits;
+    bool isFloat;
+    long dataOffset;
+    long dataSize;
+} WavFormat;
+
+// Reads the chunk headers of the WAV file from its start. Returns false for anything
+// parseWav() wouldn't read.
+bool readWavFormat(FILE *file, WavFormat &format);
+
+// Converts count samples stored as format says to 16-bit.
+void decodeWavSamples(const uint8_t *bytes, const WavFormat &format, int16_t *samples, int count);
+
+// Resamples source to rate with linear interpolation and maps it to 1 or 2 channels,
+// so a sound can be converted to the device's format once when it is loaded.
+void convertPcm(const PcmSound &source, int rate, int channels, PcmSound &converted);
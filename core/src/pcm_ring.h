@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// A fixed-size ring of interleaved 16-bit frames between one writer thread, e.g. a music
+// decoder, and one reader, the audio callback. Like SpscQueue each side only writes its
+// own count, so neither locks or waits: write() and read() move as many frames as fit or
+// are there and return how many. Header only.
+class PcmRing
+{
+public:
+    // capacityFrames is rounded up to a power of two.
+    PcmRing(int capacityFrames, int channels) : channels(channels), written(0), readFrames(0)
+    {
+        int size = 1;
+
+        while (size < capacityFrames)
+        {
+            size *= 2;
+        }
+
+        samples.resize((size_t)size * channels);
+        mask = (unsigned int)size - 1;
+    }
+
+    int capacity() const { return (int)mask + 1; }
+
+    // Frames waiting to be read; the writer sees at most this many, the reader at least.
+    int available() const { return (int)(written.load(std::memory_order_acquire) - readFrames.load(std::memory_order_acquire)); }
+
+    // Writer only.
+    int write(const int16_t *frames, int count)
+    {
+        unsigned int end = written.load(std::memory_order_relaxed);
+        int space = capacity() - (int)(end - readFrames.load(std::memory_order_acquire));
+
+        count = count < space ? count : space;
+        copyIn(frames, end, count);
+        written.store(end + count, std::memory_order_release);
+
+        return count;
+    }
+
+    // Reader only.
+    int read(int16_t *frames, int count)
+    {
+        unsigned int start = readFrames.load(std::memory_order_relaxed);
+        int waiting = (int)(written.load(std::memory_order_acquire) - start);
+
+        count = count < waiting ? count : waiting;
+        copyOut(frames, start, count);
+        readFrames.store(start + count, std::memory_order_release);
+
+        return count;
+    }
+
+private:
+    // A run of count frames from position can wrap around the end, so it is copied in at
+    // most two parts.
+    int firstRun(unsigned int position, int count) const
+    {
+        int space = capacity() - (int)(position & mask);
+
+        return count < space ? count : space;
+    }
+
+    void copyIn(const int16_t *frames, unsigned int position, int count)
+    {
+        int run = firstRun(position, count);
+
+        memcpy(&samples[(size_t)(position & mask) * channels], frames, (size_t)run * channels * sizeof(int16_t));
+        memcpy(samples.data(), frames + (size_t)run * channels, (size_t)(count - run) * channels * sizeof(int16_t));
+    }
+
+    void copyOut(int16_t *frames, unsigned int position, int count) const
+    {
+        int run = firstRun(position, count);
+
+        memcpy(frames, &samples[(size_t)(position & mask) * channels], (size_t)run * channels * sizeof(int16_t));
+        memcpy(frames + (size_t)run * channels, samples.data(), (size_t)(count - run) * channels * sizeof(int16_t));
+    }
+
+    int channels;
+    std::vector<int16_t> samples;
+    unsigned int mask;
+
+    std::atomic<unsigned int> written;
+    std::atomic<unsigned int> readFrames;
+};
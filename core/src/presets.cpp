@@ -0,0 +1,99 @@
+#include "presets.h"
+#include <string.h>
+
+// 8*15 Bricks
+const GameConfig PC_CONFIG = {
+    960, 544,
+    {960 / 2, 544 - 32, 74, 16},
+    {960 / 2 - 20, 544 / 2 - 20, 20, 20},
+    800, 425, 425,
+    2,
+    8, 15, 60, 20, 0, 40, 64, 22, 8,
+};
+
+// 8*14 Bricks
+const GameConfig PSP_CONFIG = {
+    480, 272,
+    {480 / 2, 272 - 16, 36, 8},
+    {480 / 2 - 8, 272 / 2 - 8, 8, 8},
+    400, 225, 225,
+    2,
+    8, 14, 32, 8, 2, 20, 34, 10, 8,
+};
+
+const GameConfig VITA_CONFIG = PC_CONFIG;
+
+// 10*20 Bricks
+const GameConfig SWITCH_CONFIG = {
+    1280, 720,
+    {1280 / 2, 720 - 32, 74, 16},
+    {1280 / 2 - 20, 720 / 2 - 20, 20, 20},
+    800, 425, 425,
+    2,
+    10, 20, 60, 20, 0, 50, 64, 22, 10,
+};
+
+const GameConfig WII_U_CONFIG = SWITCH_CONFIG;
+
+// 8*15 Bricks, speeds are per frame
+const GameConfig WII_CONFIG = {
+    640, 480,
+    {640 / 2, 480 - 16, 42, 16},
+    {640 / 2 - 16, 480 / 2 - 16, 16, 16},
+    6, 4, 4,
+    2,
+    8, 15, 41, 16, 0, 50, 43, 18, 8,
+};
+
+const GameConfig GC_CONFIG = WII_CONFIG;
+
+// 7*7 Bricks on the 256x192 bottom screen, speeds are per frame
+const GameConfig NDS_CONFIG = {
+    256, 192,
+    {256 / 2, 192 - 16, 35, 8},
+    {256 / 2, 192 / 2, 8, 8},
+    5, 2, 2,
+    2,
+    7, 7, 35, 8, 0, 20, 37, 10, 10,
+};
+
+// 10*7 Bricks on the 320x240 bottom screen, speeds are per frame
+const GameConfig N3DS_CONFIG = {
+    320, 240,
+    {320 / 2, 240 - 16, 40, 8},
+    {320 / 2, 240 / 2, 10, 10},
+    10, 5, 5,
+    2,
+    10, 7, 41, 8, 0, 20, 43, 10, 10,
+};
+
+const GameConfig *findPreset(const char *name)
+{
+    typedef struct
+    {
+        const char *name;
+        const GameConfig *config;
+    } Preset;
+
+    const Preset presets[] = {
+        {"pc", &PC_CONFIG},
+        {"psp", &PSP_CONFIG},
+        {"vita", &VITA_CONFIG},
+        {"switch", &SWITCH_CONFIG},
+        {"wii-u", &WII_U_CONFIG},
+        {"wii", &WII_CONFIG},
+        {"gc", &GC_CONFIG},
+        {"nds", &NDS_CONFIG},
+        {"3ds", &N3DS_CONFIG},
+    };
+
+    for (const Preset &preset : presets)
+    {
+        if (strcmp(preset.name, name) == 0)
+        {
+            return preset.config;
+        }
+    }
+
+    return nullptr;
+}
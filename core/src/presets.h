@@ -0,0 +1,18 @@
+#pragma once
+
+#include "game.h"
+
+// One preset per port, taken from the values each port used to hard-code in its main.cpp.
+extern const GameConfig PC_CONFIG;
+extern const GameConfig PSP_CONFIG;
+extern const GameConfig VITA_CONFIG;
+extern const GameConfig SWITCH_CONFIG;
+extern const GameConfig WII_U_CONFIG;
+extern const GameConfig WII_CONFIG;
+extern const GameConfig GC_CONFIG;
+extern const GameConfig NDS_CONFIG;
+extern const GameConfig N3DS_CONFIG;
+
+// Looks a preset up by port name ("pc", "psp", "vita", "switch", "wii-u", "wii", "gc", "nds", "3ds"),
+// returns nullptr for unknown names.
+const GameConfig *findPreset(const char *name);
@@ -0,0 +1,138 @@
+#include "render_list.h"
+#include <algorithm>
+#include <cstring>
+
+static uint64_t makeSortKey(int layer, int texture, uint32_t color)
+{
+    // Untextured commands (NO_TEXTURE) sort before every texture of their layer.
+    return ((uint64_t)(layer & 0xff) << 56) | ((uint64_t)((texture + 1) & 0xffffff) << 32) | color;
+}
+
+static RenderCommand makeCommand(int type, int layer, int texture, uint32_t color, const AtlasRect &destination)
+{
+    RenderCommand command;
+    command.sortKey = makeSortKey(layer, texture, color);
+    command.type = type;
+    command.layer = layer;
+    command.texture = texture;
+    command.color = color;
+    command.destination = destination;
+    command.source = destination;
+    command.atlas = nullptr;
+    command.textOffset = 0;
+
+    return command;
+}
+
+void clearRenderList(RenderList &list)
+{
+    list.commands.clear();
+    list.text.clear();
+}
+
+void addRenderRect(RenderList &list, int layer, const AtlasRect &destination, uint32_t color)
+{
+    list.commands.push_back(makeCommand(RENDER_COMMAND_RECT, layer, NO_TEXTURE, color, destination));
+}
+
+void addRenderImage(RenderList &list, int layer, int texture, const AtlasRect &source, const AtlasRect &destination, uint32_t color)
+{
+    RenderCommand command = makeCommand(RENDER_COMMAND_IMAGE, layer, texture, color, destination);
+    command.source = source;
+
+    list.commands.push_back(command);
+}
+
+void addRenderText(RenderList &list, int layer, int texture, const GlyphAtlas &atlas, const char *text, int x, int y, uint32_t color)
+{
+    AtlasRect position = {x, y, 0, 0};
+
+    RenderCommand command = makeCommand(RENDER_COMMAND_TEXT, layer, texture, color, position);
+    command.atlas = &atlas;
+    command.textOffset = (int)list.text.size();
+
+    list.text.insert(list.text.end(), text, text + strlen(text) + 1);
+    list.commands.push_back(command);
+}
+
+void sortRenderList(RenderList &list)
+{
+    std::stable_sort(list.commands.begin(), list.commands.end(),
+                     [](const RenderCommand &a, const RenderCommand &b) { return a.sortKey < b.sortKey; });
+}
+
+void submitRenderList(RenderList &list, RenderBackend &backend)
+{
+    int currentTexture = NO_TEXTURE;
+    uint32_t currentColor = 0;
+    bool isColorSet = false;
+
+    size_t first = 0;
+
+    while (first < list.commands.size())
+    {
+        const RenderCommand &command = list.commands[first];
+        bool isTextured = command.type != RENDER_COMMAND_RECT;
+
+        // A group is the run of commands after first with the same texture and color;
+        // images and text from the same texture go in one group of quads.
+        size_t last = first + 1;
+
+        while (last < list.commands.size() && list.commands[last].texture == command.texture && list.commands[last].color == command.color &&
+               (list.commands[last].type != RENDER_COMMAND_RECT) == isTextured)
+        {
+            last++;
+        }
+
+        if (command.texture != currentTexture)
+        {
+            backend.setTexture(command.texture);
+            currentTexture = command.texture;
+        }
+
+        if (!isColorSet || command.color != currentColor)
+        {
+            backend.setColor(command.color);
+            currentColor = command.color;
+            isColorSet = true;
+        }
+
+        if (isTextured)
+        {
+            list.quads.clear();
+
+            for (size_t i = first; i < last; i++)
+            {
+                const RenderCommand &quad = list.commands[i];
+
+                if (quad.type == RENDER_COMMAND_TEXT)
+                {
+                    layoutText(*quad.atlas, &list.text[quad.textOffset], quad.destination.x, quad.destination.y, list.quads);
+                }
+                else
+                {
+                    GlyphQuad image = {quad.source, quad.destination};
+                    list.quads.push_back(image);
+                }
+            }
+
+            if (!list.quads.empty())
+            {
+                backend.copyQuads(list.quads.data(), (int)list.quads.size());
+            }
+        }
+        else
+        {
+            list.rects.clear();
+
+            for (size_t i = first; i < last; i++)
+            {
+                list.rects.push_back(list.commands[i].destination);
+            }
+
+            backend.fillRects(list.rects.data(), (int)list.rects.size());
+        }
+
+        first = last;
+    }
+}
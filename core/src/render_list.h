@@ -0,0 +1,87 @@
+#pragma once
+
+#include "text.h"
+#include <stdint.h>
+#include <vector>
+
+// A frame's drawing recorded as data instead of renderer calls. The game adds rects,
+// texture copies and text to a RenderList, sortRenderList() groups the commands by layer,
+// texture and color, and submitRenderList() hands each group to a RenderBackend as one
+// state change and one draw call. Commands only keep their order across layers, so
+// anything that has to be drawn over something else goes on a higher layer.
+
+enum RenderCommandType
+{
+    RENDER_COMMAND_RECT,
+    RENDER_COMMAND_IMAGE,
+    RENDER_COMMAND_TEXT,
+};
+
+// Rects aren't textured. Texture ids are the backend's, e.g. an index into its textures.
+const int NO_TEXTURE = -1;
+
+const int MAX_RENDER_LAYERS = 256;
+
+typedef struct
+{
+    // layer, texture and color packed so one comparison orders two commands.
+    uint64_t sortKey;
+
+    int type;
+    int layer;
+    int texture;
+
+    // 0xAARRGGBB; textured commands are tinted by it.
+    uint32_t color;
+
+    AtlasRect destination;
+
+    // RENDER_COMMAND_IMAGE: the part of the texture to copy.
+    AtlasRect source;
+
+    // RENDER_COMMAND_TEXT: the glyphs, and where the text starts in the list's text arena.
+    // destination.x and destination.y are the top left of the text.
+    const GlyphAtlas *atlas;
+    int textOffset;
+} RenderCommand;
+
+// Every array only grows, so once the first frames have been recorded clearing and
+// recording again allocates nothing.
+typedef struct
+{
+    std::vector<RenderCommand> commands;
+
+    // The strings of the text commands, back to back with their terminators.
+    std::vector<char> text;
+
+    // Scratch for submitRenderList(): one group's rects or quads.
+    std::vector<AtlasRect> rects;
+    std::vector<GlyphQuad> quads;
+} RenderList;
+
+// What a port implements to draw a RenderList. setTexture() and setColor() are only
+// called when the value changes, fillRects() and copyQuads() once per group.
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {}
+
+    virtual void setTexture(int texture) = 0;
+    virtual void setColor(uint32_t color) = 0;
+    virtual void fillRects(const AtlasRect *rects, int count) = 0;
+    virtual void copyQuads(const GlyphQuad *quads, int count) = 0;
+};
+
+void clearRenderList(RenderList &list);
+
+void addRenderRect(RenderList &list, int layer, const AtlasRect &destination, uint32_t color);
+void addRenderImage(RenderList &list, int layer, int texture, const AtlasRect &source, const AtlasRect &destination, uint32_t color);
+
+// text is copied, so it can be a buffer that is reused right away.
+void addRenderText(RenderList &list, int layer, int texture, const GlyphAtlas &atlas, const char *text, int x, int y, uint32_t color);
+
+// Stable, so commands with the same layer, texture and color keep the order they were added in.
+void sortRenderList(RenderList &list);
+
+// Draws the commands in list order, starting with no texture or color set.
+void submitRenderList(RenderList &list, RenderBackend &backend);
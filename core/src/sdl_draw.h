@@ -0,0 +1,371 @@
+#pragma once
+
+#include "atlas.h"
+#include "cooked.h"
+#include "game.h"
+#include "text.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdio>
+#include <vector>
+
+// The drawing every SDL port does the same way. Like sdl_render_backend.h it is all in the
+// header, so core/src still builds without SDL on the other consoles.
+
+// Wide enough for a 36 point font in a few rows.
+const int SDL_GLYPH_ATLAS_WIDTH = 512;
+
+// Renders every printable ASCII glyph once and packs them into one texture, so HUD text
+// is quads copied out of it and a score change costs no rasterizing or texture upload.
+inline SDL_Texture *bakeGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font, GlyphAtlas &atlas)
+{
+    if (font == nullptr)
+    {
+        printf("TTF_OpenFont: %s\n", TTF_GetError());
+        return nullptr;
+    }
+
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface *glyphSurfaces[GLYPH_COUNT];
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        Uint16 character = (Uint16)(FIRST_GLYPH + i);
+        int advance = 0;
+
+        TTF_GlyphMetrics(font, character, NULL, NULL, NULL, NULL, &advance);
+        glyphSurfaces[i] = TTF_RenderGlyph_Blended(font, character, white);
+
+        atlas.glyphs[i].w = glyphSurfaces[i] != nullptr ? glyphSurfaces[i]->w : 0;
+        atlas.glyphs[i].h = glyphSurfaces[i] != nullptr ? glyphSurfaces[i]->h : 0;
+        atlas.advances[i] = advance;
+    }
+
+    atlas.lineHeight = TTF_FontHeight(font);
+
+    SDL_Texture *texture = nullptr;
+
+    if (packGlyphAtlas(atlas, SDL_GLYPH_ATLAS_WIDTH))
+    {
+        SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlas.width, atlas.height, 32, SDL_PIXELFORMAT_RGBA32);
+
+        if (atlasSurface != nullptr)
+        {
+            for (int i = 0; i < GLYPH_COUNT; i++)
+            {
+                if (glyphSurfaces[i] != nullptr)
+                {
+                    SDL_Rect destination = {atlas.glyphs[i].x, atlas.glyphs[i].y, atlas.glyphs[i].w, atlas.glyphs[i].h};
+
+                    SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+                    SDL_BlitSurface(glyphSurfaces[i], NULL, atlasSurface, &destination);
+                }
+            }
+
+            texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+            SDL_FreeSurface(atlasSurface);
+        }
+    }
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        SDL_FreeSurface(glyphSurfaces[i]);
+    }
+
+    if (texture == nullptr)
+    {
+        printf("Unable to bake the glyph atlas! SDL Error: %s\n", SDL_GetError());
+    }
+
+    return texture;
+}
+
+// The atlas breakout_cook rasterized for this port, or nullptr when it hasn't been cooked.
+// Only the ports that build cooked.cpp call it.
+inline SDL_Texture *loadCookedGlyphAtlas(SDL_Renderer *renderer, const char *filePath, GlyphAtlas &atlas)
+{
+    CookedFont font;
+
+    if (!loadCookedFont(filePath, font))
+    {
+        return nullptr;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, font.atlas.width, font.atlas.height, 32, SDL_PIXELFORMAT_RGBA32);
+
+    if (surface == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (int y = 0; y < font.atlas.height; y++)
+    {
+        Uint8 *pixels = (Uint8 *)surface->pixels + y * surface->pitch;
+        const uint8_t *alpha = &font.alpha[(size_t)y * font.atlas.width];
+
+        for (int x = 0; x < font.atlas.width; x++)
+        {
+            pixels[x * 4 + 0] = 255;
+            pixels[x * 4 + 1] = 255;
+            pixels[x * 4 + 2] = 255;
+            pixels[x * 4 + 3] = alpha[x];
+        }
+    }
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+
+    if (texture != nullptr)
+    {
+        atlas = font.atlas;
+    }
+
+    return texture;
+}
+
+// Copies text's glyphs out of the atlas texture and returns how many it drew.
+inline int drawText(SDL_Renderer *renderer, SDL_Texture *atlasTexture, const GlyphAtlas &atlas, const char *text, int x, int y)
+{
+    static std::vector<GlyphQuad> quads;
+
+    quads.clear();
+    layoutText(atlas, text, x, y, quads);
+
+    for (const GlyphQuad &quad : quads)
+    {
+        SDL_Rect source = {quad.source.x, quad.source.y, quad.source.w, quad.source.h};
+        SDL_Rect destination = {quad.destination.x, quad.destination.y, quad.destination.w, quad.destination.h};
+
+        SDL_RenderCopy(renderer, atlasTexture, &source, &destination);
+    }
+
+    return (int)quads.size();
+}
+
+inline SDL_Rect toRect(const Bounds &bounds)
+{
+    SDL_Rect rect = {(int)bounds.x, (int)bounds.y, (int)bounds.w, (int)bounds.h};
+
+    return rect;
+}
+
+// The bricks only change when one is destroyed, so they are drawn once into a texture
+// covering the brick band and each frame copies it to the screen. A destroyed brick is
+// erased from the layer by filling its own rect with the background.
+typedef struct
+{
+    // nullptr when the render target can't be created; the bricks are then drawn every frame.
+    SDL_Texture *texture;
+    SDL_Rect bounds;
+
+    // The field the texture shows. Set isDirty when the texture's contents are lost, as on
+    // SDL_RENDER_TARGETS_RESET, and the next update redraws it all.
+    BrickField drawnBricks;
+    bool isDirty;
+
+    std::vector<Bounds> clearedBricks;
+    std::vector<SDL_Rect> rects;
+} BrickLayer;
+
+// Every brick is the same color, so they all go to the renderer in one call.
+inline void drawBricks(SDL_Renderer *renderer, const GameConfig &config, const BrickField &bricks, std::vector<SDL_Rect> &rects, int originX, int originY)
+{
+    rects.clear();
+
+    for (int row = 0; row < bricks.rows; row++)
+    {
+        for (int column = findNextBrick(bricks, row, 0); column >= 0; column = findNextBrick(bricks, row, column + 1))
+        {
+            SDL_Rect rect = toRect(getBrickBounds(config, row, column));
+            rect.x -= originX;
+            rect.y -= originY;
+
+            rects.push_back(rect);
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
+    SDL_RenderFillRects(renderer, rects.data(), (int)rects.size());
+}
+
+inline void createBrickLayer(SDL_Renderer *renderer, BrickLayer &layer, const GameConfig &config)
+{
+    layer.bounds.x = (int)config.brickOffsetX;
+    layer.bounds.y = (int)config.brickOffsetY;
+    layer.bounds.w = (int)(config.brickSpacingX * (config.brickColumns - 1) + config.brickWidth);
+    layer.bounds.h = (int)(config.brickSpacingY * (config.brickRows - 1) + config.brickHeight);
+
+    layer.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, layer.bounds.w, layer.bounds.h);
+
+    if (layer.texture == nullptr)
+    {
+        printf("Unable to create the brick layer, drawing the bricks every frame! SDL Error: %s\n", SDL_GetError());
+    }
+    else
+    {
+        // Every pixel of the layer is opaque, so copying can skip blending.
+        SDL_SetTextureBlendMode(layer.texture, SDL_BLENDMODE_NONE);
+    }
+
+    layer.isDirty = true;
+}
+
+// Brings the layer's texture up to bricks. The layer must have a texture.
+inline void updateBrickLayer(SDL_Renderer *renderer, BrickLayer &layer, const GameConfig &config, const BrickField &bricks)
+{
+    if (!layer.isDirty && layer.drawnBricks.aliveMasks == bricks.aliveMasks)
+    {
+        return;
+    }
+
+    layer.clearedBricks.clear();
+
+    SDL_SetRenderTarget(renderer, layer.texture);
+
+    if (layer.isDirty || !findClearedBricks(config, layer.drawnBricks, bricks, layer.clearedBricks))
+    {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        drawBricks(renderer, config, bricks, layer.rects, layer.bounds.x, layer.bounds.y);
+    }
+    else
+    {
+        layer.rects.clear();
+
+        for (const Bounds &brick : layer.clearedBricks)
+        {
+            SDL_Rect rect = toRect(brick);
+            rect.x -= layer.bounds.x;
+            rect.y -= layer.bounds.y;
+
+            layer.rects.push_back(rect);
+        }
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRects(renderer, layer.rects.data(), (int)layer.rects.size());
+    }
+
+    SDL_SetRenderTarget(renderer, NULL);
+
+    layer.drawnBricks = bricks;
+    layer.isDirty = false;
+}
+
+// Copies the layer to the screen, or draws the bricks straight to it when there is no layer.
+inline void drawBrickLayer(SDL_Renderer *renderer, BrickLayer &layer, const GameConfig &config, const BrickField &bricks)
+{
+    if (layer.texture != nullptr)
+    {
+        updateBrickLayer(renderer, layer, config, bricks);
+        SDL_RenderCopy(renderer, layer.texture, NULL, &layer.bounds);
+    }
+    else
+    {
+        drawBricks(renderer, config, bricks, layer.rects, 0, 0);
+    }
+}
+
+// Sprite images packed onto a few large pages at startup, so sprites drawn together share
+// a texture and batch. Add every image, build once, then draw sprites by their handles.
+typedef struct
+{
+    std::vector<SDL_Surface *> images;
+    std::vector<AtlasRect> rects;
+    std::vector<int> pages;
+    std::vector<SDL_Texture *> pageTextures;
+} SpriteAtlas;
+
+// Takes image to pack, which the atlas frees once it is built, and returns its handle, or -1
+// for no image. The image can come from IMG_Load() or be drawn at startup.
+inline int addSpriteImage(SpriteAtlas &atlas, SDL_Surface *image)
+{
+    if (image == nullptr)
+    {
+        return -1;
+    }
+
+    AtlasRect rect = {0, 0, image->w, image->h};
+
+    atlas.images.push_back(image);
+    atlas.rects.push_back(rect);
+
+    return (int)atlas.images.size() - 1;
+}
+
+// Packs the images onto pages of pageSize x pageSize and uploads them. Returns false if an
+// image is bigger than a page or a page can't be created.
+inline bool buildSpriteAtlas(SDL_Renderer *renderer, SpriteAtlas &atlas, int pageSize)
+{
+    // One pixel between images, so filtering never picks up a neighbour's edge.
+    int pageCount = packAtlasPages(atlas.rects, atlas.pages, pageSize, pageSize, 1);
+
+    bool isBuilt = pageCount >= 0;
+
+    if (!isBuilt)
+    {
+        printf("A sprite image is bigger than a %dx%d atlas page!\n", pageSize, pageSize);
+    }
+
+    for (int page = 0; page < pageCount && isBuilt; page++)
+    {
+        SDL_Surface *pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32);
+
+        if (pageSurface == nullptr)
+        {
+            isBuilt = false;
+            break;
+        }
+
+        for (int i = 0; i < (int)atlas.images.size(); i++)
+        {
+            if (atlas.pages[i] == page)
+            {
+                SDL_Rect destination = {atlas.rects[i].x, atlas.rects[i].y, atlas.rects[i].w, atlas.rects[i].h};
+
+                SDL_SetSurfaceBlendMode(atlas.images[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(atlas.images[i], NULL, pageSurface, &destination);
+            }
+        }
+
+        SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, pageSurface);
+        SDL_FreeSurface(pageSurface);
+
+        if (texture == nullptr)
+        {
+            isBuilt = false;
+            break;
+        }
+
+        atlas.pageTextures.push_back(texture);
+    }
+
+    if (!isBuilt)
+    {
+        printf("Unable to build the sprite atlas! SDL Error: %s\n", SDL_GetError());
+    }
+
+    // The pixels are on the pages now.
+    for (SDL_Surface *image : atlas.images)
+    {
+        SDL_FreeSurface(image);
+    }
+
+    atlas.images.clear();
+
+    return isBuilt;
+}
+
+// Copies the sprite with handle out of its page, stretched over destination.
+inline void drawSprite(SDL_Renderer *renderer, const SpriteAtlas &atlas, int handle, const SDL_Rect &destination)
+{
+    if (handle < 0 || handle >= (int)atlas.rects.size() || atlas.pages[handle] >= (int)atlas.pageTextures.size())
+    {
+        return;
+    }
+
+    const AtlasRect &rect = atlas.rects[handle];
+    SDL_Rect source = {rect.x, rect.y, rect.w, rect.h};
+
+    SDL_RenderCopy(renderer, atlas.pageTextures[atlas.pages[handle]], &source, &destination);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "render_list.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <vector>
+
+// Draws a RenderList with an SDL_Renderer. Texture ids are indices into textures. Only
+// the SDL ports include this, so it is all in the header and core/src still builds
+// without SDL on the other consoles.
+class SdlRenderBackend : public RenderBackend
+{
+public:
+    explicit SdlRenderBackend(SDL_Renderer *renderer) : stateChanges(0), drawCalls(0), renderer(renderer), texture(nullptr), color(0) {}
+
+    // Counted since the backend was created; the port resets them when it prints them.
+    int stateChanges;
+    int drawCalls;
+
+    // Adds a texture and returns its id.
+    int addTexture(SDL_Texture *sdlTexture)
+    {
+        textures.push_back(sdlTexture);
+        return (int)textures.size() - 1;
+    }
+
+    void setTexture(int id) override
+    {
+        texture = id >= 0 && id < (int)textures.size() ? textures[id] : nullptr;
+        stateChanges++;
+    }
+
+    void setColor(uint32_t rgba) override
+    {
+        color = rgba;
+        SDL_SetRenderDrawColor(renderer, (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff, color >> 24);
+        stateChanges++;
+    }
+
+    void fillRects(const AtlasRect *rects, int count) override
+    {
+        sdlRects.resize(count);
+
+        for (int i = 0; i < count; i++)
+        {
+            sdlRects[i] = toSdlRect(rects[i]);
+        }
+
+        SDL_RenderFillRects(renderer, sdlRects.data(), count);
+        drawCalls++;
+    }
+
+    // All the quads as one SDL_RenderGeometryRaw() call, so a batch really is one draw. The
+    // color goes in every vertex, which tints the texture like the color mod would.
+    void copyQuads(const GlyphQuad *quads, int count) override
+    {
+        if (texture == nullptr || count == 0)
+        {
+            return;
+        }
+
+        int textureWidth, textureHeight;
+        SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
+
+        float scaleU = 1.0f / textureWidth;
+        float scaleV = 1.0f / textureHeight;
+
+        SDL_Color vertexColor = {(Uint8)(color >> 16), (Uint8)(color >> 8), (Uint8)color, (Uint8)(color >> 24)};
+
+        vertexXY.resize(count * 8);
+        vertexUV.resize(count * 8);
+        vertexColors.assign(count * 4, vertexColor);
+
+        while ((int)indices.size() < count * 6)
+        {
+            int first = (int)indices.size() / 6 * 4;
+            int quad[6] = {first, first + 1, first + 2, first, first + 2, first + 3};
+
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            const AtlasRect &source = quads[i].source;
+            const AtlasRect &destination = quads[i].destination;
+
+            float left = (float)destination.x, right = (float)(destination.x + destination.w);
+            float top = (float)destination.y, bottom = (float)(destination.y + destination.h);
+            float u0 = source.x * scaleU, u1 = (source.x + source.w) * scaleU;
+            float v0 = source.y * scaleV, v1 = (source.y + source.h) * scaleV;
+
+            float xy[8] = {left, top, right, top, right, bottom, left, bottom};
+            float uv[8] = {u0, v0, u1, v0, u1, v1, u0, v1};
+
+            std::copy(xy, xy + 8, &vertexXY[i * 8]);
+            std::copy(uv, uv + 8, &vertexUV[i * 8]);
+        }
+
+        SDL_RenderGeometryRaw(renderer, texture, vertexXY.data(), 2 * sizeof(float), vertexColors.data(), sizeof(SDL_Color), vertexUV.data(),
+                              2 * sizeof(float), count * 4, indices.data(), count * 6, sizeof(int));
+        drawCalls++;
+    }
+
+private:
+    static SDL_Rect toSdlRect(const AtlasRect &rect)
+    {
+        SDL_Rect sdlRect = {rect.x, rect.y, rect.w, rect.h};
+        return sdlRect;
+    }
+
+    SDL_Renderer *renderer;
+    std::vector<SDL_Texture *> textures;
+    std::vector<SDL_Rect> sdlRects;
+
+    std::vector<float> vertexXY;
+    std::vector<float> vertexUV;
+    std::vector<SDL_Color> vertexColors;
+    std::vector<int> indices;
+
+    SDL_Texture *texture;
+    uint32_t color;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// A handle stays valid until its entry is removed. Removing bumps the slot's generation,
+// so an old handle to a reused slot is rejected instead of reaching the new entry.
+typedef struct
+{
+    uint32_t slot;
+    uint32_t generation;
+} SlotHandle;
+
+// Entities that come and go during play. Values are kept packed in one array so the
+// live ones can be walked without gaps; removing moves the last value into the hole,
+// so removal is O(1) and never shifts the rest, and iteration order is not kept.
+template <typename T>
+class SlotMap
+{
+public:
+    SlotHandle insert(const T &value)
+    {
+        uint32_t slot;
+
+        if (freeSlots.empty())
+        {
+            slot = (uint32_t)slotToDense.size();
+            slotToDense.push_back(0);
+            generations.push_back(0);
+        }
+        else
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        slotToDense[slot] = (uint32_t)values.size();
+        values.push_back(value);
+        denseToSlot.push_back(slot);
+
+        SlotHandle handle = {slot, generations[slot]};
+
+        return handle;
+    }
+
+    bool remove(SlotHandle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        uint32_t dense = slotToDense[handle.slot];
+        uint32_t last = (uint32_t)values.size() - 1;
+
+        if (dense != last)
+        {
+            values[dense] = values[last];
+            denseToSlot[dense] = denseToSlot[last];
+            slotToDense[denseToSlot[dense]] = dense;
+        }
+
+        values.pop_back();
+        denseToSlot.pop_back();
+
+        generations[handle.slot]++;
+        freeSlots.push_back(handle.slot);
+
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const
+    {
+        return handle.slot < generations.size() && generations[handle.slot] == handle.generation;
+    }
+
+    // nullptr when the handle's entry was removed.
+    T *get(SlotHandle handle)
+    {
+        return contains(handle) ? &values[slotToDense[handle.slot]] : nullptr;
+    }
+
+    // The handle of the value at index in the packed array, e.g. to remove it while iterating.
+    SlotHandle handleAt(int index) const
+    {
+        uint32_t slot = denseToSlot[index];
+        SlotHandle handle = {slot, generations[slot]};
+
+        return handle;
+    }
+
+    void reserve(int count)
+    {
+        values.reserve(count);
+        denseToSlot.reserve(count);
+        slotToDense.reserve(count);
+        generations.reserve(count);
+    }
+
+    void clear()
+    {
+        for (uint32_t slot : denseToSlot)
+        {
+            generations[slot]++;
+            freeSlots.push_back(slot);
+        }
+
+        values.clear();
+        denseToSlot.clear();
+    }
+
+    int size() const
+    {
+        return (int)values.size();
+    }
+
+    T &operator[](int index)
+    {
+        return values[index];
+    }
+
+    T *begin()
+    {
+        return values.data();
+    }
+
+    T *end()
+    {
+        return values.data() + values.size();
+    }
+
+    const T *begin() const
+    {
+        return values.data();
+    }
+
+    const T *end() const
+    {
+        return values.data() + values.size();
+    }
+
+private:
+    std::vector<T> values;
+    std::vector<uint32_t> denseToSlot;
+    std::vector<uint32_t> slotToDense;
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeSlots;
+};
@@ -0,0 +1,19 @@
+#include "snapshot.h"
+
+void takeGameSnapshot(GameSnapshot &snapshot, const Game &game, const Bounds &previousPlayer, const Bounds &previousBall, long long tick,
+                      unsigned long long tickTime)
+{
+    snapshot.tick = tick;
+    snapshot.tickTime = tickTime;
+
+    snapshot.previousPlayer = previousPlayer;
+    snapshot.previousBall = previousBall;
+    snapshot.player = game.player;
+    snapshot.ball = game.ball;
+
+    snapshot.bricks = game.bricks;
+
+    snapshot.playerScore = game.playerScore;
+    snapshot.playerLives = game.playerLives;
+    snapshot.isAutoPlayMode = game.isAutoPlayMode;
+}
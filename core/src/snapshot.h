@@ -0,0 +1,30 @@
+#pragma once
+
+#include "game.h"
+
+// What a render thread needs of the game to draw a frame, copied out by the simulation
+// thread after every tick so the two never touch the same Game.
+typedef struct
+{
+    // The number of ticks simulated so far, and when the last one ran in the port's
+    // counter ticks, so the render thread can tell how far it is past it.
+    long long tick;
+    unsigned long long tickTime;
+
+    // The state before and after the last tick, to interpolate between.
+    Bounds previousPlayer;
+    Bounds previousBall;
+    Bounds player;
+    Bounds ball;
+
+    BrickField bricks;
+
+    int playerScore;
+    int playerLives;
+    bool isAutoPlayMode;
+} GameSnapshot;
+
+// Copies game into snapshot. Reusing the same snapshots keeps the brick masks' storage,
+// so after the first copies this allocates nothing.
+void takeGameSnapshot(GameSnapshot &snapshot, const Game &game, const Bounds &previousPlayer, const Bounds &previousBall, long long tick,
+                      unsigned long long tickTime);
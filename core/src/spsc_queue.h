@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// A bounded queue between exactly one producer thread and one consumer thread, without
+// locks: each side only writes its own index. push() never blocks or allocates; when the
+// queue is full the value is dropped and counted. Header only, like TripleBuffer.
+template <typename T>
+class SpscQueue
+{
+public:
+    // capacity is rounded up to a power of two.
+    explicit SpscQueue(int capacity) : head(0), tail(0), drops(0)
+    {
+        int size = 1;
+
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+
+        values.resize(size);
+        mask = (unsigned int)size - 1;
+    }
+
+    // Producer only. Returns false and counts a drop when the queue is full.
+    bool push(const T &value)
+    {
+        unsigned int currentTail = tail.load(std::memory_order_relaxed);
+
+        if (currentTail - head.load(std::memory_order_acquire) > mask)
+        {
+            drops.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        values[currentTail & mask] = value;
+        tail.store(currentTail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only. Returns false when the queue is empty.
+    bool pop(T &value)
+    {
+        unsigned int currentHead = head.load(std::memory_order_relaxed);
+
+        if (currentHead == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        value = values[currentHead & mask];
+        head.store(currentHead + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Values push() dropped because the queue was full.
+    long long droppedCount() const { return drops.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> values;
+    unsigned int mask;
+
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+    std::atomic<long long> drops;
+};
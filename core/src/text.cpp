@@ -0,0 +1,71 @@
+#include "text.h"
+
+// Padding keeps filtering from bleeding a neighbour into a glyph when text is scaled.
+const int GLYPH_PADDING = 1;
+
+static int findGlyph(char character)
+{
+    int index = (unsigned char)character - FIRST_GLYPH;
+
+    if (index < 0 || index >= GLYPH_COUNT)
+    {
+        index = '?' - FIRST_GLYPH;
+    }
+
+    return index;
+}
+
+bool packGlyphAtlas(GlyphAtlas &atlas, int width)
+{
+    std::vector<AtlasRect> rects(atlas.glyphs, atlas.glyphs + GLYPH_COUNT);
+
+    int height = packAtlas(rects, width, GLYPH_PADDING);
+
+    if (height < 0)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        atlas.glyphs[i] = rects[i];
+    }
+
+    atlas.width = width;
+    atlas.height = height;
+
+    return true;
+}
+
+int layoutText(const GlyphAtlas &atlas, const char *text, int x, int y, std::vector<GlyphQuad> &quads)
+{
+    int penX = x;
+
+    for (const char *character = text; *character != '\0'; character++)
+    {
+        int index = findGlyph(*character);
+        const AtlasRect &glyph = atlas.glyphs[index];
+
+        if (glyph.w > 0 && glyph.h > 0)
+        {
+            GlyphQuad quad = {glyph, {penX, y, glyph.w, glyph.h}};
+            quads.push_back(quad);
+        }
+
+        penX += atlas.advances[index];
+    }
+
+    return penX - x;
+}
+
+int measureText(const GlyphAtlas &atlas, const char *text)
+{
+    int width = 0;
+
+    for (const char *character = text; *character != '\0'; character++)
+    {
+        width += atlas.advances[findGlyph(*character)];
+    }
+
+    return width;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "atlas.h"
+#include <vector>
+
+// Printable ASCII, ' ' to '~'.
+const int FIRST_GLYPH = 32;
+const int GLYPH_COUNT = 95;
+
+// A font rendered once into a texture: where each glyph sits in it and how far each one
+// moves the pen. The port fills in the glyph sizes and advances from its font library.
+typedef struct
+{
+    int width;
+    int height;
+    int lineHeight;
+
+    AtlasRect glyphs[GLYPH_COUNT];
+    int advances[GLYPH_COUNT];
+} GlyphAtlas;
+
+typedef struct
+{
+    AtlasRect source;
+    AtlasRect destination;
+} GlyphQuad;
+
+// Packs the glyphs, whose w and h are already set, into an atlas width pixels wide and
+// sets the atlas size. Returns false when a glyph is wider than the atlas.
+bool packGlyphAtlas(GlyphAtlas &atlas, int width);
+
+// Appends one quad per visible glyph of text with its top left at (x, y) and returns
+// the width of the text. Characters outside the atlas are drawn as '?'.
+int layoutText(const GlyphAtlas &atlas, const char *text, int x, int y, std::vector<GlyphQuad> &quads);
+
+int measureText(const GlyphAtlas &atlas, const char *text);
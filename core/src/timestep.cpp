@@ -0,0 +1,56 @@
+#include "timestep.h"
+
+void initFixedTimestep(FixedTimestep &timestep, int ticksPerSecond, int maxTicksPerFrame, unsigned long long counterFrequency)
+{
+    timestep.ticksPerSecond = ticksPerSecond;
+    timestep.maxTicksPerFrame = maxTicksPerFrame;
+    timestep.counterFrequency = counterFrequency;
+    timestep.accumulator = 0;
+    timestep.droppedTicks = 0;
+}
+
+int advanceFixedTimestep(FixedTimestep &timestep, unsigned long long elapsedCounterTicks)
+{
+    timestep.accumulator += elapsedCounterTicks * timestep.ticksPerSecond;
+
+    unsigned long long ticks = timestep.accumulator / timestep.counterFrequency;
+
+    timestep.accumulator %= timestep.counterFrequency;
+
+    if (ticks > (unsigned long long)timestep.maxTicksPerFrame)
+    {
+        timestep.droppedTicks += ticks - timestep.maxTicksPerFrame;
+        ticks = timestep.maxTicksPerFrame;
+    }
+
+    return (int)ticks;
+}
+
+unsigned long long fixedTimestepEndTime(const FixedTimestep &timestep, unsigned long long counterTime)
+{
+    return counterTime - timestep.accumulator / timestep.ticksPerSecond;
+}
+
+Number fixedTimestepDelta(const FixedTimestep &timestep)
+{
+    return Number(1.0f / timestep.ticksPerSecond);
+}
+
+float fixedTimestepAlpha(const FixedTimestep &timestep)
+{
+    return (float)timestep.accumulator / (float)timestep.counterFrequency;
+}
+
+Bounds interpolateBounds(const Bounds &previous, const Bounds &current, float alpha)
+{
+    Number weight = alpha;
+
+    Bounds bounds = {
+        previous.x + (current.x - previous.x) * weight,
+        previous.y + (current.y - previous.y) * weight,
+        current.w,
+        current.h,
+    };
+
+    return bounds;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "game.h"
+
+// Accumulator for running updateGame() at a fixed rate whatever the frame rate is.
+// Time comes in as ticks of a high resolution counter (SDL_GetPerformanceCounter() and
+// SDL_GetPerformanceFrequency() on the SDL ports) and is kept in counter ticks times the
+// simulation rate, so no time is lost to rounding even at 1000 Hz.
+typedef struct
+{
+    int ticksPerSecond;
+    int maxTicksPerFrame;
+    unsigned long long counterFrequency;
+    unsigned long long accumulator;
+
+    // Simulation ticks thrown away by the maxTicksPerFrame cap after a long hitch.
+    unsigned long long droppedTicks;
+} FixedTimestep;
+
+void initFixedTimestep(FixedTimestep &timestep, int ticksPerSecond, int maxTicksPerFrame, unsigned long long counterFrequency);
+
+// Adds the time since the last frame and returns how many fixed ticks to simulate now.
+// Never returns more than maxTicksPerFrame, so a slow frame cannot snowball into ever
+// slower frames; the time over the cap is dropped.
+int advanceFixedTimestep(FixedTimestep &timestep, unsigned long long elapsedCounterTicks);
+
+// The counter time the ticks advanceFixedTimestep() just returned end at, given the counter
+// time that was passed in: the last tick ends what's left in the accumulator before it. The
+// n ticks of a call start one tick apart from n ticks before that.
+unsigned long long fixedTimestepEndTime(const FixedTimestep &timestep, unsigned long long counterTime);
+
+// The deltaTime to pass to updateGame() for every tick.
+Number fixedTimestepDelta(const FixedTimestep &timestep);
+
+// How far the current frame is between the last two simulated states, in [0, 1).
+float fixedTimestepAlpha(const FixedTimestep &timestep);
+
+Bounds interpolateBounds(const Bounds &previous, const Bounds &current, float alpha);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+
+// Hands the latest of a stream of values from one writer thread to one reader thread
+// without locks. Of the three buffers the writer owns one, the reader owns one and the
+// third is the latest published value; publish() and update() swap their own buffer
+// with it in one atomic exchange. Neither side ever waits: the writer can publish as
+// often as it likes and the reader always gets the newest value, skipping older ones.
+// Header only, like the other templates, and only used by the ports that have threads.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : latest(1), writeIndex(0), readIndex(2) {}
+
+    // The writer fills this, then calls publish().
+    T &writeBuffer() { return buffers[writeIndex]; }
+
+    // Makes the write buffer the latest value. The writer gets the old latest buffer
+    // back to fill next; it holds whatever was published before, not garbage.
+    void publish()
+    {
+        writeIndex = latest.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Takes the latest value if one was published since the last call and returns
+    // whether it did. readBuffer() stays the same when it returns false.
+    bool update()
+    {
+        if ((latest.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+        {
+            return false;
+        }
+
+        readIndex = latest.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+
+        return true;
+    }
+
+    const T &readBuffer() const { return buffers[readIndex]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    T buffers[3];
+
+    // The index of the latest buffer, with FRESH_BIT set until the reader takes it.
+    std::atomic<int> latest;
+
+    int writeIndex;
+    int readIndex;
+};
@@ -0,0 +1,145 @@
+#include "atlas.h"
+#include "counting_backend.h"
+#include "render_list.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Packs made-up sprite images of random sizes onto atlas pages with packAtlasPages() and
+// checks that every sprite is inside its page and no two on a page overlap. Then draws
+// every sprite once through a RenderList, with one texture per sprite the way
+// loadSprite() loads them and with the atlas pages, and prints the texture switches and
+// draw calls of both. Exits with 1 if the packing is wrong.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--sprites N] [--max-size N] [--page WxH] [--seed N]\n", program);
+}
+
+bool isOverlapping(const AtlasRect &a, const AtlasRect &b)
+{
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+int main(int argc, char *argv[])
+{
+    int spriteCount = 300;
+    int maxSize = 96;
+    int pageWidth = 1024;
+    int pageHeight = 1024;
+    unsigned int state = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sprites") == 0 && i + 1 < argc)
+        {
+            spriteCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc)
+        {
+            maxSize = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--page") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &pageWidth, &pageHeight) == 2)
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            state = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (spriteCount <= 0 || maxSize <= 0 || maxSize > pageWidth || maxSize > pageHeight)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<AtlasRect> sprites(spriteCount);
+
+    for (AtlasRect &sprite : sprites)
+    {
+        state = state * 1103515245 + 12345;
+        sprite.w = 1 + (int)((state >> 8) % maxSize);
+        sprite.h = 1 + (int)((state >> 20) % maxSize);
+    }
+
+    std::vector<int> pages;
+
+    auto start = std::chrono::steady_clock::now();
+    int pageCount = packAtlasPages(sprites, pages, pageWidth, pageHeight, 1);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (pageCount <= 0)
+    {
+        printf("packing failed\n");
+        return 1;
+    }
+
+    int misplaced = 0;
+    long long usedPixels = 0;
+
+    for (int i = 0; i < spriteCount; i++)
+    {
+        const AtlasRect &sprite = sprites[i];
+        usedPixels += (long long)sprite.w * sprite.h;
+
+        if (sprite.x < 0 || sprite.y < 0 || sprite.x + sprite.w > pageWidth || sprite.y + sprite.h > pageHeight || pages[i] < 0 ||
+            pages[i] >= pageCount)
+        {
+            misplaced++;
+            continue;
+        }
+
+        for (int j = i + 1; j < spriteCount; j++)
+        {
+            if (pages[i] == pages[j] && isOverlapping(sprite, sprites[j]))
+            {
+                misplaced++;
+            }
+        }
+    }
+
+    printf("sprites: %d up to %dx%d, pages: %d of %dx%d, %.1f%% used, packed in %.1f us\n", spriteCount, maxSize, maxSize, pageCount, pageWidth,
+           pageHeight, usedPixels * 100.0 / ((double)pageCount * pageWidth * pageHeight), seconds * 1e6);
+
+    // A frame drawing every sprite once, in load order.
+    RenderList perImage;
+    RenderList atlas;
+
+    for (int i = 0; i < spriteCount; i++)
+    {
+        AtlasRect image = {0, 0, sprites[i].w, sprites[i].h};
+        AtlasRect destination = {(i * 37) % 960, (i * 53) % 544, sprites[i].w, sprites[i].h};
+
+        addRenderImage(perImage, 0, i, image, destination, 0xffffffff);
+        addRenderImage(atlas, 0, pages[i], sprites[i], destination, 0xffffffff);
+    }
+
+    CountingBackend perImageCounts;
+    CountingBackend atlasCounts;
+
+    sortRenderList(perImage);
+    submitRenderList(perImage, perImageCounts);
+    sortRenderList(atlas);
+    submitRenderList(atlas, atlasCounts);
+
+    printf("%12s %16s %11s\n", "textures", "texture changes", "draw calls");
+    printf("%12s %16lld %11lld\n", "per image", perImageCounts.textureChanges, perImageCounts.drawCalls);
+    printf("%12s %16lld %11lld\n", "atlas", atlasCounts.textureChanges, atlasCounts.drawCalls);
+
+    if (misplaced > 0)
+    {
+        printf("%d sprites are off their page or overlap another\n", misplaced);
+        return 1;
+    }
+
+    return 0;
+}
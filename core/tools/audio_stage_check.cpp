@@ -0,0 +1,215 @@
+#include "audio_stage.h"
+#include "game.h"
+#include "presets.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Plays an autoplay game at 120 Hz on one thread, pushing a SoundEvent for every hit the
+// way the PC port's update() does, while this thread runs the audio stage once per 60 Hz
+// frame on a game clock (no waiting, so it runs as fast as it can). --burst N adds N more
+// hits per tick, like a ball tearing through a row. Each event carries its tick's time and
+// the stage starts voices --delay seconds after it, like the PC port's mixer. Prints the
+// stage's counters next to what playing every event on the first free of the same number
+// of channels would have done, and exits with 1 if the counters don't add up to the events
+// or if a voice start cut off a sound the mixer was still playing without being a steal.
+
+const int TICKS_PER_FRAME = 2;
+const double TICK_SECONDS = 1.0 / 120.0;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--frames N] [--voices N] [--burst N] [--delay SECONDS] [--seed N]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 36000;
+    int voiceCount = 5;
+    int burst = 0;
+    double delay = 0.036;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--voices") == 0 && i + 1 < argc)
+        {
+            voiceCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc)
+        {
+            burst = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc)
+        {
+            delay = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames <= 0 || voiceCount <= 0 || burst < 0 || delay < 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    AudioStage stage;
+    initAudioStage(stage, voiceCount);
+    stage.startDelay = delay;
+
+    // Lengths of the PC port's magic.wav and drop.wav, roughly.
+    const double soundSeconds[2] = {0.3, 0.5};
+    int hitSound = addStageSound(stage, 1, soundSeconds[0]);
+    int bounceSound = addStageSound(stage, 2, soundSeconds[1]);
+
+    SpscQueue<SoundEvent> queue(256);
+
+    // The game thread runs at most a frame ahead of the stage, like a real frame loop.
+    std::atomic<int> publishedFrame(0);
+    std::atomic<int> stagedFrame(0);
+    long long pushed = 0;
+
+    std::thread game([&]() {
+        Game game;
+        initGame(game, PC_CONFIG);
+        serveBall(game, seed);
+
+        GameInput input = {false, false};
+
+        for (int frame = 1; frame <= frames; frame++)
+        {
+            while (stagedFrame.load(std::memory_order_acquire) < frame - 1)
+            {
+                std::this_thread::yield();
+            }
+
+            for (int tick = 0; tick < TICKS_PER_FRAME; tick++)
+            {
+                int events = updateGame(game, input, Number((float)TICK_SECONDS));
+                double time = ((frame - 1) * TICKS_PER_FRAME + tick + 1) * TICK_SECONDS;
+
+                if (events & (GAME_EVENT_WALL_HIT | GAME_EVENT_BRICK_HIT))
+                {
+                    SoundEvent event = {hitSound, time};
+                    queue.push(event);
+                    pushed++;
+                }
+
+                if (events & (GAME_EVENT_PLAYER_HIT | GAME_EVENT_CEILING_HIT))
+                {
+                    SoundEvent event = {bounceSound, time};
+                    queue.push(event);
+                    pushed++;
+                }
+
+                for (int i = 0; i < burst; i++)
+                {
+                    SoundEvent event = {hitSound, time};
+                    queue.push(event);
+                    pushed++;
+                }
+            }
+
+            publishedFrame.store(frame, std::memory_order_release);
+        }
+    });
+
+    std::vector<VoiceStart> starts;
+
+    // Every event on the first free channel, dropped when there is none: Mix_PlayChannel(-1, ...).
+    std::vector<double> channelEnds(voiceCount, 0);
+    long long directPlayed = 0;
+    long long directDropped = 0;
+
+    // When each voice really plays, started like Mixer does it: at the event's time plus the
+    // delay, or right away when that has passed.
+    std::vector<double> mixerEnds(voiceCount, 0);
+    long long cutOff = 0;
+
+    for (int frame = 1; frame <= frames; frame++)
+    {
+        while (publishedFrame.load(std::memory_order_acquire) < frame)
+        {
+            std::this_thread::yield();
+        }
+
+        double now = frame * TICKS_PER_FRAME * TICK_SECONDS;
+        long long eventsBefore = stage.events;
+
+        starts.clear();
+        runAudioStage(stage, queue, now, starts);
+
+        for (const VoiceStart &start : starts)
+        {
+            double mixerStart = delay > 0 && start.time + delay > now ? start.time + delay : now;
+
+            if (mixerEnds[start.voice] > mixerStart)
+            {
+                cutOff++;
+            }
+
+            mixerEnds[start.voice] = mixerStart + soundSeconds[start.sound];
+        }
+
+        // The stage doesn't say which events it drained, so replay the direct model with
+        // the same number, in the same proportion of sounds the game produced.
+        for (long long i = eventsBefore; i < stage.events; i++)
+        {
+            int channel = 0;
+
+            while (channel < voiceCount && channelEnds[channel] > now)
+            {
+                channel++;
+            }
+
+            if (channel < voiceCount)
+            {
+                channelEnds[channel] = now + 0.3;
+                directPlayed++;
+            }
+            else
+            {
+                directDropped++;
+            }
+        }
+
+        stagedFrame.store(frame, std::memory_order_release);
+    }
+
+    game.join();
+
+    printf("frames: %d, voices: %d, burst: %d, events pushed: %lld, queue full: %lld\n", frames, voiceCount, burst, pushed, queue.droppedCount());
+    printf("%10s %10s %10s %10s %10s\n", "", "played", "coalesced", "stolen", "dropped");
+    printf("%10s %10lld %10s %10s %10lld\n", "direct", directPlayed, "-", "-", directDropped);
+    printf("%10s %10lld %10lld %10lld %10lld\n", "stage", stage.played, stage.coalesced, stage.stolen, stage.dropped);
+    printf("sounds cut off in the mixer: %lld\n", cutOff);
+
+    if (stage.events + queue.droppedCount() != pushed || stage.played + stage.coalesced + stage.dropped != stage.events)
+    {
+        printf("the counters don't add up to the events pushed\n");
+        return 1;
+    }
+
+    if (cutOff != stage.stolen)
+    {
+        printf("the mixer cut off %lld sounds but the stage only stole %lld voices\n", cutOff, stage.stolen);
+        return 1;
+    }
+
+    return 0;
+}
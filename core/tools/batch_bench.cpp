@@ -0,0 +1,115 @@
+#include "batch.h"
+#include "game.h"
+#include "presets.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Steps the same set of seeded autoplay games once with one updateGame() call per
+// game and once with stepGameBatch(), checks that both end in the same state and
+// prints games stepped per second for each.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--games N] [--ticks N] [--dt SECONDS] [--seed N]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    int gameCount = 4096;
+    int ticks = 2000;
+    float deltaTime = 1.0f / 60.0f;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+        {
+            gameCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            ticks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc)
+        {
+            deltaTime = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (gameCount <= 0 || ticks <= 0 || deltaTime <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // The batch plays the discrete rules, so the scalar side does too.
+    GameConfig config = PC_CONFIG;
+    config.useDiscreteCollision = true;
+
+    std::vector<Game> games(gameCount);
+
+    for (int i = 0; i < gameCount; i++)
+    {
+        initGame(games[i], config);
+        serveBall(games[i], seed + i);
+    }
+
+    GameInput input = {false, false};
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        for (Game &game : games)
+        {
+            updateGame(game, input, deltaTime);
+        }
+    }
+
+    double scalarSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    GameBatch batch;
+    initGameBatch(batch, config, gameCount, seed);
+
+    start = std::chrono::steady_clock::now();
+
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        stepGameBatch(batch, deltaTime);
+    }
+
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int mismatches = 0;
+
+    for (int i = 0; i < gameCount; i++)
+    {
+        if (games[i].playerScore != batch.playerScore[i] || games[i].playerLives != batch.playerLives[i] ||
+            games[i].ball.x != batch.ballX[i] || games[i].ball.y != batch.ballY[i])
+        {
+            mismatches++;
+        }
+    }
+
+    double steps = (double)gameCount * ticks;
+
+    printf("games: %d, ticks: %d, lanes: %d\n", gameCount, ticks, gameBatchLaneCount());
+    printf("scalar: %.3f s, %.0f game steps per second\n", scalarSeconds, steps / scalarSeconds);
+    printf("batch:  %.3f s, %.0f game steps per second\n", batchSeconds, steps / batchSeconds);
+    printf("speedup: %.2fx\n", scalarSeconds / batchSeconds);
+    printf("mismatched games: %d\n", mismatches);
+
+    return mismatches == 0 ? 0 : 1;
+}
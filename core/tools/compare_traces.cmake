@@ -0,0 +1,26 @@
+# Runs one replay on the float and the fixed-point headless runner and compares the traces,
+# for ctest. Called with -DHEADLESS, -DHEADLESS_FIXED, -DTRACE_COMPARE, -DPRESET, -DDT,
+# -DSEED, -DTICKS and -DOUTPUT_DIR. Only steps Q16.16 represents exactly are compared, and
+# then the two builds have to agree exactly.
+
+set(ARGS --preset ${PRESET} --dt ${DT} --seed ${SEED} --ticks ${TICKS} --trace-every 10)
+set(FLOAT_TRACE ${OUTPUT_DIR}/trace_${PRESET}_${SEED}_float.txt)
+set(FIXED_TRACE ${OUTPUT_DIR}/trace_${PRESET}_${SEED}_fixed.txt)
+
+execute_process(COMMAND ${HEADLESS} ${ARGS} --trace ${FLOAT_TRACE} OUTPUT_QUIET RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "${HEADLESS} failed")
+endif()
+
+execute_process(COMMAND ${HEADLESS_FIXED} ${ARGS} --trace ${FIXED_TRACE} OUTPUT_QUIET RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "${HEADLESS_FIXED} failed")
+endif()
+
+execute_process(COMMAND ${TRACE_COMPARE} ${FLOAT_TRACE} ${FIXED_TRACE} --tolerance 0 RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "the float and fixed-point traces differ")
+endif()
@@ -0,0 +1,148 @@
+#include "cook_profile.h"
+#include "cooked.h"
+#include "pcm.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+
+#if defined(BREAKOUT_HAS_FREETYPE)
+#include "font_raster.h"
+#endif
+
+// Cooks a port's sounds and fonts into the files its startup loads instead of the
+// source assets: each WAV resampled to the port's mixer rate as 16-bit stereo, and each
+// font rasterized into a glyph atlas, both in the port's byte order. Fonts need FreeType
+// at configure time and are skipped without it. Exits with 1 if anything fails to cook.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--profile NAME|all] [--assets DIR]\n", program);
+    printf("profiles:");
+
+    for (const CookProfile &profile : getCookProfiles())
+    {
+        printf(" %s", profile.name);
+    }
+
+    printf("\n");
+}
+
+long fileSize(const std::string &path)
+{
+    struct stat status;
+
+    return stat(path.c_str(), &status) == 0 ? (long)status.st_size : -1;
+}
+
+// Creates the directories on the way to path's file.
+void createParentDirectories(const std::string &path)
+{
+    for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1))
+    {
+        mkdir(path.substr(0, slash).c_str(), 0755);
+    }
+}
+
+bool cookProfile(const CookProfile &profile, const std::string &assetDirectory)
+{
+    bool isCooked = true;
+
+    printf("%s: %s, %d Hz, %s endian\n", profile.name, assetDirectory.c_str(), profile.rate, profile.isBigEndian ? "big" : "little");
+
+    for (const CookSound &sound : profile.sounds)
+    {
+        std::string source = assetDirectory + "/" + sound.source;
+        std::string cooked = assetDirectory + "/" + sound.cooked;
+
+        PcmSound wav;
+        PcmSound converted;
+
+        createParentDirectories(cooked);
+
+        if (!loadWavFile(source.c_str(), wav))
+        {
+            isCooked = false;
+            continue;
+        }
+
+        convertPcm(wav, profile.rate, 2, converted);
+
+        if (!writeCookedPcm(cooked.c_str(), converted, profile.isBigEndian))
+        {
+            isCooked = false;
+            continue;
+        }
+
+        printf("  %-40s %8ld -> %8ld bytes\n", sound.cooked, fileSize(source), fileSize(cooked));
+    }
+
+    for (const CookFont &font : profile.fonts)
+    {
+#if defined(BREAKOUT_HAS_FREETYPE)
+        std::string source = assetDirectory + "/" + font.source;
+        std::string cooked = assetDirectory + "/" + font.cooked;
+
+        CookedFont atlas;
+
+        createParentDirectories(cooked);
+
+        if (!rasterizeFont(source.c_str(), font.size, profile.atlasWidth, atlas) || !writeCookedFont(cooked.c_str(), atlas, profile.isBigEndian))
+        {
+            isCooked = false;
+            continue;
+        }
+
+        printf("  %-40s %8ld -> %8ld bytes, %dx%d atlas\n", font.cooked, fileSize(source), fileSize(cooked), atlas.atlas.width,
+               atlas.atlas.height);
+#else
+        printf("  %-40s skipped, FreeType wasn't found\n", font.cooked);
+#endif
+    }
+
+    return isCooked;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *profileName = "all";
+    const char *assetDirectory = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+        {
+            profileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc)
+        {
+            assetDirectory = argv[++i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    bool isAll = strcmp(profileName, "all") == 0;
+
+    if ((!isAll && findCookProfile(profileName) == nullptr) || (isAll && assetDirectory != nullptr))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool isCooked = true;
+
+    for (const CookProfile &profile : getCookProfiles())
+    {
+        if (isAll || strcmp(profile.name, profileName) == 0)
+        {
+            std::string directory = assetDirectory != nullptr ? assetDirectory : std::string(BREAKOUT_REPO_DIR) + "/" + profile.assetDirectory;
+            isCooked = cookProfile(profile, directory) && isCooked;
+        }
+    }
+
+    return isCooked ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+#include "game.h"
+#include "presets.h"
+#include <cstdio>
+
+// Sets up single steps of the PC preset by hand and checks what initGame()/updateGame() do
+// with them: the bounces and the events they return, a brick scoring its row's points, a
+// lost life re-serving the ball, countBricks() as bricks go, and a large deltaTime that the
+// swept collision catches and the discrete one steps over. Built against both the float
+// and the fixed-point core. Prints every failed check and exits with 1 if there was one.
+
+const Number TICK = (Number)(1.0 / 120);
+
+int failures = 0;
+
+void check(bool isPassing, const char *name)
+{
+    if (!isPassing)
+    {
+        printf("FAIL: %s\n", name);
+        failures++;
+    }
+}
+
+float toFloat(Number value)
+{
+    return (float)value;
+}
+
+// A PC game with autoplay off and the ball still, so each check only moves what it sets.
+Game makeGame(bool useDiscreteCollision)
+{
+    GameConfig config = PC_CONFIG;
+    config.useDiscreteCollision = useDiscreteCollision;
+
+    Game game;
+    initGame(game, config);
+
+    game.isAutoPlayMode = false;
+    game.ballVelocityX = 0;
+    game.ballVelocityY = 0;
+
+    return game;
+}
+
+int step(Game &game, Number deltaTime)
+{
+    GameInput input = {false, false};
+
+    return updateGame(game, input, deltaTime);
+}
+
+void checkInit()
+{
+    Game game = makeGame(false);
+    const GameConfig &config = game.config;
+
+    check(game.playerLives == config.playerLives && game.playerScore == 0 && game.destroyedBricks == 0, "initGame: lives, score and destroyed bricks");
+    check(countBricks(game.bricks) == config.brickRows * config.brickColumns, "initGame: every brick standing");
+
+    for (int row = 0; row < config.brickRows; row++)
+    {
+        check(game.bricks.rowPoints[row] == config.firstRowPoints - row, "initGame: row points");
+    }
+}
+
+void checkBrickHit(bool useDiscreteCollision)
+{
+    Game game = makeGame(useDiscreteCollision);
+    const GameConfig &config = game.config;
+
+    // Just under column 0 of the bottom row and going up, or already in it for the discrete
+    // rules, which test for overlaps before moving. The rows are closer than a ball's
+    // height, so only below the bottom row does the ball touch a single row.
+    const int row = config.brickRows - 1;
+    Bounds brick = getBrickBounds(config, row, 0);
+
+    game.ball.x = brick.x + 10;
+    game.ball.y = useDiscreteCollision ? brick.y + brick.h - 4 : brick.y + brick.h + 2;
+    game.ballVelocityY = -config.ballVelocityY;
+
+    int bricksBefore = countBricks(game.bricks);
+    int events = step(game, TICK);
+
+    check(events == GAME_EVENT_BRICK_HIT, "brick hit: only GAME_EVENT_BRICK_HIT");
+    check(!isBrickAlive(game.bricks, row, 0), "brick hit: the brick is destroyed");
+    check(game.playerScore == config.firstRowPoints - row, "brick hit: the score adds the row's points");
+    check(game.destroyedBricks == 1, "brick hit: destroyedBricks counts it");
+    check(countBricks(game.bricks) == bricksBefore - 1, "brick hit: countBricks drops by one");
+    check(game.ballVelocityY > 0, "brick hit: the ball turns down");
+}
+
+void checkOneBrickPerStep()
+{
+    Game game = makeGame(true);
+    const GameConfig &config = game.config;
+
+    // Across the gap between columns 0 and 1 of the bottom row, overlapping both.
+    const int row = config.brickRows - 1;
+    Bounds brick = getBrickBounds(config, row, 0);
+
+    game.ball.x = brick.x + brick.w - 10;
+    game.ball.y = brick.y + brick.h - 4;
+    game.ballVelocityY = -config.ballVelocityY;
+
+    int events = step(game, TICK);
+
+    check(events == GAME_EVENT_BRICK_HIT, "two bricks, discrete: GAME_EVENT_BRICK_HIT");
+    check(!isBrickAlive(game.bricks, row, 0) && isBrickAlive(game.bricks, row, 1), "two bricks, discrete: only the first is destroyed");
+    check(game.ballVelocityY > 0, "two bricks, discrete: the ball turns down once");
+}
+
+void checkWallHits(bool useDiscreteCollision)
+{
+    Game game = makeGame(useDiscreteCollision);
+    const GameConfig &config = game.config;
+
+    // Below the bricks and above the paddle, heading left into the wall.
+    game.ball.x = useDiscreteCollision ? -1 : 2;
+    game.ball.y = config.screenHeight / 2;
+    game.ballVelocityX = -config.ballVelocityX;
+
+    int events = step(game, TICK);
+
+    check(events == GAME_EVENT_WALL_HIT, "left wall: only GAME_EVENT_WALL_HIT");
+    check(game.ballVelocityX > 0, "left wall: the ball turns right");
+
+    game.ball.x = config.screenWidth - game.ball.w + (useDiscreteCollision ? 1 : -2);
+    game.ballVelocityX = config.ballVelocityX;
+
+    events = step(game, TICK);
+
+    check(events == GAME_EVENT_WALL_HIT, "right wall: only GAME_EVENT_WALL_HIT");
+    check(game.ballVelocityX < 0, "right wall: the ball turns left");
+    check(toFloat(game.ball.x) <= config.screenWidth - toFloat(game.ball.w) + 1, "right wall: the ball stays on the screen");
+}
+
+void checkCeilingHit(bool useDiscreteCollision)
+{
+    Game game = makeGame(useDiscreteCollision);
+    const GameConfig &config = game.config;
+
+    // Between the top of the screen and the bricks.
+    game.ball.x = config.screenWidth / 2;
+    game.ball.y = useDiscreteCollision ? -1 : 2;
+    game.ballVelocityY = -config.ballVelocityY;
+
+    int events = step(game, TICK);
+
+    check(events == GAME_EVENT_CEILING_HIT, "ceiling: only GAME_EVENT_CEILING_HIT");
+    check(game.ballVelocityY > 0, "ceiling: the ball turns down");
+}
+
+void checkPlayerHit(bool useDiscreteCollision)
+{
+    Game game = makeGame(useDiscreteCollision);
+    const GameConfig &config = game.config;
+
+    game.ball.x = game.player.x + 10;
+    game.ball.y = game.player.y - game.ball.h + (useDiscreteCollision ? 2 : -2);
+    game.ballVelocityY = config.ballVelocityY;
+
+    int events = step(game, TICK);
+
+    check(events == GAME_EVENT_PLAYER_HIT, "paddle: only GAME_EVENT_PLAYER_HIT");
+    check(game.ballVelocityY < 0, "paddle: the ball turns up");
+
+    if (!useDiscreteCollision)
+    {
+        check(firstEventTime(game, events) > 0, "paddle: the hit is timed inside the step");
+
+        // A paddle moved onto the falling ball pushes it out at the start of the step.
+        game.ball.y = game.player.y - 4;
+        game.ballVelocityY = config.ballVelocityY;
+
+        events = step(game, TICK);
+
+        check(events == GAME_EVENT_PLAYER_HIT, "paddle overlap: only GAME_EVENT_PLAYER_HIT");
+        check(game.ballVelocityY < 0, "paddle overlap: the ball turns up");
+        check(firstEventTime(game, events) == 0, "paddle overlap: the hit is at the start of the step");
+    }
+}
+
+void checkLifeLost(bool useDiscreteCollision)
+{
+    Game game = makeGame(useDiscreteCollision);
+    const GameConfig &config = game.config;
+
+    game.ball.y = config.screenHeight + game.ball.h + 10;
+    game.ballVelocityX = config.ballVelocityX;
+    game.ballVelocityY = config.ballVelocityY;
+
+    int events = step(game, TICK);
+
+    check(events == GAME_EVENT_LIFE_LOST, "life lost: only GAME_EVENT_LIFE_LOST");
+    check(game.playerLives == config.playerLives - 1, "life lost: one life less");
+    check(game.ballVelocityX < 0, "life lost: the ball is served the other way");
+
+    // Served back at the start and moved by one tick since.
+    Number servedX = config.ball.x + game.ballVelocityX * TICK;
+    Number servedY = config.ball.y + game.ballVelocityY * TICK;
+
+    check(toFloat(game.ball.x) > toFloat(servedX) - 1 && toFloat(game.ball.x) < toFloat(servedX) + 1 &&
+              toFloat(game.ball.y) > toFloat(servedY) - 1 && toFloat(game.ball.y) < toFloat(servedY) + 1,
+          "life lost: the ball is re-served");
+
+    // With no lives left the ball is still served, but nothing more is taken.
+    game.playerLives = 0;
+    game.ball.y = config.screenHeight + game.ball.h + 10;
+
+    events = step(game, TICK);
+
+    check((events & GAME_EVENT_LIFE_LOST) == 0 && game.playerLives == 0, "no lives left: no GAME_EVENT_LIFE_LOST");
+    check(toFloat(game.ball.y) < config.screenHeight, "no lives left: the ball is re-served");
+}
+
+void checkCountBricks()
+{
+    // Wider than one 32-bit mask, so the count spans words.
+    GameConfig config = PC_CONFIG;
+    config.brickColumns = 40;
+
+    BrickField field;
+    initBrickField(field, config);
+
+    check(countBricks(field) == config.brickRows * 40, "countBricks: full field");
+
+    destroyBrick(field, 0, 0);
+    destroyBrick(field, 0, 31);
+    destroyBrick(field, 0, 32);
+    destroyBrick(field, config.brickRows - 1, 39);
+    destroyBrick(field, config.brickRows - 1, 39);
+
+    check(countBricks(field) == config.brickRows * 40 - 4, "countBricks: after destroying four, one of them twice");
+    check(findNextBrick(field, 0, 31) == 33, "findNextBrick: skips destroyed bricks across words");
+    check(findNextBrick(field, config.brickRows - 1, 39) == -1, "findNextBrick: none left in the row");
+
+    for (int row = 0; row < config.brickRows; row++)
+    {
+        for (int column = 0; column < 40; column++)
+        {
+            destroyBrick(field, row, column);
+        }
+    }
+
+    check(countBricks(field) == 0, "countBricks: empty field");
+}
+
+void checkLargeStep()
+{
+    // Far enough below the bricks that nothing overlaps at the start, going up fast enough
+    // to be past the bottom row after one step.
+    Game swept = makeGame(false);
+    Game discrete = makeGame(true);
+
+    const GameConfig &config = swept.config;
+    const int bottomRow = config.brickRows - 1;
+    Bounds brick = getBrickBounds(config, bottomRow, 0);
+
+    const Number largeStep = (Number)0.5;
+
+    Game *games[2] = {&swept, &discrete};
+
+    for (Game *game : games)
+    {
+        game->ball.x = brick.x + 10;
+        game->ball.y = brick.y + brick.h + 80;
+        game->ballVelocityY = -config.ballVelocityY;
+    }
+
+    int bricksBefore = countBricks(swept.bricks);
+
+    int sweptEvents = step(swept, largeStep);
+    int discreteEvents = step(discrete, largeStep);
+
+    check(sweptEvents == GAME_EVENT_BRICK_HIT, "large step, swept: hits a brick");
+    check(!isBrickAlive(swept.bricks, bottomRow, 0), "large step, swept: the bottom row's brick goes first");
+    check(countBricks(swept.bricks) == bricksBefore - 1, "large step, swept: one brick destroyed");
+    check(swept.ballVelocityY > 0, "large step, swept: the ball turns down");
+
+    check(discreteEvents == GAME_EVENT_NONE, "large step, discrete: no event");
+    check(countBricks(discrete.bricks) == bricksBefore, "large step, discrete: the ball passes the bricks untouched");
+    check(toFloat(discrete.ball.y) < toFloat(brick.y), "large step, discrete: the ball ends above the bottom row");
+}
+
+int main()
+{
+    checkInit();
+
+    for (int discrete = 0; discrete < 2; discrete++)
+    {
+        checkBrickHit(discrete != 0);
+        checkWallHits(discrete != 0);
+        checkCeilingHit(discrete != 0);
+        checkPlayerHit(discrete != 0);
+        checkLifeLost(discrete != 0);
+    }
+
+    checkOneBrickPerStep();
+    checkCountBricks();
+    checkLargeStep();
+
+    if (failures > 0)
+    {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+
+    return 0;
+}
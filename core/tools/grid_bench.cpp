@@ -0,0 +1,135 @@
+#include "game.h"
+#include "presets.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Times updateGame() on brick fields from the PC layout up to 100k bricks, next to a
+// pass that sweeps the ball against every brick like the game did before the grid.
+// The grid keeps the cost per tick flat, the full pass grows with the brick count.
+
+const int BRICK_COUNTS[] = {120, 1000, 10000, 100000};
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--ticks N] [--dt SECONDS] [--seed N]\n", program);
+}
+
+GameConfig createFieldConfig(int brickCount)
+{
+    GameConfig config = PC_CONFIG;
+
+    if (brickCount <= config.brickRows * config.brickColumns)
+    {
+        return config;
+    }
+
+    // Small bricks in a field twice as wide as it is deep, with room below for the paddle.
+    config.brickWidth = 12;
+    config.brickHeight = 6;
+    config.brickSpacingX = 14;
+    config.brickSpacingY = 8;
+    config.brickColumns = (int)ceil(sqrt(brickCount * 2.0));
+    config.brickRows = (brickCount + config.brickColumns - 1) / config.brickColumns;
+
+    config.screenWidth = config.brickColumns * 14;
+    config.screenHeight = 40 + config.brickRows * 8 + 400;
+
+    config.player.y = (Number)(config.screenHeight - 32);
+    config.ball.x = (Number)(config.screenWidth / 2);
+    config.ball.y = (Number)(config.screenHeight - 200);
+
+    return config;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int ticks = 20000;
+    float deltaTime = 1.0f / 120.0f;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            ticks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc)
+        {
+            deltaTime = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%8s %8s %14s %14s %12s\n", "bricks", "hit", "grid ns/tick", "full ns/tick", "speedup");
+
+    for (int brickCount : BRICK_COUNTS)
+    {
+        GameConfig config = createFieldConfig(brickCount);
+
+        Game game;
+        initGame(game, config);
+        serveBall(game, seed);
+
+        GameInput input = {false, false};
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            updateGame(game, input, deltaTime);
+        }
+
+        double gridSeconds = secondsSince(start);
+
+        // Replays the brick part of a step against every brick of the final field.
+        Number deltaX = game.ballVelocityX * deltaTime;
+        Number deltaY = game.ballVelocityY * deltaTime;
+        // volatile so the compiler keeps the tests it would otherwise find unused.
+        volatile int contacts = 0;
+
+        start = std::chrono::steady_clock::now();
+
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            for (int row = 0; row < game.bricks.rows; row++)
+            {
+                for (int column = findNextBrick(game.bricks, row, 0); column >= 0; column = findNextBrick(game.bricks, row, column + 1))
+                {
+                    Number time;
+                    bool isSide;
+
+                    if (sweepBounds(game.ball, deltaX, deltaY, getBrickBounds(config, row, column), time, isSide))
+                    {
+                        contacts++;
+                    }
+                }
+            }
+        }
+
+        double fullSeconds = secondsSince(start);
+
+        double gridNanoseconds = gridSeconds * 1e9 / ticks;
+        double fullNanoseconds = fullSeconds * 1e9 / ticks;
+
+        printf("%8d %8d %14.1f %14.1f %11.1fx\n", game.bricks.rows * game.bricks.columns, game.destroyedBricks, gridNanoseconds, fullNanoseconds,
+               fullNanoseconds / gridNanoseconds);
+    }
+
+    return 0;
+}
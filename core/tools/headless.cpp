@@ -0,0 +1,210 @@
+#include "game.h"
+#include "presets.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER
+#endif
+
+// Runs updateGame() with a port preset as fast as it can: no window, renderer,
+// audio or fonts. The paddle is on autoplay, so the seed alone decides the game.
+// With --trace it also writes the ball state every few ticks, so a float build and a
+// fixed-point build of the same replay can be compared with breakout_trace_compare.
+// --check-collisions counts steps that end with the ball inside a standing brick or
+// past a side wall, which is what large steps do to the discrete rules.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--ticks N] [--seed N] [--dt SECONDS] [--preset NAME] [--trace FILE] [--trace-every N] [--discrete] [--check-collisions]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    long long ticks = 1000000;
+    unsigned int seed = 1;
+    float deltaTime = 1.0f / 60.0f;
+    const char *presetName = "pc";
+    const char *tracePath = nullptr;
+    long long traceEvery = 1;
+    bool useDiscreteCollision = false;
+    bool checkCollisions = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            ticks = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc)
+        {
+            deltaTime = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--preset") == 0 && i + 1 < argc)
+        {
+            presetName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trace-every") == 0 && i + 1 < argc)
+        {
+            traceEvery = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--discrete") == 0)
+        {
+            useDiscreteCollision = true;
+        }
+        else if (strcmp(argv[i], "--check-collisions") == 0)
+        {
+            checkCollisions = true;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const GameConfig *config = findPreset(presetName);
+
+    if (ticks <= 0 || deltaTime <= 0 || traceEvery <= 0 || config == nullptr)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE *trace = nullptr;
+
+    if (tracePath != nullptr)
+    {
+        trace = fopen(tracePath, "w");
+
+        if (trace == nullptr)
+        {
+            printf("Failed to open trace file %s\n", tracePath);
+            return 1;
+        }
+    }
+
+    GameConfig gameConfig = *config;
+    gameConfig.useDiscreteCollision = useDiscreteCollision;
+
+    Game game;
+    initGame(game, gameConfig);
+    serveBall(game, seed);
+
+    GameInput input = {false, false};
+    Number step = deltaTime;
+
+    long long stepsInsideBrick = 0;
+    long long stepsPastWall = 0;
+    double seconds = 0;
+    unsigned long long cycles = 0;
+
+    for (long long tick = 0; tick < ticks;)
+    {
+        // Time in chunks between trace points and checks so they are not measured.
+        long long chunkEnd = ticks;
+
+        if (checkCollisions)
+        {
+            chunkEnd = tick + 1;
+        }
+        else if (trace != nullptr)
+        {
+            chunkEnd = tick + traceEvery;
+        }
+
+        if (chunkEnd > ticks)
+        {
+            chunkEnd = ticks;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+#if defined(HAS_CYCLE_COUNTER)
+        unsigned long long startCycles = __rdtsc();
+#endif
+
+        for (; tick < chunkEnd; tick++)
+        {
+            updateGame(game, input, step);
+        }
+
+#if defined(HAS_CYCLE_COUNTER)
+        cycles += __rdtsc() - startCycles;
+#endif
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (checkCollisions)
+        {
+            bool isInsideBrick = false;
+
+            for (int row = 0; row < game.bricks.rows && !isInsideBrick; row++)
+            {
+                for (int column = findNextBrick(game.bricks, row, 0); column >= 0 && !isInsideBrick; column = findNextBrick(game.bricks, row, column + 1))
+                {
+                    isInsideBrick = hasCollision(getBrickBounds(gameConfig, row, column), game.ball);
+                }
+            }
+
+            if (isInsideBrick)
+            {
+                stepsInsideBrick++;
+            }
+
+            if (game.ball.x < 0 || game.ball.x > gameConfig.screenWidth - game.ball.w)
+            {
+                stepsPastWall++;
+            }
+        }
+
+        if (trace != nullptr && tick % traceEvery == 0)
+        {
+            fprintf(trace, "%lld %.5f %.5f %d %d\n", tick, (double)game.ball.x, (double)game.ball.y, game.playerScore, game.playerLives);
+        }
+    }
+
+    if (trace != nullptr)
+    {
+        fclose(trace);
+    }
+
+    double ticksPerSecond = ticks / seconds;
+
+#if defined(BREAKOUT_FIXED_POINT)
+    printf("number type: Q16.16 fixed point\n");
+#else
+    printf("number type: float\n");
+#endif
+    printf("collision: %s\n", useDiscreteCollision ? "discrete" : "swept");
+    printf("preset: %s\n", presetName);
+    printf("ticks: %lld\n", ticks);
+    printf("seed: %u\n", seed);
+    printf("dt: %f\n", deltaTime);
+    printf("bricks hit: %d\n", game.destroyedBricks);
+    printf("score: %d\n", game.playerScore);
+    printf("lives: %d\n", game.playerLives);
+    printf("wall time: %.3f s\n", seconds);
+    printf("ticks per second: %.0f\n", ticksPerSecond);
+    printf("game seconds per wall second: %.0f\n", ticksPerSecond * deltaTime);
+#if defined(HAS_CYCLE_COUNTER)
+    printf("cycles per tick: %.1f\n", (double)cycles / ticks);
+#endif
+
+    if (checkCollisions)
+    {
+        printf("steps ending inside a brick: %lld\n", stepsInsideBrick);
+        printf("steps ending past a side wall: %lld\n", stepsPastWall);
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "frame_capture.h"
+#include "game.h"
+#include "presets.h"
+#include "scene.h"
+#include "soft_renderer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Plays an autoplay game with the PC preset and draws every frame with SoftRenderer, so a
+// headless run can be watched afterwards: --capture out.y4m (or out.raw) hands each frame
+// to FrameCapture's writer thread. Frames are paced to --fps like a window with vsync
+// would be; --unpaced runs them back to back, which shows what happens when the disk
+// can't keep up. Prints the render time and what capture added to every frame, and how
+// many frames were written and dropped.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--frames N] [--seed N] [--size WxH] [--threads N] [--fps N] [--unpaced] [--capture out.raw|out.y4m] [--buffers N]\n",
+           program);
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 600;
+    unsigned int seed = 1;
+    int width = 960;
+    int height = 544;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    int framesPerSecond = 60;
+    bool isPaced = true;
+    const char *capturePath = nullptr;
+    int bufferCount = 8;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &width, &height) == 2)
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            framesPerSecond = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--unpaced") == 0)
+        {
+            isPaced = false;
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+        {
+            capturePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--buffers") == 0 && i + 1 < argc)
+        {
+            bufferCount = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames <= 0 || width <= 0 || height <= 0 || framesPerSecond <= 0 || bufferCount <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    GlyphAtlas atlas;
+    AlphaImage mask;
+    createTestGlyphs(atlas, mask);
+
+    ThreadPool pool(threadCount > 0 ? threadCount : 1);
+    SoftRenderer renderer(width, height, &pool);
+    SoftCanvas canvas(renderer, mask);
+
+    FrameCapture capture;
+
+    if (capturePath != nullptr && !capture.open(capturePath, width, height, framesPerSecond, bufferCount))
+    {
+        return 1;
+    }
+
+    Game game;
+    initGame(game, PC_CONFIG);
+    serveBall(game, seed);
+
+    float scaleX = width / (float)PC_CONFIG.screenWidth;
+    float scaleY = height / (float)PC_CONFIG.screenHeight;
+
+    // Two 120 Hz ticks per 60 Hz frame, like the PC port.
+    const int TICKS_PER_FRAME = 2;
+    float deltaTime = 1.0f / (framesPerSecond * TICKS_PER_FRAME);
+
+    GameInput input = {false, false};
+    double renderSeconds = 0;
+
+    auto frameDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond));
+    auto nextFrame = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (int tick = 0; tick < TICKS_PER_FRAME; tick++)
+        {
+            updateGame(game, input, deltaTime);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        drawGameScene(canvas, game, atlas, scaleX, scaleY);
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (capturePath != nullptr)
+        {
+            capture.submit(renderer.framebuffer().pixels.data());
+        }
+
+        if (isPaced)
+        {
+            nextFrame += frameDuration;
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+
+    printf("frames: %d, %dx%d, %d threads, score %d, lives %d\n", frames, width, height, pool.threadCount(), game.playerScore,
+           game.playerLives);
+    printf("render: %.1f us/frame\n", renderSeconds * 1e6 / frames);
+
+    if (capturePath != nullptr)
+    {
+        // The ring is drained before the counts are read, so written + dropped = frames.
+        capture.close();
+
+        printf("capture: %.1f us/frame, %lld written, %lld dropped (%d buffers) to %s\n", capture.submitSeconds() * 1e6 / frames,
+               capture.writtenFrames(), capture.droppedFrames(), bufferCount, capturePath);
+    }
+
+    return 0;
+}
@@ -0,0 +1,338 @@
+#include "mixer.h"
+#include "pcm.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(BREAKOUT_HAS_SDL)
+#include <SDL.h>
+#endif
+
+// Loads the PC port's magic.wav and drop.wav, converts them to the mixer's format and
+// prints the cost of mixing one buffer of each --buffers size with each --voices count
+// busy, as microseconds and as a share of the buffer's own playing time. When SDL2 was
+// found at configure time the mixer also runs as the callback of SDL's dummy audio driver
+// for --seconds, the way the port opens the device. Checks the SIMD saturating adds
+// against the plain loop and exits with 1 on a mismatch.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--sounds DIR] [--rate HZ] [--buffers 256,512,...] [--voices 1,8,32,...] [--seconds N]\n", program);
+}
+
+std::vector<int> parseList(const char *text)
+{
+    std::vector<int> values;
+    std::string list = text;
+
+    size_t start = 0;
+
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+
+        values.push_back(atoi(list.substr(start, end - start).c_str()));
+        start = end + 1;
+    }
+
+    return values;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Random samples near full scale so the adds saturate often, at odd counts so the
+// scalar tail after the SIMD loop is covered too.
+bool checkSaturatingAdds()
+{
+    const int volumes[] = {MIXER_FULL_VOLUME, 200, 128, 1, 0};
+    unsigned int state = 1;
+
+    for (int count = 0; count < 300; count += 7)
+    {
+        for (int volume : volumes)
+        {
+            std::vector<int16_t> input(count);
+            std::vector<int16_t> simd(count);
+
+            for (int i = 0; i < count; i++)
+            {
+                state = state * 1103515245 + 12345;
+                input[i] = (int16_t)(state >> 8);
+                state = state * 1103515245 + 12345;
+                simd[i] = (int16_t)(state >> 8);
+            }
+
+            std::vector<int16_t> scalar = simd;
+
+            addSaturating(simd.data(), input.data(), count, volume);
+            addSaturatingScalar(scalar.data(), input.data(), count, volume);
+
+            if (simd != scalar)
+            {
+                printf("SIMD saturating add differs from the scalar one for %d samples at volume %d\n", count, volume);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Keeps every voice playing by restarting the ones that finished, alternating sounds.
+void restartVoices(const Mixer &mixer, SpscQueue<MixerCommand> &commands)
+{
+    for (int voice = 0; voice < (int)mixer.voices.size(); voice++)
+    {
+        if (mixer.voices[voice].sound < 0)
+        {
+            MixerCommand command = {voice, voice % (int)mixer.sounds.size(), MIXER_FULL_VOLUME};
+            commands.push(command);
+        }
+    }
+}
+
+#if defined(BREAKOUT_HAS_SDL)
+
+typedef struct
+{
+    Mixer *mixer;
+    SpscQueue<MixerCommand> *commands;
+    long long callbacks;
+    double callbackSeconds;
+    double maxCallbackSeconds;
+} DeviceState;
+
+void mixCallback(void *userdata, Uint8 *stream, int length)
+{
+    DeviceState &state = *(DeviceState *)userdata;
+
+    auto start = std::chrono::steady_clock::now();
+    mixAudio(*state.mixer, *state.commands, (int16_t *)stream, length / (MIXER_CHANNELS * (int)sizeof(int16_t)), 0);
+    double seconds = secondsSince(start);
+
+    state.callbacks++;
+    state.callbackSeconds += seconds;
+    state.maxCallbackSeconds = seconds > state.maxCallbackSeconds ? seconds : state.maxCallbackSeconds;
+}
+
+// The dummy driver doesn't play anything but calls back at the device's pace.
+void runDummyDevice(const std::vector<PcmSound> &sources, int rate, int bufferFrames, int voiceCount, double seconds)
+{
+    SDL_AudioSpec desired = {};
+    desired.freq = rate;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = MIXER_CHANNELS;
+    desired.samples = (Uint16)bufferFrames;
+    desired.callback = mixCallback;
+
+    Mixer mixer;
+    SpscQueue<MixerCommand> commands(256);
+    DeviceState state = {&mixer, &commands, 0, 0, 0};
+    desired.userdata = &state;
+
+    SDL_AudioSpec obtained;
+    SDL_AudioDeviceID device = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+
+    if (device == 0)
+    {
+        printf("Unable to open the dummy audio device! SDL Error: %s\n", SDL_GetError());
+        return;
+    }
+
+    initMixer(mixer, obtained.freq, voiceCount);
+
+    for (const PcmSound &source : sources)
+    {
+        addMixerSound(mixer, source);
+    }
+
+    SDL_PauseAudioDevice(device, 0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (secondsSince(start) < seconds)
+    {
+        SDL_LockAudioDevice(device);
+        restartVoices(mixer, commands);
+        SDL_UnlockAudioDevice(device);
+
+        SDL_Delay(5);
+    }
+
+    SDL_CloseAudioDevice(device);
+
+    double bufferSeconds = (double)obtained.samples / obtained.freq;
+
+    printf("%8d %8d %12lld %12.1f %12.1f %9.2f%%\n", obtained.samples, voiceCount, state.callbacks,
+           state.callbacks > 0 ? state.callbackSeconds * 1e6 / state.callbacks : 0.0, state.maxCallbackSeconds * 1e6,
+           state.callbacks > 0 ? state.callbackSeconds / state.callbacks / bufferSeconds * 100 : 0.0);
+}
+
+#endif
+
+int main(int argc, char *argv[])
+{
+    std::string soundsDirectory = BREAKOUT_SOUNDS_DIR;
+    int rate = 48000;
+    std::vector<int> bufferSizes = {256, 512};
+    std::vector<int> voiceCounts = {1, 8, 32};
+    double seconds = 2;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sounds") == 0 && i + 1 < argc)
+        {
+            soundsDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+        {
+            rate = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--buffers") == 0 && i + 1 < argc)
+        {
+            bufferSizes = parseList(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--voices") == 0 && i + 1 < argc)
+        {
+            voiceCounts = parseList(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (rate <= 0 || seconds <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool isValid = checkSaturatingAdds();
+
+    const char *names[] = {"magic.wav", "drop.wav"};
+    std::vector<PcmSound> sources;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (const char *name : names)
+    {
+        PcmSound source;
+
+        if (!loadWavFile((soundsDirectory + "/" + name).c_str(), source))
+        {
+            return 1;
+        }
+
+        sources.push_back(source);
+    }
+
+    double loadSeconds = secondsSince(start);
+
+    Mixer converted;
+    initMixer(converted, rate, 1);
+
+    start = std::chrono::steady_clock::now();
+
+    for (const PcmSound &source : sources)
+    {
+        addMixerSound(converted, source);
+    }
+
+    double convertSeconds = secondsSince(start);
+
+    for (int i = 0; i < (int)sources.size(); i++)
+    {
+        printf("%s: %d Hz %d channels %d frames -> %d Hz stereo %d frames\n", names[i], sources[i].rate, sources[i].channels,
+               pcmFrameCount(sources[i]), rate, pcmFrameCount(converted.sounds[i]));
+    }
+
+    printf("load %.2f ms, convert %.2f ms\n\n", loadSeconds * 1e3, convertSeconds * 1e3);
+
+    printf("%8s %8s %12s %12s\n", "buffer", "voices", "mix us", "of buffer");
+
+    for (int bufferFrames : bufferSizes)
+    {
+        if (bufferFrames <= 0)
+        {
+            continue;
+        }
+
+        std::vector<int16_t> output(bufferFrames * MIXER_CHANNELS);
+        double bufferSeconds = (double)bufferFrames / rate;
+
+        // As many buffers as --seconds of audio, at least a thousand for steady timings.
+        int buffers = (int)(seconds / bufferSeconds);
+        buffers = buffers < 1000 ? 1000 : buffers;
+
+        for (int voiceCount : voiceCounts)
+        {
+            if (voiceCount <= 0)
+            {
+                continue;
+            }
+
+            Mixer mixer;
+            initMixer(mixer, rate, voiceCount);
+            mixer.sounds = converted.sounds;
+
+            SpscQueue<MixerCommand> commands(256);
+            double mixSeconds = 0;
+
+            for (int buffer = 0; buffer < buffers; buffer++)
+            {
+                restartVoices(mixer, commands);
+
+                start = std::chrono::steady_clock::now();
+                mixAudio(mixer, commands, output.data(), bufferFrames, 0);
+                mixSeconds += secondsSince(start);
+            }
+
+            printf("%8d %8d %12.2f %11.3f%%\n", bufferFrames, voiceCount, mixSeconds * 1e6 / buffers, mixSeconds / buffers / bufferSeconds * 100);
+        }
+    }
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0)
+    {
+        printf("Unable to initialize SDL audio! SDL Error: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    printf("\nSDL %s driver, %.1f s per run\n", SDL_GetCurrentAudioDriver(), seconds);
+    printf("%8s %8s %12s %12s %12s %10s\n", "buffer", "voices", "callbacks", "callback us", "max us", "of buffer");
+
+    for (int bufferFrames : bufferSizes)
+    {
+        for (int voiceCount : voiceCounts)
+        {
+            if (bufferFrames > 0 && voiceCount > 0)
+            {
+                runDummyDevice(sources, rate, bufferFrames, voiceCount, seconds);
+            }
+        }
+    }
+
+    SDL_Quit();
+#endif
+
+    return isValid ? 0 : 1;
+}
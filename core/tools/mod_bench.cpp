@@ -0,0 +1,165 @@
+#include "mod_player.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Renders the NDS port's two modules for --seconds at --rate, --buffer frames at a time,
+// once with the SIMD resampling and once with the plain loops, and prints the render time
+// per second of audio. Checks every frame of the two renders against each other and, at
+// the default settings, a checksum of the render against the one it had when the player
+// was written. Exits with 1 on a mismatch.
+
+typedef struct
+{
+    const char *name;
+
+    // FNV-1a of the first 30 seconds at 48 kHz, 256 frames at a time.
+    uint64_t checksum;
+} ModTrack;
+
+const ModTrack TRACKS[] = {
+    {"Darkstone.mod", 0x78724b137499cc3dull},
+    {"FlatOutLies.mod", 0xe370848570ba8951ull},
+};
+
+const int CHECKSUM_RATE = 48000;
+const double CHECKSUM_SECONDS = 30;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--modules DIR] [--rate HZ] [--buffer FRAMES] [--seconds N]\n", program);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint64_t hashSamples(uint64_t hash, const int16_t *samples, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        hash = (hash ^ (uint16_t)samples[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// The whole render, and the seconds spent in ModPlayer::render.
+double renderModule(ModPlayer &player, int bufferFrames, long frames, std::vector<int16_t> &output)
+{
+    output.assign(frames * 2, 0);
+    double renderSeconds = 0;
+
+    for (long done = 0; done < frames;)
+    {
+        int count = frames - done < bufferFrames ? (int)(frames - done) : bufferFrames;
+
+        auto start = std::chrono::steady_clock::now();
+        int rendered = player.render(output.data() + done * 2, count);
+        renderSeconds += secondsSince(start);
+
+        if (rendered < count)
+        {
+            break;
+        }
+
+        done += count;
+    }
+
+    return renderSeconds;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string modulesDirectory = BREAKOUT_REPO_DIR "/breakout/sounds";
+    int rate = CHECKSUM_RATE;
+    int bufferFrames = 256;
+    double seconds = CHECKSUM_SECONDS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--modules") == 0 && i + 1 < argc)
+        {
+            modulesDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+        {
+            rate = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--buffer") == 0 && i + 1 < argc)
+        {
+            bufferFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (rate <= 0 || bufferFrames <= 0 || seconds <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // The checksum doesn't depend on the buffer size, the tick boundaries split the
+    // render the same way whatever it is.
+    bool isChecksumRun = rate == CHECKSUM_RATE && seconds == CHECKSUM_SECONDS;
+    long frames = (long)(seconds * rate);
+    bool isValid = true;
+
+    printf("%ld frames at %d Hz, %d frames per render\n\n", frames, rate, bufferFrames);
+    printf("%-16s %8s %14s %14s %10s %16s\n", "module", "mixing", "us per second", "realtime", "frames", "checksum");
+
+    for (const ModTrack &track : TRACKS)
+    {
+        std::string path = modulesDirectory + "/" + track.name;
+        std::vector<int16_t> renders[2];
+        const char *mixings[2] = {"simd", "scalar"};
+
+        for (int mixing = 0; mixing < 2; mixing++)
+        {
+            ModPlayer player;
+
+            if (!player.loadFile(path.c_str(), rate, true))
+            {
+                return 1;
+            }
+
+            player.setScalarMixing(mixing == 1);
+
+            double renderSeconds = renderModule(player, bufferFrames, frames, renders[mixing]);
+            uint64_t checksum = hashSamples(14695981039346656037ull, renders[mixing].data(), (int)renders[mixing].size());
+
+            printf("%-16s %8s %14.1f %13.0fx %10ld %016llx\n", track.name, mixings[mixing], renderSeconds * 1e6 / seconds, seconds / renderSeconds,
+                   frames, (unsigned long long)checksum);
+
+            if (isChecksumRun && checksum != track.checksum)
+            {
+                printf("%s: the %s render's checksum should be %016llx!\n", track.name, mixings[mixing], (unsigned long long)track.checksum);
+                isValid = false;
+            }
+        }
+
+        for (size_t i = 0; i < renders[0].size(); i++)
+        {
+            if (renders[0][i] != renders[1][i])
+            {
+                printf("%s: the SIMD and scalar renders differ at frame %zu!\n", track.name, i / 2);
+                isValid = false;
+                break;
+            }
+        }
+    }
+
+    return isValid ? 0 : 1;
+}
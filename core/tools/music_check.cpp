@@ -0,0 +1,307 @@
+#include "mixer.h"
+#include "music_stream.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Writes a --track-seconds WAV of generated 44.1 kHz stereo and streams it two ways.
+// First through the stream at its own rate on one thread, checking every frame that
+// comes out of the ring against the generator and that resident memory doesn't grow with
+// the track. Then for --seconds in real time the way a port plays it: resampled to 48 kHz
+// on a decode thread filling the ring, and a callback thread mixing --buffer frames at a
+// time, with the decoder stalling for --stall-ms every --stall-every fills. Prints the
+// underruns, and exits with 1 if a frame differs, if a stall shorter than the ring
+// underran, or if one longer than the ring didn't.
+
+const int TRACK_RATE = 44100;
+const int OUTPUT_RATE = 48000;
+
+// Milliseconds of scheduling slack before a stall counts as shorter or longer than the ring.
+const double STALL_MARGIN_MS = 20;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--track PATH] [--track-seconds N] [--seconds N] [--ring FRAMES] [--buffer FRAMES] [--stall-ms N] [--stall-every N]\n",
+           program);
+}
+
+// Any sample of any frame, without keeping the track in memory.
+int16_t trackSample(long frame, int channel)
+{
+    unsigned int state = (unsigned int)frame * 2654435761u + channel * 40503u;
+    state ^= state >> 15;
+    state *= 2246822519u;
+    state ^= state >> 13;
+
+    return (int16_t)(state >> 16);
+}
+
+void writeLittle32(FILE *file, uint32_t value)
+{
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    fwrite(bytes, 1, 4, file);
+}
+
+void writeLittle16(FILE *file, uint16_t value)
+{
+    uint8_t bytes[2] = {(uint8_t)value, (uint8_t)(value >> 8)};
+    fwrite(bytes, 1, 2, file);
+}
+
+bool writeTrack(const char *path, long frames)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == nullptr)
+    {
+        printf("Unable to create %s!\n", path);
+        return false;
+    }
+
+    uint32_t dataSize = (uint32_t)(frames * 4);
+
+    fwrite("RIFF", 1, 4, file);
+    writeLittle32(file, 36 + dataSize);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLittle32(file, 16);
+    writeLittle16(file, 1);
+    writeLittle16(file, 2);
+    writeLittle32(file, TRACK_RATE);
+    writeLittle32(file, TRACK_RATE * 4);
+    writeLittle16(file, 4);
+    writeLittle16(file, 16);
+    fwrite("data", 1, 4, file);
+    writeLittle32(file, dataSize);
+
+    std::vector<uint8_t> block(4096 * 4);
+
+    for (long start = 0; start < frames; start += 4096)
+    {
+        long count = frames - start < 4096 ? frames - start : 4096;
+
+        for (long i = 0; i < count; i++)
+        {
+            for (int channel = 0; channel < 2; channel++)
+            {
+                uint16_t sample = (uint16_t)trackSample(start + i, channel);
+                block[i * 4 + channel * 2] = (uint8_t)sample;
+                block[i * 4 + channel * 2 + 1] = (uint8_t)(sample >> 8);
+            }
+        }
+
+        fwrite(block.data(), 1, count * 4, file);
+    }
+
+    return fclose(file) == 0;
+}
+
+long residentKilobytes()
+{
+    long pages = 0;
+    long resident = 0;
+    FILE *file = fopen("/proc/self/statm", "r");
+
+    if (file != nullptr)
+    {
+        if (fscanf(file, "%ld %ld", &pages, &resident) != 2)
+        {
+            resident = 0;
+        }
+
+        fclose(file);
+    }
+
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// The whole track through the ring at its own rate, which must come out unchanged.
+bool checkFrames(const char *path, long frames, int ringFrames, int bufferFrames)
+{
+    WavMusic music;
+
+    if (!music.open(path, TRACK_RATE, false))
+    {
+        return false;
+    }
+
+    MusicStream stream(ringFrames);
+    std::vector<int16_t> output((size_t)bufferFrames * MIXER_CHANNELS);
+
+    long residentBefore = residentKilobytes();
+    long played = 0;
+
+    while (played < frames)
+    {
+        stream.fill(music);
+
+        std::fill(output.begin(), output.end(), 0);
+        stream.mix(output.data(), bufferFrames, MIXER_FULL_VOLUME);
+
+        for (int i = 0; i < bufferFrames && played < frames; i++, played++)
+        {
+            if (output[i * 2] != trackSample(played, 0) || output[i * 2 + 1] != trackSample(played, 1))
+            {
+                printf("Frame %ld came out of the ring as (%d, %d) instead of (%d, %d)\n", played, output[i * 2], output[i * 2 + 1],
+                       trackSample(played, 0), trackSample(played, 1));
+                return false;
+            }
+        }
+    }
+
+    stream.fill(music);
+
+    printf("%ld frames streamed unchanged, track ended: %s, resident memory grew %ld KiB\n", played, stream.hasEnded() ? "yes" : "no",
+           residentKilobytes() - residentBefore);
+
+    return stream.hasEnded() && stream.underrunCount() == 0;
+}
+
+typedef struct
+{
+    long long fills;
+    long long decodedFrames;
+    double decodeSeconds;
+} DecodeStats;
+
+int main(int argc, char *argv[])
+{
+    std::string track = "/tmp/breakout_music_check.wav";
+    double trackSeconds = 120;
+    double seconds = 3;
+    int ringFrames = 8192;
+    int bufferFrames = 256;
+    int stallMilliseconds = 0;
+    int stallEvery = 50;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--track") == 0 && i + 1 < argc)
+        {
+            track = argv[++i];
+        }
+        else if (strcmp(argv[i], "--track-seconds") == 0 && i + 1 < argc)
+        {
+            trackSeconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ring") == 0 && i + 1 < argc)
+        {
+            ringFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--buffer") == 0 && i + 1 < argc)
+        {
+            bufferFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stall-ms") == 0 && i + 1 < argc)
+        {
+            stallMilliseconds = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stall-every") == 0 && i + 1 < argc)
+        {
+            stallEvery = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (trackSeconds <= 0 || seconds <= 0 || ringFrames <= 0 || bufferFrames <= 0 || stallMilliseconds < 0 || stallEvery <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    long trackFrames = (long)(trackSeconds * TRACK_RATE);
+
+    if (!writeTrack(track.c_str(), trackFrames))
+    {
+        return 1;
+    }
+
+    bool isValid = checkFrames(track.c_str(), trackFrames, ringFrames, bufferFrames);
+
+    WavMusic music;
+
+    if (!music.open(track.c_str(), OUTPUT_RATE, true))
+    {
+        return 1;
+    }
+
+    MusicStream stream(ringFrames);
+    stream.fill(music);
+
+    std::atomic<bool> isRunning(true);
+    DecodeStats decode = {0, 0, 0};
+
+    // Wakes often enough to top the ring up long before it runs dry.
+    std::thread decoder([&]() {
+        while (isRunning.load())
+        {
+            auto start = std::chrono::steady_clock::now();
+            decode.decodedFrames += stream.fill(music);
+            decode.decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            decode.fills++;
+
+            if (stallMilliseconds > 0 && decode.fills % stallEvery == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(stallMilliseconds));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    long residentBefore = residentKilobytes();
+
+    std::vector<int16_t> output((size_t)bufferFrames * MIXER_CHANNELS);
+    auto bufferDuration = std::chrono::duration<double>((double)bufferFrames / OUTPUT_RATE);
+    int buffers = (int)(seconds * OUTPUT_RATE / bufferFrames);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int buffer = 0; buffer < buffers; buffer++)
+    {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(bufferDuration * buffer));
+
+        std::fill(output.begin(), output.end(), 0);
+        stream.mix(output.data(), bufferFrames, MIXER_FULL_VOLUME);
+    }
+
+    isRunning = false;
+    decoder.join();
+
+    double ringMilliseconds = 1000.0 * ringFrames / OUTPUT_RATE;
+
+    printf("\n%.1f s at %d Hz, %d-frame buffers, %d-frame ring (%.0f ms), %d ms stall every %d fills\n", seconds, OUTPUT_RATE, bufferFrames,
+           ringFrames, ringMilliseconds, stallMilliseconds, stallEvery);
+    printf("decoded %lld frames in %lld fills, %.1f us per fill\n", decode.decodedFrames, decode.fills,
+           decode.fills > 0 ? decode.decodeSeconds * 1e6 / decode.fills : 0.0);
+    printf("underruns: %lld, silent frames: %lld, resident memory grew %ld KiB\n", stream.underrunCount(), stream.missingFrameCount(),
+           residentKilobytes() - residentBefore);
+
+    if (stallMilliseconds + STALL_MARGIN_MS < ringMilliseconds && stream.underrunCount() > 0)
+    {
+        printf("The ring underran with stalls shorter than it\n");
+        isValid = false;
+    }
+
+    if (stallMilliseconds > ringMilliseconds + STALL_MARGIN_MS && stream.underrunCount() == 0)
+    {
+        printf("Stalls longer than the ring didn't underrun\n");
+        isValid = false;
+    }
+
+    remove(track.c_str());
+
+    return isValid ? 0 : 1;
+}
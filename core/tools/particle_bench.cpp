@@ -0,0 +1,263 @@
+#include "game.h"
+#include "particles.h"
+#include "presets.h"
+#include "soft_renderer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(BREAKOUT_HAS_SDL)
+#include <SDL.h>
+#endif
+
+// Keeps a particle pool at each --counts size by bursting particles out of random bricks
+// of the PC layout every frame, and prints the cost of a 60 Hz frame: emitting, updating
+// and writing the vertices for the port's one geometry call, and rasterizing the squares
+// with the software renderer on one thread. When SDL2 was found at configure time the
+// vertices also go through SDL_RenderGeometryRaw() on SDL's software renderer. Checks the
+// SIMD update against the plain loop and exits with 1 on a mismatch.
+
+const int BURST_SIZE = 64;
+const float BURST_SPEED = 240.0f;
+const float BURST_LIFE = 1.0f;
+const float GRAVITY = 600.0f;
+const float PARTICLE_SIZE = 3.0f;
+const float FRAME_SECONDS = 1.0f / 60.0f;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--frames N] [--counts 1000,10000,50000,...]\n", program);
+}
+
+std::vector<int> parseCounts(const char *text)
+{
+    std::vector<int> counts;
+    std::string list = text;
+
+    size_t start = 0;
+
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+
+        counts.push_back(atoi(list.substr(start, end - start).c_str()));
+        start = end + 1;
+    }
+
+    return counts;
+}
+
+// Bursts out of random bricks until the pool holds count particles.
+void refillPool(ParticlePool &pool, int count, unsigned int &state)
+{
+    const GameConfig &config = PC_CONFIG;
+
+    while (pool.count < count)
+    {
+        state = state * 1103515245 + 12345;
+
+        int row = (state >> 8) % config.brickRows;
+        int column = (state >> 16) % config.brickColumns;
+        uint32_t color = row % 2 == 0 ? 0xff00ffff : 0xffff8000;
+
+        emitParticleBurst(pool, getBrickBounds(config, row, column), count - pool.count < BURST_SIZE ? count - pool.count : BURST_SIZE, color,
+                          BURST_SPEED, BURST_LIFE);
+    }
+}
+
+bool isSamePool(const ParticlePool &a, const ParticlePool &b)
+{
+    if (a.count != b.count)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < a.count; i++)
+    {
+        if (a.x[i] != b.x[i] || a.y[i] != b.y[i] || a.velocityX[i] != b.velocityX[i] || a.velocityY[i] != b.velocityY[i] ||
+            a.life[i] != b.life[i] || a.color[i] != b.color[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Runs the SIMD and the plain update side by side for a few seconds of bursts.
+bool checkUpdate()
+{
+    ParticlePool simd;
+    initParticlePool(simd, 5000, 7);
+
+    unsigned int state = 1;
+    refillPool(simd, 5000, state);
+
+    ParticlePool scalar = simd;
+
+    for (int frame = 0; frame < 300; frame++)
+    {
+        updateParticles(simd, FRAME_SECONDS, GRAVITY);
+        updateParticlesScalar(scalar, FRAME_SECONDS, GRAVITY);
+
+        if (!isSamePool(simd, scalar))
+        {
+            printf("SIMD particle update differs from the scalar one on frame %d\n", frame);
+            return false;
+        }
+
+        unsigned int simdState = state;
+        refillPool(simd, 5000, simdState);
+        refillPool(scalar, 5000, state);
+    }
+
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 600;
+    std::vector<int> counts = {1000, 10000, 50000, 100000};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--counts") == 0 && i + 1 < argc)
+        {
+            counts = parseCounts(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool isValid = checkUpdate();
+
+    const int width = PC_CONFIG.screenWidth;
+    const int height = PC_CONFIG.screenHeight;
+
+    SoftRenderer renderer(width, height, nullptr);
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *sdlRenderer = surface != nullptr ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+
+    if (sdlRenderer != nullptr)
+    {
+        SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
+    }
+
+    printf("%8s %10s %10s %10s %10s %10s %10s\n", "count", "emit us", "update us", "vertex us", "soft us", "sdl us", "60Hz frame");
+#else
+    printf("%8s %10s %10s %10s %10s %10s\n", "count", "emit us", "update us", "vertex us", "soft us", "60Hz frame");
+#endif
+
+    for (int count : counts)
+    {
+        if (count <= 0)
+        {
+            continue;
+        }
+
+        ParticlePool pool;
+        initParticlePool(pool, count, 1);
+
+        std::vector<float> xy(count * 8);
+        std::vector<uint8_t> rgba(count * 16);
+        std::vector<int> indices;
+        makeParticleIndices(indices, count);
+
+        unsigned int state = 1;
+        refillPool(pool, count, state);
+
+        double emitSeconds = 0;
+        double updateSeconds = 0;
+        double vertexSeconds = 0;
+        double softSeconds = 0;
+        double sdlSeconds = 0;
+
+        for (int frame = 0; frame < frames; frame++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            refillPool(pool, count, state);
+            emitSeconds += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            updateParticles(pool, FRAME_SECONDS, GRAVITY);
+            updateSeconds += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            int vertexCount = writeParticleVertices(pool, PARTICLE_SIZE, xy.data(), rgba.data());
+            vertexSeconds += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            renderer.begin(0xff000000);
+
+            for (int i = 0; i < pool.count; i++)
+            {
+                AtlasRect square = {(int)pool.x[i], (int)pool.y[i], (int)PARTICLE_SIZE, (int)PARTICLE_SIZE};
+                renderer.fillRect(square, pool.color[i]);
+            }
+
+            renderer.end();
+            softSeconds += secondsSince(start);
+
+#if defined(BREAKOUT_HAS_SDL)
+            if (sdlRenderer != nullptr)
+            {
+                start = std::chrono::steady_clock::now();
+                SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 255);
+                SDL_RenderClear(sdlRenderer);
+                SDL_RenderGeometryRaw(sdlRenderer, NULL, xy.data(), 2 * sizeof(float), (const SDL_Color *)rgba.data(), 4, NULL, 0, vertexCount,
+                                      indices.data(), (vertexCount / 4) * 6, sizeof(int));
+                SDL_RenderFlush(sdlRenderer);
+                sdlSeconds += secondsSince(start);
+            }
+#else
+            (void)vertexCount;
+#endif
+        }
+
+        double cpuSeconds = emitSeconds + updateSeconds + vertexSeconds;
+
+#if defined(BREAKOUT_HAS_SDL)
+        printf("%8d %10.1f %10.1f %10.1f %10.1f %10.1f %9.1f%%\n", count, emitSeconds * 1e6 / frames, updateSeconds * 1e6 / frames,
+               vertexSeconds * 1e6 / frames, softSeconds * 1e6 / frames, sdlSeconds * 1e6 / frames, cpuSeconds / frames / FRAME_SECONDS * 100);
+#else
+        (void)sdlSeconds;
+        printf("%8d %10.1f %10.1f %10.1f %10.1f %9.1f%%\n", count, emitSeconds * 1e6 / frames, updateSeconds * 1e6 / frames,
+               vertexSeconds * 1e6 / frames, softSeconds * 1e6 / frames, cpuSeconds / frames / FRAME_SECONDS * 100);
+#endif
+    }
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_DestroyRenderer(sdlRenderer);
+    SDL_FreeSurface(surface);
+#endif
+
+    return isValid ? 0 : 1;
+}
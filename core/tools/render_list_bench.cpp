@@ -0,0 +1,197 @@
+#include "counting_backend.h"
+#include "game.h"
+#include "presets.h"
+#include "render_list.h"
+#include "scene.h"
+#include "soft_renderer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Records an autoplay game's frames into a RenderList the way the ports draw them, one
+// command per brick in row order with the rows in alternating colors like the Wii and
+// GameCube ports, and submits them to CountingBackend as recorded and sorted. Prints
+// state changes, draw calls and the time to record, sort and submit per frame. Every
+// frame is also drawn both ways with the software renderer, and the tool exits with 1 if
+// sorting changed a pixel.
+
+const int HUD_LAYER = 0;
+const int BRICK_LAYER = 0;
+const int PLAYER_LAYER = 1;
+
+const int GLYPH_TEXTURE = 0;
+
+const uint32_t ROW_COLORS[] = {0xff008080, 0xffff0000, 0xff00ffff, 0xffffff00};
+const int MAX_ROW_COLORS = 4;
+
+// Draws a RenderList with SoftRenderer; texture GLYPH_TEXTURE is the glyph mask.
+class SoftBackend : public RenderBackend
+{
+public:
+    SoftBackend(SoftRenderer &renderer, const AlphaImage &mask) : renderer(renderer), mask(mask), color(0) {}
+
+    void setTexture(int) override {}
+    void setColor(uint32_t rgba) override { color = rgba; }
+
+    void fillRects(const AtlasRect *rects, int count) override
+    {
+        for (int i = 0; i < count; i++)
+        {
+            renderer.fillRect(rects[i], color);
+        }
+    }
+
+    void copyQuads(const GlyphQuad *quads, int count) override
+    {
+        glyphQuads.assign(quads, quads + count);
+        renderer.drawGlyphs(glyphQuads, mask, color);
+    }
+
+private:
+    SoftRenderer &renderer;
+    const AlphaImage &mask;
+    uint32_t color;
+    std::vector<GlyphQuad> glyphQuads;
+};
+
+void recordFrame(RenderList &list, const Game &game, const GlyphAtlas &atlas, int rowColors)
+{
+    clearRenderList(list);
+
+    char text[32];
+
+    snprintf(text, sizeof(text), "score: %d", game.playerScore);
+    addRenderText(list, HUD_LAYER, GLYPH_TEXTURE, atlas, text, 200, 0, SCENE_WHITE);
+
+    snprintf(text, sizeof(text), "lives: %d", game.playerLives);
+    addRenderText(list, HUD_LAYER, GLYPH_TEXTURE, atlas, text, 600, 0, SCENE_WHITE);
+
+    for (int row = 0; row < game.bricks.rows; row++)
+    {
+        for (int column = findNextBrick(game.bricks, row, 0); column >= 0; column = findNextBrick(game.bricks, row, column + 1))
+        {
+            addRenderRect(list, BRICK_LAYER, scaleBounds(getBrickBounds(game.config, row, column), 1, 1), ROW_COLORS[row % rowColors]);
+        }
+    }
+
+    addRenderRect(list, PLAYER_LAYER, scaleBounds(game.player, 1, 1), SCENE_WHITE);
+    addRenderRect(list, PLAYER_LAYER, scaleBounds(game.ball, 1, 1), SCENE_WHITE);
+}
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--frames N] [--seed N] [--colors 1-%d]\n", program, MAX_ROW_COLORS);
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 3000;
+    unsigned int seed = 1;
+    int rowColors = 2;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--colors") == 0 && i + 1 < argc)
+        {
+            rowColors = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames <= 0 || rowColors < 1 || rowColors > MAX_ROW_COLORS)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    GlyphAtlas atlas;
+    AlphaImage mask;
+    createTestGlyphs(atlas, mask);
+
+    SoftRenderer recordedRenderer(PC_CONFIG.screenWidth, PC_CONFIG.screenHeight, nullptr);
+    SoftRenderer sortedRenderer(PC_CONFIG.screenWidth, PC_CONFIG.screenHeight, nullptr);
+    SoftBackend recordedPicture(recordedRenderer, mask);
+    SoftBackend sortedPicture(sortedRenderer, mask);
+
+    CountingBackend recorded;
+    CountingBackend sorted;
+
+    RenderList list;
+    long long commands = 0;
+    double recordSeconds = 0;
+    double sortSeconds = 0;
+    double submitSeconds = 0;
+    int changedFrames = 0;
+
+    Game game;
+    initGame(game, PC_CONFIG);
+    serveBall(game, seed);
+
+    GameInput input = {false, false};
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        updateGame(game, input, 1.0f / 120.0f);
+        updateGame(game, input, 1.0f / 120.0f);
+
+        auto start = std::chrono::steady_clock::now();
+        recordFrame(list, game, atlas, rowColors);
+        auto recordEnd = std::chrono::steady_clock::now();
+
+        commands += (long long)list.commands.size();
+        submitRenderList(list, recorded);
+
+        recordedRenderer.begin(SCENE_BLACK);
+        submitRenderList(list, recordedPicture);
+        recordedRenderer.end();
+
+        auto sortStart = std::chrono::steady_clock::now();
+        sortRenderList(list);
+        auto sortEnd = std::chrono::steady_clock::now();
+        submitRenderList(list, sorted);
+        auto submitEnd = std::chrono::steady_clock::now();
+
+        sortedRenderer.begin(SCENE_BLACK);
+        submitRenderList(list, sortedPicture);
+        sortedRenderer.end();
+
+        recordSeconds += std::chrono::duration<double>(recordEnd - start).count();
+        sortSeconds += std::chrono::duration<double>(sortEnd - sortStart).count();
+        submitSeconds += std::chrono::duration<double>(submitEnd - sortEnd).count();
+
+        if (recordedRenderer.framebuffer().pixels != sortedRenderer.framebuffer().pixels)
+        {
+            changedFrames++;
+        }
+    }
+
+    printf("frames: %d, row colors: %d, commands per frame: %.1f\n", frames, rowColors, (double)commands / frames);
+    printf("%10s %14s %11s %11s\n", "order", "state changes", "draw calls", "primitives");
+    printf("%10s %14.1f %11.1f %11.1f\n", "recorded", (double)recorded.stateChanges() / frames, (double)recorded.drawCalls / frames,
+           (double)recorded.primitives / frames);
+    printf("%10s %14.1f %11.1f %11.1f\n", "sorted", (double)sorted.stateChanges() / frames, (double)sorted.drawCalls / frames,
+           (double)sorted.primitives / frames);
+    printf("record %.2f us, sort %.2f us, submit %.2f us per frame\n", recordSeconds * 1e6 / frames, sortSeconds * 1e6 / frames,
+           submitSeconds * 1e6 / frames);
+
+    if (changedFrames > 0)
+    {
+        printf("%d frames look different sorted\n", changedFrames);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "game.h"
+#include "presets.h"
+#include "snapshot.h"
+#include "timestep.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Runs an autoplay game at a fixed 120 Hz with a fake present that takes a 60 Hz frame
+// and, every --hitch-every frames, hitches for --hitch-ms more. First with update and
+// present on one thread, like the ports' main loops, then with the simulation on its own
+// thread publishing GameSnapshots through a TripleBuffer to the presenting thread.
+// Prints the ticks simulated per second, the ticks dropped and the longest time between
+// two ticks for both. Exits with 1 if the threaded simulation falls off its rate, or if a
+// snapshot the presenting thread gets differs from replaying the game to the same tick.
+
+const int TICKS_PER_SECOND = 120;
+const int MAX_TICKS_PER_FRAME = 8;
+const unsigned long long COUNTER_FREQUENCY = 1000000000ull;
+
+typedef struct
+{
+    double seconds;
+    int hitchEvery;
+    int hitchMilliseconds;
+    unsigned int seed;
+} CheckOptions;
+
+typedef struct
+{
+    long long ticks;
+    unsigned long long droppedTicks;
+    double seconds;
+    double longestTickGap;
+    int frames;
+    int mismatchedSnapshots;
+} LoopResult;
+
+unsigned long long readCounter()
+{
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void startGame(Game &game, unsigned int seed)
+{
+    initGame(game, PC_CONFIG);
+    serveBall(game, seed);
+}
+
+// A vsynced present at 60 Hz, with a hitch every few frames.
+void present(const CheckOptions &options, int frame)
+{
+    int milliseconds = 16;
+
+    if (options.hitchEvery > 0 && frame % options.hitchEvery == options.hitchEvery - 1)
+    {
+        milliseconds += options.hitchMilliseconds;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+// Tracks when ticks run.
+class TickClock
+{
+public:
+    TickClock() : lastTick(readCounter()), longestGap(0) {}
+
+    void tick()
+    {
+        unsigned long long now = readCounter();
+
+        if (now - lastTick > longestGap)
+        {
+            longestGap = now - lastTick;
+        }
+
+        lastTick = now;
+    }
+
+    double longestGapSeconds() const { return (double)longestGap / COUNTER_FREQUENCY; }
+
+private:
+    unsigned long long lastTick;
+    unsigned long long longestGap;
+};
+
+LoopResult runSerial(const CheckOptions &options)
+{
+    LoopResult result = {};
+
+    Game game;
+    startGame(game, options.seed);
+
+    GameInput input = {false, false};
+
+    FixedTimestep timestep;
+    initFixedTimestep(timestep, TICKS_PER_SECOND, MAX_TICKS_PER_FRAME, COUNTER_FREQUENCY);
+
+    TickClock clock;
+    unsigned long long start = readCounter();
+    unsigned long long previous = start;
+
+    while (readCounter() - start < options.seconds * COUNTER_FREQUENCY)
+    {
+        unsigned long long now = readCounter();
+        int ticks = advanceFixedTimestep(timestep, now - previous);
+        previous = now;
+
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            updateGame(game, input, fixedTimestepDelta(timestep));
+            clock.tick();
+            result.ticks++;
+        }
+
+        present(options, result.frames);
+        result.frames++;
+    }
+
+    result.seconds = (double)(readCounter() - start) / COUNTER_FREQUENCY;
+    result.droppedTicks = timestep.droppedTicks;
+    result.longestTickGap = clock.longestGapSeconds();
+
+    return result;
+}
+
+LoopResult runThreaded(const CheckOptions &options)
+{
+    LoopResult result = {};
+
+    TripleBuffer<GameSnapshot> snapshots;
+    std::atomic<bool> isRunning(true);
+
+    TickClock clock;
+    unsigned long long start = readCounter();
+
+    std::thread simulation([&]() {
+        Game game;
+        startGame(game, options.seed);
+
+        GameInput input = {false, false};
+
+        FixedTimestep timestep;
+        initFixedTimestep(timestep, TICKS_PER_SECOND, MAX_TICKS_PER_FRAME, COUNTER_FREQUENCY);
+
+        unsigned long long previous = start;
+
+        while (isRunning.load(std::memory_order_relaxed))
+        {
+            unsigned long long now = readCounter();
+            int ticks = advanceFixedTimestep(timestep, now - previous);
+            previous = now;
+
+            for (int tick = 0; tick < ticks; tick++)
+            {
+                Bounds previousPlayer = game.player;
+                Bounds previousBall = game.ball;
+
+                updateGame(game, input, fixedTimestepDelta(timestep));
+                clock.tick();
+                result.ticks++;
+
+                takeGameSnapshot(snapshots.writeBuffer(), game, previousPlayer, previousBall, result.ticks, readCounter());
+                snapshots.publish();
+            }
+
+            // Far shorter than a tick, so ticks run on time without spinning.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        result.droppedTicks = timestep.droppedTicks;
+    });
+
+    // The presenting side replays the same game to check every snapshot it takes.
+    Game replay;
+    startGame(replay, options.seed);
+
+    GameInput input = {false, false};
+    long long replayTick = 0;
+
+    while (readCounter() - start < options.seconds * COUNTER_FREQUENCY)
+    {
+        if (snapshots.update())
+        {
+            const GameSnapshot &snapshot = snapshots.readBuffer();
+
+            for (; replayTick < snapshot.tick; replayTick++)
+            {
+                updateGame(replay, input, Number(1.0f / TICKS_PER_SECOND));
+            }
+
+            if (snapshot.ball.x != replay.ball.x || snapshot.ball.y != replay.ball.y || snapshot.player.x != replay.player.x ||
+                snapshot.playerScore != replay.playerScore || snapshot.bricks.aliveMasks != replay.bricks.aliveMasks)
+            {
+                result.mismatchedSnapshots++;
+            }
+        }
+
+        present(options, result.frames);
+        result.frames++;
+    }
+
+    isRunning = false;
+    simulation.join();
+
+    result.seconds = (double)(readCounter() - start) / COUNTER_FREQUENCY;
+    result.longestTickGap = clock.longestGapSeconds();
+
+    return result;
+}
+
+void printResult(const char *name, const LoopResult &result)
+{
+    printf("%10s %8d %12.1f %8llu %14.1f\n", name, result.frames, result.ticks / result.seconds, result.droppedTicks,
+           result.longestTickGap * 1000);
+}
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--seconds N] [--hitch-every FRAMES] [--hitch-ms N] [--seed N]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    CheckOptions options = {3, 20, 150, 1};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            options.seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--hitch-every") == 0 && i + 1 < argc)
+        {
+            options.hitchEvery = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--hitch-ms") == 0 && i + 1 < argc)
+        {
+            options.hitchMilliseconds = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            options.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.seconds <= 0 || options.hitchEvery < 0 || options.hitchMilliseconds < 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    printf("%d Hz simulation, 60 Hz present, %d ms hitch every %d frames\n", TICKS_PER_SECOND, options.hitchMilliseconds, options.hitchEvery);
+    printf("%10s %8s %12s %8s %14s\n", "loop", "frames", "ticks/sec", "dropped", "longest gap ms");
+
+    LoopResult serial = runSerial(options);
+    printResult("serial", serial);
+
+    LoopResult threaded = runThreaded(options);
+    printResult("threaded", threaded);
+
+    bool isValid = true;
+
+    // Two ticks of slack for the start and the end of the run.
+    if (threaded.droppedTicks > 0 || threaded.ticks < threaded.seconds * TICKS_PER_SECOND - 2)
+    {
+        printf("the threaded simulation fell behind its rate\n");
+        isValid = false;
+    }
+
+    if (threaded.mismatchedSnapshots > 0)
+    {
+        printf("%d snapshots differ from the replay\n", threaded.mismatchedSnapshots);
+        isValid = false;
+    }
+
+    return isValid ? 0 : 1;
+}
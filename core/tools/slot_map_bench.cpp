@@ -0,0 +1,212 @@
+#include "game.h"
+#include "slot_map.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Clears a 10k-brick board one brick per frame in a seeded random order, walking the
+// standing bricks every frame like the render and collision passes do. Compares the
+// old vector with erase(), SlotMap and the BrickField masks, and checks that all three
+// see the same bricks and that SlotMap rejects handles to removed bricks.
+
+typedef struct
+{
+    Bounds bounds;
+    int points;
+    int row;
+    int column;
+} Brick;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--rows N] [--columns N] [--seed N]\n", program);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int rows = 100;
+    int columns = 100;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+        {
+            rows = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--columns") == 0 && i + 1 < argc)
+        {
+            columns = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    GameConfig config = {};
+    config.brickRows = rows;
+    config.brickColumns = columns;
+    config.brickWidth = 12;
+    config.brickHeight = 6;
+    config.brickSpacingX = 14;
+    config.brickSpacingY = 8;
+    config.firstRowPoints = rows;
+
+    const int brickCount = rows * columns;
+
+    std::vector<Brick> bricks;
+    bricks.reserve(brickCount);
+
+    for (int row = 0; row < rows; row++)
+    {
+        for (int column = 0; column < columns; column++)
+        {
+            Brick brick = {getBrickBounds(config, row, column), config.firstRowPoints - row, row, column};
+            bricks.push_back(brick);
+        }
+    }
+
+    std::vector<int> order(brickCount);
+
+    for (int i = 0; i < brickCount; i++)
+    {
+        order[i] = i;
+    }
+
+    std::mt19937 random(seed);
+    std::shuffle(order.begin(), order.end(), random);
+
+    // std::vector::erase(), finding the brick by walking the vector as the ports used to.
+    std::vector<Brick> vectorBricks = bricks;
+    long long vectorChecksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < brickCount; frame++)
+    {
+        const Brick &target = bricks[order[frame]];
+
+        for (auto brick = vectorBricks.begin(); brick != vectorBricks.end(); ++brick)
+        {
+            vectorChecksum += brick->points;
+        }
+
+        for (auto brick = vectorBricks.begin(); brick != vectorBricks.end(); ++brick)
+        {
+            if (brick->row == target.row && brick->column == target.column)
+            {
+                vectorBricks.erase(brick);
+                break;
+            }
+        }
+    }
+
+    double vectorSeconds = secondsSince(start);
+
+    // SlotMap, removing by the handle kept when the brick was added.
+    SlotMap<Brick> slotBricks;
+    slotBricks.reserve(brickCount);
+
+    std::vector<SlotHandle> handles(brickCount);
+
+    for (int i = 0; i < brickCount; i++)
+    {
+        handles[i] = slotBricks.insert(bricks[i]);
+    }
+
+    long long slotChecksum = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < brickCount; frame++)
+    {
+        for (const Brick &brick : slotBricks)
+        {
+            slotChecksum += brick.points;
+        }
+
+        slotBricks.remove(handles[order[frame]]);
+    }
+
+    double slotSeconds = secondsSince(start);
+
+    // BrickField, clearing the brick's bit.
+    BrickField field;
+    initBrickField(field, config);
+
+    long long fieldChecksum = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < brickCount; frame++)
+    {
+        for (int row = 0; row < field.rows; row++)
+        {
+            for (int column = findNextBrick(field, row, 0); column >= 0; column = findNextBrick(field, row, column + 1))
+            {
+                fieldChecksum += field.rowPoints[row];
+            }
+        }
+
+        const Brick &target = bricks[order[frame]];
+        destroyBrick(field, target.row, target.column);
+    }
+
+    double fieldSeconds = secondsSince(start);
+
+    printf("bricks: %d, one removed per frame\n", brickCount);
+    printf("%12s %12s %14s\n", "storage", "seconds", "us per frame");
+    printf("%12s %12.3f %14.2f\n", "vector", vectorSeconds, vectorSeconds * 1e6 / brickCount);
+    printf("%12s %12.3f %14.2f\n", "slot map", slotSeconds, slotSeconds * 1e6 / brickCount);
+    printf("%12s %12.3f %14.2f\n", "brick field", fieldSeconds, fieldSeconds * 1e6 / brickCount);
+
+    bool isValid = true;
+
+    if (vectorChecksum != slotChecksum || vectorChecksum != fieldChecksum)
+    {
+        printf("checksums differ: vector %lld, slot map %lld, brick field %lld\n", vectorChecksum, slotChecksum, fieldChecksum);
+        isValid = false;
+    }
+
+    if (!vectorBricks.empty() || slotBricks.size() != 0 || countBricks(field) != 0)
+    {
+        printf("board not cleared\n");
+        isValid = false;
+    }
+
+    // A reused slot must not answer to a handle from before the removal.
+    SlotHandle reused = slotBricks.insert(bricks[0]);
+
+    for (const SlotHandle &handle : handles)
+    {
+        if (slotBricks.get(handle) != nullptr)
+        {
+            printf("stale handle to slot %u was accepted\n", handle.slot);
+            isValid = false;
+            break;
+        }
+    }
+
+    if (slotBricks.get(reused) == nullptr)
+    {
+        printf("new handle was rejected\n");
+        isValid = false;
+    }
+
+    return isValid ? 0 : 1;
+}
@@ -0,0 +1,378 @@
+#include "game.h"
+#include "presets.h"
+#include "scene.h"
+#include "soft_renderer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(BREAKOUT_HAS_SDL)
+#include <SDL.h>
+#endif
+
+// Renders an autoplay game's frames (HUD text, bricks, paddle and ball, scaled from the
+// PC layout) with SoftRenderer on each thread count and prints frames per second, at
+// 960x544 and 1280x720 by default. When SDL2 was found at configure time the same frames
+// also go through SDL's software renderer. Checks the SIMD spans against plain loops and
+// every tiled frame against drawing the commands one by one, and exits with 1 on a mismatch.
+
+typedef struct
+{
+    int width;
+    int height;
+} ScreenSize;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--frames N] [--threads 1,2,4,...] [--sizes 960x544,1280x720]\n", program);
+}
+
+std::vector<int> parseList(const char *text, char separator, std::vector<int> *secondValues)
+{
+    std::vector<int> values;
+    std::string list = text;
+
+    size_t start = 0;
+
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+
+        std::string item = list.substr(start, end - start);
+        size_t split = item.find(separator);
+
+        values.push_back(atoi(item.c_str()));
+
+        if (secondValues != nullptr)
+        {
+            secondValues->push_back(split == std::string::npos ? 0 : atoi(item.c_str() + split + 1));
+        }
+
+        start = end + 1;
+    }
+
+    return values;
+}
+
+// Draws every command straight away over the whole screen, without tiles or threads.
+class ReferenceCanvas
+{
+public:
+    ReferenceCanvas(int width, int height, const AlphaImage &mask) : mask(mask)
+    {
+        framebuffer.width = width;
+        framebuffer.height = height;
+        framebuffer.pixels.assign(width * height, 0);
+    }
+
+    void begin(uint32_t color)
+    {
+        AtlasRect screen = {0, 0, framebuffer.width, framebuffer.height};
+        draw(SOFT_COMMAND_FILL, screen, color, 0, 0);
+    }
+
+    void drawGlyphs(const std::vector<GlyphQuad> &quads, uint32_t color)
+    {
+        for (const GlyphQuad &quad : quads)
+        {
+            AtlasRect destination = {quad.destination.x, quad.destination.y, quad.source.w, quad.source.h};
+            draw(SOFT_COMMAND_BLEND_MASK, destination, color, quad.source.x, quad.source.y);
+        }
+    }
+
+    void fillRects(const std::vector<AtlasRect> &rects, uint32_t color)
+    {
+        for (const AtlasRect &rect : rects)
+        {
+            draw(SOFT_COMMAND_FILL, rect, color, 0, 0);
+        }
+    }
+
+    void end() {}
+
+    Framebuffer framebuffer;
+
+private:
+    void draw(int type, const AtlasRect &destination, uint32_t color, int maskX, int maskY)
+    {
+        AtlasRect screen = {0, 0, framebuffer.width, framebuffer.height};
+        SoftCommand command = {type, color, destination, &mask, maskX, maskY};
+
+        drawSoftCommand(framebuffer, command, screen);
+    }
+
+    const AlphaImage &mask;
+};
+
+#if defined(BREAKOUT_HAS_SDL)
+
+// SDL's software renderer drawing into a surface, batched the way the ports draw.
+class SdlCanvas
+{
+public:
+    SdlCanvas(int width, int height, const AlphaImage &mask)
+    {
+        surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = SDL_CreateSoftwareRenderer(surface);
+
+        std::vector<uint32_t> pixels(mask.width * mask.height);
+
+        for (int i = 0; i < (int)pixels.size(); i++)
+        {
+            pixels[i] = ((uint32_t)mask.alpha[i] << 24) | 0xffffff;
+        }
+
+        glyphs = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, mask.width, mask.height);
+        SDL_UpdateTexture(glyphs, NULL, pixels.data(), mask.width * 4);
+        SDL_SetTextureBlendMode(glyphs, SDL_BLENDMODE_BLEND);
+    }
+
+    ~SdlCanvas()
+    {
+        SDL_DestroyTexture(glyphs);
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(surface);
+    }
+
+    bool isValid() const { return renderer != nullptr && glyphs != nullptr; }
+
+    void begin(uint32_t color)
+    {
+        setColor(color);
+        SDL_RenderClear(renderer);
+    }
+
+    void drawGlyphs(const std::vector<GlyphQuad> &quads, uint32_t color)
+    {
+        SDL_SetTextureColorMod(glyphs, (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff);
+
+        for (const GlyphQuad &quad : quads)
+        {
+            SDL_Rect source = {quad.source.x, quad.source.y, quad.source.w, quad.source.h};
+            SDL_Rect destination = {quad.destination.x, quad.destination.y, quad.source.w, quad.source.h};
+
+            SDL_RenderCopy(renderer, glyphs, &source, &destination);
+        }
+    }
+
+    void fillRects(const std::vector<AtlasRect> &rects, uint32_t color)
+    {
+        static std::vector<SDL_Rect> sdlRects;
+        sdlRects.clear();
+
+        for (const AtlasRect &rect : rects)
+        {
+            SDL_Rect sdlRect = {rect.x, rect.y, rect.w, rect.h};
+            sdlRects.push_back(sdlRect);
+        }
+
+        setColor(color);
+        SDL_RenderFillRects(renderer, sdlRects.data(), (int)sdlRects.size());
+    }
+
+    void end() { SDL_RenderFlush(renderer); }
+
+private:
+    void setColor(uint32_t color) { SDL_SetRenderDrawColor(renderer, (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff, color >> 24); }
+
+    SDL_Surface *surface;
+    SDL_Renderer *renderer;
+    SDL_Texture *glyphs;
+};
+
+#endif
+
+bool checkSpans()
+{
+    std::vector<uint32_t> simd(300);
+    std::vector<uint32_t> scalar(300);
+    std::vector<uint8_t> alpha(300);
+
+    unsigned int state = 12345;
+
+    for (int test = 0; test < 2000; test++)
+    {
+        for (int i = 0; i < 300; i++)
+        {
+            state = state * 1103515245 + 12345;
+            simd[i] = scalar[i] = state;
+            alpha[i] = (uint8_t)(state >> 24);
+
+            // Runs of empty and full coverage like real glyphs have.
+            if (i % 17 < 4)
+            {
+                alpha[i] = (i % 17 < 2) ? 0 : 255;
+            }
+        }
+
+        int offset = test % 7;
+        int count = test % 280;
+        uint32_t color = state ^ 0x5a5a5a5a;
+
+        if (test % 2 == 0)
+        {
+            fillSpan(&simd[offset], count, color);
+            fillSpanScalar(&scalar[offset], count, color);
+        }
+        else
+        {
+            blendSpan(&simd[offset], &alpha[offset], count, color);
+            blendSpanScalar(&scalar[offset], &alpha[offset], count, color);
+        }
+
+        if (simd != scalar)
+        {
+            printf("%s span of %d pixels differs from the scalar one\n", test % 2 == 0 ? "fill" : "blend", count);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 600;
+    std::vector<int> threadCounts;
+    std::vector<ScreenSize> sizes = {{960, 544}, {1280, 720}};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCounts = parseList(argv[++i], ',', nullptr);
+        }
+        else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc)
+        {
+            std::vector<int> heights;
+            std::vector<int> widths = parseList(argv[++i], 'x', &heights);
+
+            sizes.clear();
+
+            for (int size = 0; size < (int)widths.size(); size++)
+            {
+                ScreenSize screen = {widths[size], heights[size]};
+                sizes.push_back(screen);
+            }
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (threadCounts.empty())
+    {
+        int hardwareThreads = (int)std::thread::hardware_concurrency();
+
+        for (int threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+        {
+            threadCounts.push_back(threadCount);
+        }
+
+        threadCounts.push_back(hardwareThreads > 0 ? hardwareThreads : 1);
+    }
+
+    bool isValid = checkSpans();
+
+    GlyphAtlas atlas;
+    AlphaImage mask;
+    createTestGlyphs(atlas, mask);
+
+    printf("frames: %d\n", frames);
+    printf("%10s %14s %8s %12s\n", "size", "renderer", "threads", "frames/sec");
+
+    for (const ScreenSize &size : sizes)
+    {
+        float scaleX = size.width / (float)PC_CONFIG.screenWidth;
+        float scaleY = size.height / (float)PC_CONFIG.screenHeight;
+
+        for (int threadCount : threadCounts)
+        {
+            ThreadPool pool(threadCount);
+            SoftRenderer renderer(size.width, size.height, &pool);
+            SoftCanvas canvas(renderer, mask);
+            ReferenceCanvas reference(size.width, size.height, mask);
+
+            Game game;
+            initGame(game, PC_CONFIG);
+
+            GameInput input = {false, false};
+            double seconds = 0;
+            int mismatchedFrames = 0;
+
+            for (int frame = 0; frame < frames; frame++)
+            {
+                updateGame(game, input, 1.0f / 120.0f);
+                updateGame(game, input, 1.0f / 120.0f);
+
+                auto start = std::chrono::steady_clock::now();
+                drawGameScene(canvas, game, atlas, scaleX, scaleY);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                // Every frame on the first thread count, a sample of them after that.
+                if (threadCount == threadCounts[0] || frame % 60 == 0)
+                {
+                    drawGameScene(reference, game, atlas, scaleX, scaleY);
+
+                    if (reference.framebuffer.pixels != renderer.framebuffer().pixels)
+                    {
+                        mismatchedFrames++;
+                    }
+                }
+            }
+
+            printf("%5dx%-4d %14s %8d %12.0f\n", size.width, size.height, "soft", threadCount, frames / seconds);
+
+            if (mismatchedFrames > 0)
+            {
+                printf("%d frames differ from drawing the commands one by one\n", mismatchedFrames);
+                isValid = false;
+            }
+        }
+
+#if defined(BREAKOUT_HAS_SDL)
+        SdlCanvas sdlCanvas(size.width, size.height, mask);
+
+        if (!sdlCanvas.isValid())
+        {
+            printf("SDL software renderer failed: %s\n", SDL_GetError());
+            continue;
+        }
+
+        Game game;
+        initGame(game, PC_CONFIG);
+
+        GameInput input = {false, false};
+        double seconds = 0;
+
+        for (int frame = 0; frame < frames; frame++)
+        {
+            updateGame(game, input, 1.0f / 120.0f);
+            updateGame(game, input, 1.0f / 120.0f);
+
+            auto start = std::chrono::steady_clock::now();
+            drawGameScene(sdlCanvas, game, atlas, scaleX, scaleY);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        printf("%5dx%-4d %14s %8d %12.0f\n", size.width, size.height, "sdl software", 1, frames / seconds);
+#endif
+    }
+
+    return isValid ? 0 : 1;
+}
@@ -0,0 +1,414 @@
+#include "audio_stage.h"
+#include "game.h"
+#include "mixer.h"
+#include "presets.h"
+#include "timestep.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(BREAKOUT_HAS_SDL)
+#include <SDL.h>
+#endif
+
+// Plays an autoplay game in real time the way the PC port does: a 120 Hz simulation thread
+// pushes a SoundEvent for every hit with the time of the hit inside its tick, a 60 Hz frame
+// loop runs the audio stage and queues the mixer commands, and an audio callback mixes
+// --buffer frames at a time. When SDL2 was found at configure time the callback is run by
+// SDL's dummy audio driver; without it a thread paces the callback the same way, sleeping
+// the buffer's length in whole milliseconds. Every hit plays a click one frame long whose
+// level says which hit it was, so its onset can be found in the mixed output, at the time
+// of its callback plus its frame in the buffer.
+//
+// Runs once starting sounds at the start of the next buffer and once at the hit's frame,
+// for --seconds each, and prints the hit-to-onset latency and its jitter, the spread
+// between the earliest and the latest onset. A callback that comes after the previous
+// buffer has run out is a gap the driver left, an underrun on a real device; gaps are
+// counted and the onsets in them left out. Exits with 1 if the jitter starting at the
+// hit's frame is 1 ms or more, or if hardly any hits were heard.
+
+const int TICKS_PER_SECOND = 120;
+const int FRAMES_PER_SECOND = 60;
+const int RATE = 48000;
+
+// Clicks told apart by level: click n is (n + 1) * CLICK_LEVEL on the left and
+// CLICK_LEVEL on the right, so the right says how many clicks share a frame.
+const int CLICK_SOUNDS = 64;
+const int CLICK_LEVEL = 256;
+const int SOUND_VOICES = 8;
+
+const double MAX_JITTER_SECONDS = 0.001;
+const int MIN_HITS = 10;
+
+typedef struct
+{
+    long long firstFrame;
+    double time;
+} CapturedBuffer;
+
+typedef struct
+{
+    std::vector<double> latencies;
+    long long hits;
+    long long lateStarts;
+
+    // Callbacks that came after the previous buffer had run out, an underrun on a real
+    // device, and the onsets in them, which are left out of the latencies.
+    long long lateBuffers;
+    long long skippedOnsets;
+} TimingResult;
+
+typedef struct
+{
+    Mixer mixer;
+    SpscQueue<MixerCommand> *commands;
+    std::chrono::steady_clock::time_point start;
+
+    // Every frame mixed, and when each buffer was, until full.
+    std::vector<int16_t> samples;
+    std::vector<CapturedBuffer> buffers;
+    long long capturedFrames;
+} AudioCapture;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--seconds N] [--buffer FRAMES] [--seed N]\n", program);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void captureCallback(void *userdata, uint8_t *stream, int length)
+{
+    AudioCapture &capture = *(AudioCapture *)userdata;
+    int frames = length / (MIXER_CHANNELS * (int)sizeof(int16_t));
+    double now = secondsSince(capture.start);
+
+    mixAudio(capture.mixer, *capture.commands, (int16_t *)stream, frames, now);
+
+    if ((capture.capturedFrames + frames) * MIXER_CHANNELS <= (long long)capture.samples.size() && capture.buffers.size() < capture.buffers.capacity())
+    {
+        memcpy(&capture.samples[capture.capturedFrames * MIXER_CHANNELS], stream, length);
+
+        CapturedBuffer buffer = {capture.capturedFrames, now};
+        capture.buffers.push_back(buffer);
+        capture.capturedFrames += frames;
+    }
+}
+
+// What SDL2's dummy driver does: call back, then sleep the buffer's length in whole ms.
+void runDummyDriver(AudioCapture &capture, int bufferFrames, std::atomic<bool> &isRunning)
+{
+    std::vector<int16_t> stream(bufferFrames * MIXER_CHANNELS);
+
+    while (isRunning.load(std::memory_order_relaxed))
+    {
+        captureCallback(&capture, (uint8_t *)stream.data(), (int)(stream.size() * sizeof(int16_t)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(bufferFrames * 1000 / RATE));
+    }
+}
+
+// The simulation thread of the PC port, logging when each hit happened.
+void runGame(unsigned int seed, std::chrono::steady_clock::time_point start, SpscQueue<SoundEvent> &events, std::vector<double> &hitTimes,
+             std::atomic<bool> &isRunning)
+{
+    const unsigned long long frequency = 1000000000ull;
+
+    Game game;
+    initGame(game, PC_CONFIG);
+    serveBall(game, seed);
+
+    FixedTimestep timestep;
+    initFixedTimestep(timestep, TICKS_PER_SECOND, 8, frequency);
+
+    GameInput input = {false, false};
+    unsigned long long previousTime = 0;
+
+    while (isRunning.load(std::memory_order_relaxed))
+    {
+        unsigned long long currentTime = (unsigned long long)(secondsSince(start) * frequency);
+        int ticks = advanceFixedTimestep(timestep, currentTime - previousTime);
+        previousTime = currentTime;
+
+        double endTime = (double)fixedTimestepEndTime(timestep, currentTime) / frequency;
+
+        for (int i = 0; i < ticks; i++)
+        {
+            Number deltaTime = fixedTimestepDelta(timestep);
+            double tickTime = endTime - (double)(ticks - i) / TICKS_PER_SECOND;
+
+            int hits = updateGame(game, input, deltaTime) & (GAME_EVENT_WALL_HIT | GAME_EVENT_CEILING_HIT | GAME_EVENT_PLAYER_HIT | GAME_EVENT_BRICK_HIT);
+
+            if (hits != 0)
+            {
+                SoundEvent event = {(int)hitTimes.size() % CLICK_SOUNDS, tickTime + (float)(firstEventTime(game, hits) * deltaTime)};
+                events.push(event);
+                hitTimes.push_back(event.time);
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Returns false when the run couldn't start.
+bool runTiming(double startDelay, int bufferFrames, double seconds, unsigned int seed, TimingResult &result)
+{
+    AudioCapture capture;
+    SpscQueue<MixerCommand> commands(256);
+
+    initMixer(capture.mixer, RATE, SOUND_VOICES);
+    capture.mixer.startDelay = startDelay;
+    capture.commands = &commands;
+
+    AudioStage stage;
+    initAudioStage(stage, SOUND_VOICES);
+    stage.startDelay = startDelay;
+
+    for (int i = 0; i < CLICK_SOUNDS; i++)
+    {
+        PcmSound click = {RATE, MIXER_CHANNELS, {(int16_t)((i + 1) * CLICK_LEVEL), (int16_t)CLICK_LEVEL}};
+        addMixerSound(capture.mixer, click);
+        addStageSound(stage, 1, 1.0 / RATE);
+    }
+
+    // A second to spare for the callback running ahead.
+    long long maxFrames = (long long)((seconds + 1) * RATE);
+    capture.samples.assign(maxFrames * MIXER_CHANNELS, 0);
+    capture.buffers.reserve(maxFrames / bufferFrames + 1);
+    capture.capturedFrames = 0;
+    capture.start = std::chrono::steady_clock::now();
+
+    SpscQueue<SoundEvent> events(256);
+    std::vector<double> hitTimes;
+    hitTimes.reserve((size_t)(seconds * TICKS_PER_SECOND) + 1);
+
+    std::atomic<bool> isRunning(true);
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_AudioSpec desired = {};
+    desired.freq = RATE;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = MIXER_CHANNELS;
+    desired.samples = (Uint16)bufferFrames;
+    desired.callback = captureCallback;
+    desired.userdata = &capture;
+
+    SDL_AudioDeviceID device = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+
+    if (device == 0)
+    {
+        printf("Unable to open the audio device! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_PauseAudioDevice(device, 0);
+#else
+    std::thread driver(runDummyDriver, std::ref(capture), bufferFrames, std::ref(isRunning));
+#endif
+
+    std::thread simulation(runGame, seed, capture.start, std::ref(events), std::ref(hitTimes), std::ref(isRunning));
+
+    std::vector<VoiceStart> starts;
+    int frames = (int)(seconds * FRAMES_PER_SECOND);
+
+    for (int frame = 1; frame <= frames; frame++)
+    {
+        std::this_thread::sleep_until(capture.start + std::chrono::microseconds(frame * 1000000ll / FRAMES_PER_SECOND));
+
+        starts.clear();
+        runAudioStage(stage, events, secondsSince(capture.start), starts);
+
+        for (const VoiceStart &start : starts)
+        {
+            MixerCommand command = {start.voice, start.sound, MIXER_FULL_VOLUME, start.time};
+            commands.push(command);
+        }
+    }
+
+    // A last buffer after the delay, for the sounds still waiting to start.
+    std::this_thread::sleep_for(std::chrono::duration<double>(startDelay + 4.0 * bufferFrames / RATE));
+
+    isRunning = false;
+    simulation.join();
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_CloseAudioDevice(device);
+#else
+    driver.join();
+#endif
+
+    // Click n of every CLICK_SOUNDS is hit n, n + CLICK_SOUNDS and so on, in order.
+    std::vector<size_t> nextHits(CLICK_SOUNDS);
+
+    for (int i = 0; i < CLICK_SOUNDS; i++)
+    {
+        nextHits[i] = i;
+    }
+
+    result.latencies.clear();
+    result.lateBuffers = 0;
+    result.skippedOnsets = 0;
+
+    for (size_t i = 0; i < capture.buffers.size(); i++)
+    {
+        const CapturedBuffer &buffer = capture.buffers[i];
+        long long endFrame = i + 1 < capture.buffers.size() ? capture.buffers[i + 1].firstFrame : capture.capturedFrames;
+
+        bool isLate = i > 0 && buffer.time > capture.buffers[i - 1].time + (double)(buffer.firstFrame - capture.buffers[i - 1].firstFrame) / RATE;
+        result.lateBuffers += isLate ? 1 : 0;
+
+        for (long long frame = buffer.firstFrame; frame < endFrame; frame++)
+        {
+            int left = capture.samples[frame * MIXER_CHANNELS];
+            int right = capture.samples[frame * MIXER_CHANNELS + 1];
+
+            // Two clicks on one frame can't be told apart; a rare skip doesn't move the jitter.
+            if (right != CLICK_LEVEL)
+            {
+                continue;
+            }
+
+            int click = left / CLICK_LEVEL - 1;
+
+            if (click < 0 || click >= CLICK_SOUNDS || nextHits[click] >= hitTimes.size())
+            {
+                continue;
+            }
+
+            double onset = buffer.time + (double)(frame - buffer.firstFrame) / RATE;
+            nextHits[click] += CLICK_SOUNDS;
+
+            if (isLate)
+            {
+                result.skippedOnsets++;
+                continue;
+            }
+
+            result.latencies.push_back(onset - hitTimes[nextHits[click] - CLICK_SOUNDS]);
+        }
+    }
+
+    result.hits = (long long)hitTimes.size();
+    result.lateStarts = capture.mixer.lateStarts;
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    double seconds = 15;
+    int bufferFrames = 256;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--buffer") == 0 && i + 1 < argc)
+        {
+            bufferFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (seconds <= 0 || bufferFrames <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0)
+    {
+        printf("Unable to initialize SDL audio! SDL Error: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    printf("SDL %s driver, ", SDL_GetCurrentAudioDriver());
+#else
+    printf("dummy driver thread, ");
+#endif
+
+    printf("%d frame buffers at %d Hz, %.0f s per run\n\n", bufferFrames, RATE, seconds);
+    printf("%-8s %10s %6s %6s %6s %8s %8s %12s %12s %12s\n", "start", "delay ms", "hits", "heard", "late", "gaps", "skipped", "latency ms", "jitter ms",
+           "stddev ms");
+
+    // The PC port's delay: a tick until the hit is simulated, a frame until the stage runs
+    // and two buffers until the callback takes the command.
+    double delays[2] = {0, 1.0 / TICKS_PER_SECOND + 1.0 / FRAMES_PER_SECOND + 2.0 * bufferFrames / RATE};
+    const char *names[2] = {"buffer", "frame"};
+    bool isValid = true;
+
+    for (int run = 0; run < 2; run++)
+    {
+        TimingResult result;
+
+        if (!runTiming(delays[run], bufferFrames, seconds, seed, result))
+        {
+            return 1;
+        }
+
+        const std::vector<double> &latencies = result.latencies;
+
+        if ((long long)latencies.size() < MIN_HITS)
+        {
+            printf("%s: only %zu of %lld hits were measured, at least %d are needed!\n", names[run], latencies.size(), result.hits, MIN_HITS);
+            isValid = false;
+            continue;
+        }
+
+        double sum = 0;
+
+        for (double latency : latencies)
+        {
+            sum += latency;
+        }
+
+        double mean = sum / latencies.size();
+        double squares = 0;
+
+        for (double latency : latencies)
+        {
+            squares += (latency - mean) * (latency - mean);
+        }
+
+        auto range = std::minmax_element(latencies.begin(), latencies.end());
+        double jitter = *range.second - *range.first;
+
+        printf("%-8s %10.2f %6lld %6zu %6lld %8lld %8lld %12.3f %12.3f %12.3f\n", names[run], delays[run] * 1e3, result.hits, latencies.size(),
+               result.lateStarts, result.lateBuffers, result.skippedOnsets, mean * 1e3, jitter * 1e3, sqrt(squares / latencies.size()) * 1e3);
+
+        if (run == 1 && jitter >= MAX_JITTER_SECONDS)
+        {
+            printf("The jitter starting sounds at the hit's frame should be under %.1f ms!\n", MAX_JITTER_SECONDS * 1e3);
+            isValid = false;
+        }
+    }
+
+#if defined(BREAKOUT_HAS_SDL)
+    SDL_Quit();
+#endif
+
+    return isValid ? 0 : 1;
+}
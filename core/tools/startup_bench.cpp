@@ -0,0 +1,254 @@
+#include "cook_profile.h"
+#include "cooked.h"
+#include "mixer.h"
+#include "pcm.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+
+#if defined(BREAKOUT_HAS_FREETYPE)
+#include "font_raster.h"
+#endif
+
+// Times a port's asset loading at startup from its source assets and from the files
+// breakout_cook made, each in a fresh process so the resident memory is its own. From
+// source, sounds are decoded and converted to the mixer's format and fonts rasterized
+// with FreeType, standing in for SDL_ttf; cooked, both are read as they are. Either way
+// each atlas ends up as the white RGBA pixels the port uploads as a texture. Exits with
+// 1 if a run fails, e.g. when the profile hasn't been cooked.
+
+const int MIXER_VOICES = 8;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--profile NAME] [--runs N]\n", program);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+long residentKilobytes()
+{
+    long pages = 0;
+    long resident = 0;
+    FILE *file = fopen("/proc/self/statm", "r");
+
+    if (file != nullptr)
+    {
+        if (fscanf(file, "%ld %ld", &pages, &resident) != 2)
+        {
+            resident = 0;
+        }
+
+        fclose(file);
+    }
+
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void expandAtlas(const CookedFont &font, std::vector<uint8_t> &rgba)
+{
+    rgba.resize(font.alpha.size() * 4);
+
+    for (size_t i = 0; i < font.alpha.size(); i++)
+    {
+        rgba[i * 4 + 0] = 255;
+        rgba[i * 4 + 1] = 255;
+        rgba[i * 4 + 2] = 255;
+        rgba[i * 4 + 3] = font.alpha[i];
+    }
+}
+
+// The child: loads everything one way and prints its time and memory on one line.
+int runLoad(const CookProfile &profile, bool isCooked)
+{
+    std::string directory = std::string(BREAKOUT_REPO_DIR) + "/" + profile.assetDirectory + "/";
+    long residentBefore = residentKilobytes();
+
+    auto start = std::chrono::steady_clock::now();
+
+    Mixer mixer;
+    initMixer(mixer, profile.rate, MIXER_VOICES);
+
+    for (const CookSound &sound : profile.sounds)
+    {
+        PcmSound pcm;
+
+        if (isCooked ? !loadCookedPcm((directory + sound.cooked).c_str(), pcm) : !loadWavFile((directory + sound.source).c_str(), pcm))
+        {
+            return 1;
+        }
+
+        addMixerSound(mixer, std::move(pcm));
+    }
+
+    std::vector<std::vector<uint8_t>> textures;
+
+    for (const CookFont &font : profile.fonts)
+    {
+        CookedFont atlas;
+
+        if (isCooked)
+        {
+            if (!loadCookedFont((directory + font.cooked).c_str(), atlas))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+#if defined(BREAKOUT_HAS_FREETYPE)
+            if (!rasterizeFont((directory + font.source).c_str(), font.size, profile.atlasWidth, atlas))
+            {
+                return 1;
+            }
+#else
+            continue;
+#endif
+        }
+
+        textures.push_back(std::vector<uint8_t>());
+        expandAtlas(atlas, textures.back());
+    }
+
+    double seconds = secondsSince(start);
+
+    printf("%.3f %ld\n", seconds * 1e3, residentKilobytes() - residentBefore);
+
+    return 0;
+}
+
+// Runs this program again with --load and reads back its line.
+bool measureLoad(const char *program, const char *profileName, const char *mode, double &milliseconds, long &grownKilobytes, long &peakKilobytes)
+{
+    int output[2];
+
+    if (pipe(output) != 0)
+    {
+        return false;
+    }
+
+    pid_t child = fork();
+
+    if (child == 0)
+    {
+        dup2(output[1], STDOUT_FILENO);
+        close(output[0]);
+        close(output[1]);
+
+        execl(program, program, "--profile", profileName, "--load", mode, (char *)nullptr);
+        _exit(127);
+    }
+
+    close(output[1]);
+
+    char line[128] = {};
+    FILE *reader = fdopen(output[0], "r");
+    bool hasLine = reader != nullptr && fgets(line, sizeof(line), reader) != nullptr;
+
+    if (reader != nullptr)
+    {
+        fclose(reader);
+    }
+
+    int status = 0;
+    struct rusage usage;
+
+    if (child < 0 || wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !hasLine)
+    {
+        printf("The %s load failed:%s%s", mode, hasLine ? " " : "\n", line);
+        return false;
+    }
+
+    peakKilobytes = usage.ru_maxrss;
+
+    return sscanf(line, "%lf %ld", &milliseconds, &grownKilobytes) == 2;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *profileName = "pc";
+    const char *loadMode = nullptr;
+    int runs = 5;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+        {
+            profileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            runs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+        {
+            loadMode = argv[++i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const CookProfile *profile = findCookProfile(profileName);
+
+    if (profile == nullptr || runs <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (loadMode != nullptr)
+    {
+        return runLoad(*profile, strcmp(loadMode, "cooked") == 0);
+    }
+
+#if !defined(BREAKOUT_HAS_FREETYPE)
+    printf("FreeType wasn't found, fonts aren't loaded either way\n");
+#endif
+
+    printf("%s profile, best of %d runs\n", profile->name, runs);
+    printf("%8s %10s %12s %12s\n", "assets", "load ms", "grown KiB", "peak KiB");
+
+    const char *modes[] = {"source", "cooked"};
+
+    for (const char *mode : modes)
+    {
+        double bestMilliseconds = 0;
+        long bestGrown = 0;
+        long bestPeak = 0;
+
+        for (int run = 0; run < runs; run++)
+        {
+            double milliseconds;
+            long grown;
+            long peak;
+
+            if (!measureLoad("/proc/self/exe", profile->name, mode, milliseconds, grown, peak))
+            {
+                return 1;
+            }
+
+            if (run == 0 || milliseconds < bestMilliseconds)
+            {
+                bestMilliseconds = milliseconds;
+                bestGrown = grown;
+                bestPeak = peak;
+            }
+        }
+
+        printf("%8s %10.2f %12ld %12ld\n", mode, bestMilliseconds, bestGrown, bestPeak);
+    }
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "game.h"
+#include "presets.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Plays many seeded autoplay games to completion on a work-stealing pool, once for
+// each thread count, and prints games per second for each. A game ends when every
+// brick is gone or after --ticks steps, so games differ a lot in length.
+
+const int GAMES_PER_TASK = 16;
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--games N] [--ticks N] [--dt SECONDS] [--seed N] [--threads 1,2,4,...]\n", program);
+}
+
+std::vector<int> parseThreadCounts(const char *text)
+{
+    std::vector<int> threadCounts;
+    std::string list = text;
+
+    size_t start = 0;
+
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+
+        int threadCount = atoi(list.substr(start, end - start).c_str());
+
+        if (threadCount > 0)
+        {
+            threadCounts.push_back(threadCount);
+        }
+
+        start = end + 1;
+    }
+
+    return threadCounts;
+}
+
+int playGame(unsigned int seed, int ticks, float deltaTime)
+{
+    Game game;
+    initGame(game, PC_CONFIG);
+    serveBall(game, seed);
+
+    GameInput input = {false, false};
+
+    int brickCount = countBricks(game.bricks);
+
+    for (int tick = 0; tick < ticks && game.destroyedBricks < brickCount; tick++)
+    {
+        updateGame(game, input, deltaTime);
+    }
+
+    return game.playerScore;
+}
+
+int main(int argc, char *argv[])
+{
+    int gameCount = 10000;
+    int ticks = 36000;
+    float deltaTime = 1.0f / 60.0f;
+    unsigned int seed = 1;
+    std::vector<int> threadCounts;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+        {
+            gameCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            ticks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc)
+        {
+            deltaTime = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCounts = parseThreadCounts(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (gameCount <= 0 || ticks <= 0 || deltaTime <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (threadCounts.empty())
+    {
+        int hardwareThreads = (int)std::thread::hardware_concurrency();
+
+        for (int threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+        {
+            threadCounts.push_back(threadCount);
+        }
+
+        threadCounts.push_back(hardwareThreads > 0 ? hardwareThreads : 1);
+    }
+
+    int taskCount = (gameCount + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+
+    std::vector<int> scores(gameCount);
+
+    long long firstTotal = -1;
+    double singleThreadRate = 0;
+    bool isDeterministic = true;
+
+    printf("games: %d, max ticks per game: %d\n", gameCount, ticks);
+    printf("%8s %12s %14s %10s %10s\n", "threads", "seconds", "games/sec", "speedup", "steals");
+
+    for (int threadCount : threadCounts)
+    {
+        ThreadPool pool(threadCount);
+
+        auto start = std::chrono::steady_clock::now();
+
+        pool.run(taskCount, [&](int task, int worker) {
+            int first = task * GAMES_PER_TASK;
+            int last = std::min(first + GAMES_PER_TASK, gameCount);
+
+            for (int game = first; game < last; game++)
+            {
+                scores[game] = playGame(seed + game, ticks, deltaTime);
+            }
+        });
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate = gameCount / seconds;
+
+        if (singleThreadRate == 0)
+        {
+            singleThreadRate = rate / threadCount;
+        }
+
+        long long total = 0;
+
+        for (int score : scores)
+        {
+            total += score;
+        }
+
+        if (firstTotal < 0)
+        {
+            firstTotal = total;
+        }
+        else if (total != firstTotal)
+        {
+            isDeterministic = false;
+        }
+
+        printf("%8d %12.3f %14.0f %9.2fx %10lld\n", threadCount, seconds, rate, rate / singleThreadRate, pool.stealCount());
+    }
+
+    printf("total score: %lld%s\n", firstTotal, isDeterministic ? "" : " (differs between thread counts!)");
+
+    return isDeterministic ? 0 : 1;
+}
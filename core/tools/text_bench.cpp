@@ -0,0 +1,113 @@
+#include "text.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Times what a score change costs the HUD with a glyph atlas: formatting the string and
+// laying it out as quads. Glyph sizes are made up, as no font library is needed for the
+// layout; the ports bake the real ones from their fonts at startup.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--updates N] [--glyph-width N] [--glyph-height N]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    int updates = 1000000;
+    int glyphWidth = 20;
+    int glyphHeight = 36;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc)
+        {
+            updates = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--glyph-width") == 0 && i + 1 < argc)
+        {
+            glyphWidth = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--glyph-height") == 0 && i + 1 < argc)
+        {
+            glyphHeight = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    GlyphAtlas atlas;
+    atlas.lineHeight = glyphHeight;
+
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        // Narrower punctuation, so the shelves are not all the same.
+        int width = i < 16 ? glyphWidth / 2 : glyphWidth;
+
+        atlas.glyphs[i].w = width;
+        atlas.glyphs[i].h = glyphHeight - i % 4;
+        atlas.advances[i] = width;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!packGlyphAtlas(atlas, 512))
+    {
+        printf("glyphs don't fit in a 512 pixel wide atlas\n");
+        return 1;
+    }
+
+    double packSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<GlyphQuad> quads;
+    char scoreText[32];
+    long long glyphs = 0;
+    long long widths = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int score = 0; score < updates; score++)
+    {
+        snprintf(scoreText, sizeof(scoreText), "score: %d", score);
+
+        quads.clear();
+        widths += layoutText(atlas, scoreText, 200, 0, quads);
+        glyphs += quads.size();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("atlas: %dx%d, packed in %.1f us\n", atlas.width, atlas.height, packSeconds * 1e6);
+    printf("updates: %d, glyphs per update: %.1f, average width: %.1f px\n", updates, (double)glyphs / updates, (double)widths / updates);
+    printf("ns per update: %.1f\n", seconds * 1e9 / updates);
+
+    // Every glyph must be inside the atlas and clear of the others.
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        const AtlasRect &a = atlas.glyphs[i];
+
+        if (a.x < 0 || a.y < 0 || a.x + a.w > atlas.width || a.y + a.h > atlas.height)
+        {
+            printf("glyph %d is outside the atlas\n", i);
+            return 1;
+        }
+
+        for (int j = i + 1; j < GLYPH_COUNT; j++)
+        {
+            const AtlasRect &b = atlas.glyphs[j];
+
+            if (a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h)
+            {
+                printf("glyphs %d and %d overlap\n", i, j);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Calls ThreadPool::run() --runs times back to back with only a few --tasks each on many
+// more --threads than tasks, the way the software renderer runs a handful of tiles every
+// frame. Most workers miss most runs, which is when a worker waking late could pick up a
+// later run's tasks. Exits with 1 if any task of a run was not called exactly once by that
+// run, or was called with a worker out of range.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s [--threads N] [--tasks N] [--runs N]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    int threadCount = 16;
+    int taskCount = 3;
+    int runs = 2000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--tasks") == 0 && i + 1 < argc)
+        {
+            taskCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            runs = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (threadCount <= 0 || taskCount <= 0 || runs <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ThreadPool pool(threadCount);
+
+    std::vector<std::atomic<int>> calls(taskCount);
+    std::atomic<long long> badWorkers(0);
+    long long badRuns = 0;
+
+    for (int run = 0; run < runs; run++)
+    {
+        for (std::atomic<int> &count : calls)
+        {
+            count = 0;
+        }
+
+        // Each run gets its own task object, so one called after its run returned would
+        // touch a dead function rather than quietly counting into the next run.
+        std::function<void(int, int)> task = [&calls, &badWorkers, threadCount](int index, int worker) {
+            calls[index]++;
+
+            if (worker < 0 || worker >= threadCount)
+            {
+                badWorkers++;
+            }
+        };
+
+        pool.run(taskCount, task);
+
+        for (std::atomic<int> &count : calls)
+        {
+            if (count.load() != 1)
+            {
+                badRuns++;
+                break;
+            }
+        }
+    }
+
+    printf("threads: %d, tasks: %d, runs: %d, steals: %lld\n", threadCount, taskCount, runs, pool.stealCount());
+    printf("runs with a task not called exactly once: %lld, calls with a bad worker: %lld\n", badRuns, badWorkers.load());
+
+    return badRuns == 0 && badWorkers.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Compares two traces written by breakout_headless --trace, usually one from the
+// float build and one from the fixed-point build of the same replay. Fails if the
+// ball drifts further apart than the tolerance, or if score or lives ever differ.
+
+void printUsage(const char *program)
+{
+    printf("usage: %s TRACE_A TRACE_B [--tolerance PIXELS]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *paths[2] = {nullptr, nullptr};
+    int pathCount = 0;
+    double tolerance = 0.5;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else if (pathCount < 2)
+        {
+            paths[pathCount++] = argv[i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (pathCount != 2)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE *traces[2];
+
+    for (int i = 0; i < 2; i++)
+    {
+        traces[i] = fopen(paths[i], "r");
+
+        if (traces[i] == nullptr)
+        {
+            printf("Failed to open trace file %s\n", paths[i]);
+            return 1;
+        }
+    }
+
+    long long samples = 0;
+    long long firstFailure = -1;
+    double maxDistance = 0;
+    long long maxDistanceTick = 0;
+
+    while (true)
+    {
+        long long tick[2];
+        double ballX[2], ballY[2];
+        int score[2], lives[2];
+
+        int readA = fscanf(traces[0], "%lld %lf %lf %d %d", &tick[0], &ballX[0], &ballY[0], &score[0], &lives[0]);
+        int readB = fscanf(traces[1], "%lld %lf %lf %d %d", &tick[1], &ballX[1], &ballY[1], &score[1], &lives[1]);
+
+        if (readA != 5 || readB != 5)
+        {
+            if (readA == 5 || readB == 5)
+            {
+                printf("traces have different lengths\n");
+                firstFailure = samples;
+            }
+
+            break;
+        }
+
+        if (tick[0] != tick[1])
+        {
+            printf("traces were sampled at different ticks (%lld and %lld)\n", tick[0], tick[1]);
+            return 1;
+        }
+
+        double distance = std::fmax(std::fabs(ballX[0] - ballX[1]), std::fabs(ballY[0] - ballY[1]));
+
+        if (distance > maxDistance)
+        {
+            maxDistance = distance;
+            maxDistanceTick = tick[0];
+        }
+
+        if (firstFailure < 0 && (distance > tolerance || score[0] != score[1] || lives[0] != lives[1]))
+        {
+            firstFailure = tick[0];
+        }
+
+        samples++;
+    }
+
+    fclose(traces[0]);
+    fclose(traces[1]);
+
+    printf("samples: %lld\n", samples);
+    printf("max ball distance: %.5f px at tick %lld\n", maxDistance, maxDistanceTick);
+
+    if (firstFailure >= 0)
+    {
+        printf("traces diverge beyond %.3f px at tick %lld\n", tolerance, firstFailure);
+        return 1;
+    }
+
+    printf("traces agree within %.3f px\n", tolerance);
+
+    return 0;
+}
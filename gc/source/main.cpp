@@ -4,6 +4,8 @@
 #include <iostream>
 #include <ogc/pad.h>
 #include "BMfont3_png.h"
+#include "game.h"
+#include "presets.h"
 
 #define BLACK 0x000000FF
 #define WHITE 0xFFFFFFFF
@@ -13,134 +15,69 @@
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-bool isAutoPlayMode = true;
-
 bool isGamePaused;
 
-typedef struct
-{
-    float x;
-    float y;
-    float w;
-    float h;
-    unsigned int color;
-    bool isDestroyed;
-    int brickPoints;
-} Rectangle;
-
-Rectangle player = {SCREEN_WIDTH / 2, SCREEN_HEIGHT - 16, 42, 16, WHITE};
-
-Rectangle ball = {SCREEN_WIDTH / 2 - 16, SCREEN_HEIGHT / 2 - 16, 16, 16, WHITE};
-
-const int playerSpeed = 6;
-
-int ballVelocityX = 4;
-int ballVelocityY = 4;
+Game game;
 
-int playerScore;
-int playerLives = 2;
+// Quads for the bricks of each color, even rows first.
+std::vector<guVector> brickVertices[2];
+std::vector<u32> brickColors[2];
 
-std::vector<Rectangle> createBricks()
+void update(u32 padDown, u32 padHeld)
 {
-    std::vector<Rectangle> bricks;
-
-    int brickPoints = 8;
-    int positionX;
-    int positionY = 50;
-
-    for (int row = 0; row < 8; row++)
+    if (padDown & PAD_BUTTON_A)
     {
-        positionX = 0;
-
-        for (int column = 0; column < 15; column++)
-        {
-            unsigned int color = RED;
-
-            if (row % 2 == 0)
-            {
-                color = TEAL;
-            }
-
-            Rectangle actualBrick = {(float)positionX, (float)positionY, 41, 16, color, false, brickPoints};
-
-            bricks.push_back(actualBrick);
-            positionX += 43;
-        }
-
-        brickPoints--;
-        positionY += 18;
+        game.isAutoPlayMode = !game.isAutoPlayMode;
     }
 
-    return bricks;
-}
-
-std::vector<Rectangle> bricks = createBricks();
+    GameInput input = {(padHeld & PAD_BUTTON_LEFT) != 0, (padHeld & PAD_BUTTON_RIGHT) != 0};
 
-bool hasCollision(Rectangle bounds, Rectangle ball)
-{
-    return bounds.x < ball.x + ball.w && bounds.x + bounds.w > ball.x &&
-           bounds.y < ball.y + ball.h && bounds.y + bounds.h > ball.y;
+    // speeds in the preset are per frame, so each frame is one unit of time.
+    updateGame(game, input, 1);
 }
 
-void update(u32 padDown, u32 padHeld)
+void addBrickQuad(int color, const Bounds &brick, u32 rgba)
 {
-    if (padDown & PAD_BUTTON_A)
+    const guVector corners[4] = {
+        {brick.x, brick.y, 0},
+        {brick.x + brick.w, brick.y, 0},
+        {brick.x + brick.w, brick.y + brick.h, 0},
+        {brick.x, brick.y + brick.h, 0},
+    };
+
+    for (const guVector &corner : corners)
     {
-        isAutoPlayMode = !isAutoPlayMode;
-    }
-
-    if (isAutoPlayMode && ball.x < SCREEN_WIDTH - player.w)
-    {
-        player.x = ball.x;
+        brickVertices[color].push_back(corner);
+        brickColors[color].push_back(rgba);
     }
+}
 
-    if (padHeld & PAD_BUTTON_LEFT && player.x > 0)
-    {
-        player.x -= playerSpeed;
-    }
+// One GX_QUADS draw per color instead of a GRRLIB_Rectangle() per brick.
+void drawBricks()
+{
+    const u32 colors[2] = {TEAL, RED};
 
-    else if (padHeld & PAD_BUTTON_RIGHT && player.x < SCREEN_WIDTH - player.w)
+    for (int color = 0; color < 2; color++)
     {
-        player.x += playerSpeed;
+        brickVertices[color].clear();
+        brickColors[color].clear();
     }
 
-    if (ball.y > SCREEN_HEIGHT + ball.h)
+    for (int row = 0; row < game.bricks.rows; row++)
     {
-        ball.x = SCREEN_WIDTH / 2 - ball.w;
-        ball.y = SCREEN_HEIGHT / 2 - ball.h;
-
-        ballVelocityX *= -1;
-
-        if (playerLives > 0)
+        for (int column = findNextBrick(game.bricks, row, 0); column >= 0; column = findNextBrick(game.bricks, row, column + 1))
         {
-            playerLives--;
+            addBrickQuad(row % 2, getBrickBounds(game.config, row, column), colors[row % 2]);
         }
     }
 
-    if (ball.x < 0 || ball.x > SCREEN_WIDTH - ball.w)
+    for (int color = 0; color < 2; color++)
     {
-        ballVelocityX *= -1;
-    }
-
-    if (hasCollision(player, ball) || ball.y < 0)
-    {
-        ballVelocityY *= -1;
-    }
-
-    for (Rectangle &brick : bricks)
-    {
-        if (!brick.isDestroyed && hasCollision(brick, ball))
+        if (!brickVertices[color].empty())
         {
-            ballVelocityY *= -1;
-            brick.isDestroyed = true;
-            playerScore += brick.brickPoints;
-
-            break;
+            GRRLIB_GXEngine(brickVertices[color].data(), brickColors[color].data(), (long)brickVertices[color].size(), GX_QUADS);
         }
     }
-
-    ball.x += ballVelocityX;
-    ball.y += ballVelocityY;
 }
 
 int main(int argc, char **argv)
@@ -151,6 +88,8 @@ int main(int argc, char **argv)
     GRRLIB_texImg *tex_BMfont3 = GRRLIB_LoadTexture(BMfont3_png);
     GRRLIB_InitTileSet(tex_BMfont3, 32, 32, 32);
 
+    initGame(game, GC_CONFIG);
+
     while (true)
     {
         PAD_ScanPads();
@@ -175,25 +114,19 @@ int main(int argc, char **argv)
 
         GRRLIB_FillScreen(BLACK);
 
-        std::string scoreString = "SCORE: " + std::to_string(playerScore);
+        std::string scoreString = "SCORE: " + std::to_string(game.playerScore);
 
         GRRLIB_Printf(20, 0, tex_BMfont3, WHITE, 1, scoreString.c_str());
 
-        std::string livesString = "LIVES: " + std::to_string(playerLives);
+        std::string livesString = "LIVES: " + std::to_string(game.playerLives);
 
         GRRLIB_Printf(370, 0, tex_BMfont3, WHITE, 1, livesString.c_str());
 
-        for (Rectangle brick : bricks)
-        {
-            if (!brick.isDestroyed)
-            {
-                GRRLIB_Rectangle(brick.x, brick.y, brick.w, brick.h, brick.color, 1);
-            }
-        }
+        drawBricks();
 
         // the last value of the GRRLIB_Rectangle is for indicate if the rectangle should be draw filled or not.
-        GRRLIB_Rectangle(ball.x, ball.y, ball.w, ball.h, ball.color, 1);
-        GRRLIB_Rectangle(player.x, player.y, player.w, player.h, player.color, 1);
+        GRRLIB_Rectangle(game.ball.x, game.ball.y, game.ball.w, game.ball.h, WHITE, 1);
+        GRRLIB_Rectangle(game.player.x, game.player.y, game.player.w, game.player.h, WHITE, 1);
 
         if (isGamePaused)
         {
@@ -1,8 +1,25 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <utility>
 #include <vector>
+#include "audio_stage.h"
+#include "cooked.h"
+#include "game.h"
+#include "mixer.h"
+#include "mod_player.h"
+#include "music_stream.h"
+#include "particles.h"
+#include "presets.h"
+#include "render_list.h"
+#include "sdl_draw.h"
+#include "sdl_render_backend.h"
+#include "snapshot.h"
+#include "text.h"
+#include "timestep.h"
+#include "triple_buffer.h"
 
 const int SCREEN_WIDTH = 960;
 const int SCREEN_HEIGHT = 544;
@@ -12,71 +29,144 @@ SDL_Renderer *renderer = nullptr;
 
 TTF_Font *fontSquare = nullptr;
 
-SDL_Texture *scoreTexture = nullptr;
-SDL_Rect scoreBounds;
-
-SDL_Texture *liveTexture = nullptr;
-SDL_Rect liveBounds;
-
 SDL_Color fontColor = {255, 255, 255};
 
-Mix_Chunk *collisionSound = nullptr;
-Mix_Chunk *collisionWithPlayerSound = nullptr;
-
-SDL_Rect player = {SCREEN_WIDTH / 2, SCREEN_HEIGHT - 32, 74, 16};
-
-int playerScore;
-int playerLives = 2;
+GlyphAtlas hudAtlas;
+SDL_Texture *hudAtlasTexture = nullptr;
+
+char scoreText[32] = "Score: 0";
+char livesText[32] = "Lives: 2";
+int shownScore = -1;
+int shownLives = -1;
+
+// The simulation thread queues its sounds and the main thread starts them once per frame
+// through the audio stage, which picks the mixer voice for each. The sounds are mixed in
+// the audio device's callback, already converted to the device's format when they loaded.
+const int SOUND_VOICES = 8;
+const int AUDIO_RATE = 48000;
+int audioBufferFrames = 256;
+
+// A sound starts a fixed delay after its hit, on the exact frame, rather than whenever the
+// buffer after it is mixed. The delay covers the hit's tick ending, the stage only running
+// once per rendered frame and the callback taking commands a buffer at a time. The frame
+// is the display's refresh period, or this rate's when SDL doesn't know it.
+const int DEFAULT_REFRESH_RATE = 60;
+
+SDL_AudioDeviceID audioDevice = 0;
+Mixer mixer;
+SpscQueue<MixerCommand> mixerCommands(64);
+
+// --music streams a WAV or plays a module: a decode thread keeps the ring ahead of the
+// callback, which only copies out of it, so a WAV is never in memory whole.
+const int MUSIC_RING_FRAMES = 8192;
+const int MUSIC_VOLUME = MIXER_FULL_VOLUME / 2;
+
+const char *musicPath = nullptr;
+WavMusic wavMusic;
+ModPlayer modMusic;
+MusicSource *music = &wavMusic;
+MusicStream musicStream(MUSIC_RING_FRAMES);
+SDL_Thread *musicThread = nullptr;
+std::atomic<bool> isMusicPlaying(false);
+
+SpscQueue<SoundEvent> soundEvents(256);
+AudioStage audioStage;
+std::vector<VoiceStart> voiceStarts;
+std::vector<int> stageMixerSounds;
+int collisionSoundId = -1;
+int collisionWithPlayerSoundId = -1;
+
+Game game;
+
+// The game is simulated at a fixed rate on its own thread, which publishes a snapshot
+// after every tick; the main thread handles input and draws the latest snapshot,
+// interpolated from the tick before it, so a slow present never holds the simulation up.
+int ticksPerSecond = 120;
+const int MAX_TICKS_PER_FRAME = 8;
+
+Bounds previousPlayer;
+Bounds previousBall;
+
+TripleBuffer<GameSnapshot> snapshots;
+SDL_Thread *simulationThread = nullptr;
+std::atomic<bool> isSimulationRunning(false);
+
+// The keys the simulation thread reads, set by the main thread.
+const int INPUT_MOVE_LEFT = 1 << 0;
+const int INPUT_MOVE_RIGHT = 1 << 1;
+const int INPUT_TOGGLE_AUTOPLAY = 1 << 2;
+
+std::atomic<int> inputKeys(0);
+
+// --present-hitch MS sleeps that long before every 60th present, to see that the
+// simulation keeps its rate through it.
+int presentHitchMilliseconds = 0;
+const int PRESENT_HITCH_FRAMES = 60;
+
+BrickLayer brickLayer;
+
+// Each frame is recorded into renderList, sorted, and drawn by renderBackend.
+const int SCENE_LAYER = 0;
+const int PLAYER_LAYER = 1;
+
+const uint32_t WHITE = 0xffffffff;
+const uint32_t CYAN = 0xff00ffff;
+
+RenderList renderList;
+SdlRenderBackend *renderBackend = nullptr;
+int hudAtlasTextureId = NO_TEXTURE;
+int brickLayerTextureId = NO_TEXTURE;
+
+// Every destroyed brick bursts into particles. They are only for show, so the main thread
+// runs them at the frame rate and bursts the bricks that went missing since the last
+// snapshot; --particle-burst N sets the particles per brick, 0 turns them off.
+const int MAX_PARTICLES = 50000;
+const float PARTICLE_SPEED = 240;
+const float PARTICLE_LIFE = 1;
+const float PARTICLE_GRAVITY = 600;
+const float PARTICLE_SIZE = 3;
+
+int particleBurst = 64;
+ParticlePool particles;
+BrickField burstBricks;
+std::vector<Bounds> destroyedBricks;
+Uint64 previousParticleTime = 0;
+
+std::vector<float> particleXY;
+std::vector<uint8_t> particleRGBA;
+std::vector<int> particleIndices;
+
+// --render-stats prints the draw calls and the CPU time of render() every few seconds.
+bool isPrintingRenderStats = false;
+const int RENDER_STATS_FRAMES = 600;
+
+int renderedFrames = 0;
+Uint64 renderCounterTicks = 0;
+Uint64 renderStatsStart = 0;
+long long renderStatsFirstTick = 0;
 
-SDL_Rect ball = {SCREEN_WIDTH / 2 - 20, SCREEN_HEIGHT / 2 - 20, 20, 20};
-
-int playerSpeed = 800;
-int ballVelocityX = 425;
-int ballVelocityY = 425;
-
-bool isAutoPlayMode = true;
-
-typedef struct
-{
-    SDL_Rect bounds;
-    bool isDestroyed;
-    int points;
-} Brick;
-
-std::vector<Brick> createBricks()
+void quitGame()
 {
-    std::vector<Brick> bricks;
-
-    //8*15 Bricks
-    bricks.reserve(120);
-
-    int brickPoints = 8;
-    int positionX;
-    int positionY = 40;
-
-    for (int row = 0; row < 8; row++)
+    if (simulationThread != nullptr)
     {
-        positionX = 0;
-
-        for (int column = 0; column < 15; column++)
-        {
-            Brick actualBrick = {{positionX, positionY, 60, 20}, false, brickPoints};
-
-            bricks.push_back(actualBrick);
-            positionX += 64;
-        }
-
-        brickPoints--;
-        positionY += 22;
+        isSimulationRunning = false;
+        SDL_WaitThread(simulationThread, NULL);
+        simulationThread = nullptr;
     }
 
-    return bricks;
-}
+    if (audioDevice != 0)
+    {
+        SDL_CloseAudioDevice(audioDevice);
+        audioDevice = 0;
+    }
 
-std::vector<Brick> bricks = createBricks();
+    if (musicThread != nullptr)
+    {
+        isMusicPlaying = false;
+        SDL_WaitThread(musicThread, NULL);
+        musicThread = nullptr;
+    }
 
-void quitGame()
-{
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -88,6 +178,12 @@ void handleEvents()
 
     while (SDL_PollEvent(&event))
     {
+        // Render target contents are lost with the device on some backends.
+        if (event.type == SDL_RENDER_TARGETS_RESET)
+        {
+            brickLayer.isDirty = true;
+        }
+
         if (event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
         {
             quitGame();
@@ -96,6 +192,7 @@ void handleEvents()
     }
 }
 
+// Only used by --text-bench now, to compare against the glyph atlas.
 void updateTextureText(SDL_Texture *&texture, const char *text) {
 
     if (fontSquare == nullptr) {
@@ -119,135 +216,503 @@ void updateTextureText(SDL_Texture *&texture, const char *text) {
     SDL_FreeSurface(surface);
 }
 
-void update(float deltaTime)
+void readInput()
 {
     const Uint8 *currentKeyStates = SDL_GetKeyboardState(NULL);
 
-    if (currentKeyStates[SDL_SCANCODE_W])
+    int keys = 0;
+    keys |= currentKeyStates[SDL_SCANCODE_A] ? INPUT_MOVE_LEFT : 0;
+    keys |= currentKeyStates[SDL_SCANCODE_D] ? INPUT_MOVE_RIGHT : 0;
+    keys |= currentKeyStates[SDL_SCANCODE_W] ? INPUT_TOGGLE_AUTOPLAY : 0;
+
+    inputKeys.store(keys, std::memory_order_relaxed);
+}
+
+// Runs on the simulation thread. tickTime is when the tick starts, in seconds of the
+// performance counter.
+void update(Number deltaTime, double tickTime)
+{
+    int keys = inputKeys.load(std::memory_order_relaxed);
+
+    if (keys & INPUT_TOGGLE_AUTOPLAY)
     {
-        isAutoPlayMode = !isAutoPlayMode;
+        game.isAutoPlayMode = !game.isAutoPlayMode;
     }
 
-    if (isAutoPlayMode && ball.x < SCREEN_WIDTH - player.w)
+    GameInput input = {(keys & INPUT_MOVE_LEFT) != 0, (keys & INPUT_MOVE_RIGHT) != 0};
+
+    previousPlayer = game.player;
+    previousBall = game.ball;
+
+    int events = updateGame(game, input, deltaTime);
+
+    if (events & GAME_EVENT_LIFE_LOST)
     {
-        player.x = ball.x;
+        // The ball was served again, don't slide it across the screen.
+        previousBall = game.ball;
     }
 
-    if (player.x > 0 && currentKeyStates[SDL_SCANCODE_A])
+    // Each sound carries when in the tick its hit happened, so the mixer can start it on
+    // that frame instead of the tick's.
+    if (events & (GAME_EVENT_WALL_HIT | GAME_EVENT_BRICK_HIT))
     {
-        player.x -= playerSpeed * deltaTime;
+        Number hitTime = firstEventTime(game, events & (GAME_EVENT_WALL_HIT | GAME_EVENT_BRICK_HIT)) * deltaTime;
+        SoundEvent event = {collisionSoundId, tickTime + (float)hitTime};
+        soundEvents.push(event);
     }
 
-    else if (player.x < SCREEN_WIDTH - player.w && currentKeyStates[SDL_SCANCODE_D])
+    if (events & (GAME_EVENT_PLAYER_HIT | GAME_EVENT_CEILING_HIT))
     {
-        player.x += playerSpeed * deltaTime;
+        Number hitTime = firstEventTime(game, events & (GAME_EVENT_PLAYER_HIT | GAME_EVENT_CEILING_HIT)) * deltaTime;
+        SoundEvent event = {collisionWithPlayerSoundId, tickTime + (float)hitTime};
+        soundEvents.push(event);
     }
+}
 
-    if (ball.y > SCREEN_HEIGHT + ball.h)
+double counterSeconds(Uint64 counter)
+{
+    return (double)counter / SDL_GetPerformanceFrequency();
+}
+
+void mixCallback(void *userdata, Uint8 *stream, int length)
+{
+    int frames = length / (MIXER_CHANNELS * (int)sizeof(int16_t));
+
+    mixAudio(mixer, mixerCommands, (int16_t *)stream, frames, counterSeconds(SDL_GetPerformanceCounter()));
+
+    if (isMusicPlaying.load(std::memory_order_acquire))
     {
-        ball.x = SCREEN_WIDTH / 2 - ball.w;
-        ball.y = SCREEN_HEIGHT / 2 - ball.h;
+        musicStream.mix((int16_t *)stream, frames, MUSIC_VOLUME);
+    }
+}
 
-        ballVelocityX *= -1;
+// How long a rendered frame lasts. Presents wait for vsync, so it is the refresh period of
+// the window's display; without vsync (--software) frames are usually shorter.
+double renderFrameSeconds()
+{
+    SDL_DisplayMode mode;
+    int display = SDL_GetWindowDisplayIndex(window);
 
-        if (playerLives > 0)
-        {
-            playerLives--;
+    if (display < 0 || SDL_GetCurrentDisplayMode(display, &mode) != 0 || mode.refresh_rate <= 0)
+    {
+        return 1.0 / DEFAULT_REFRESH_RATE;
+    }
 
-            std::string livesString = "lives: " + std::to_string(playerLives);
+    return 1.0 / mode.refresh_rate;
+}
 
-            updateTextureText(liveTexture, livesString.c_str());
-        }
+// Signed 16-bit stereo at whatever rate the device prefers; the sounds are converted to
+// it, so the callback never converts anything.
+void openAudio()
+{
+    SDL_AudioSpec desired = {};
+    desired.freq = AUDIO_RATE;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = MIXER_CHANNELS;
+    desired.samples = (Uint16)audioBufferFrames;
+    desired.callback = mixCallback;
+
+    SDL_AudioSpec obtained;
+    audioDevice = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+
+    if (audioDevice == 0)
+    {
+        printf("Unable to open the audio device! SDL Error: %s\n", SDL_GetError());
+        initMixer(mixer, AUDIO_RATE, SOUND_VOICES);
+        return;
     }
 
-    if (ball.x < 0 || ball.x > SCREEN_WIDTH - ball.w)
+    initMixer(mixer, obtained.freq, SOUND_VOICES);
+    mixer.startDelay = 1.0 / ticksPerSecond + renderFrameSeconds() + 2.0 * obtained.samples / obtained.freq;
+}
+
+// Adds a sound to the mixer and to the audio stage with how long it plays. The file
+// breakout_cook made is already in the mixer's format and only has to be read; without
+// one the WAV is decoded and converted. A missing sound still gets an id, it just plays
+// nothing.
+int addStageSoundFile(const char *cookedPath, const char *wavPath, int priority)
+{
+    PcmSound sound = {};
+
+    if (!loadCookedPcm(cookedPath, sound))
     {
-        ballVelocityX *= -1;
-        Mix_PlayChannel(-1, collisionSound, 0);
+        loadWavFile(wavPath, sound);
     }
 
-    if (SDL_HasIntersection(&player, &ball) || ball.y < 0)
+    int mixerSound = addMixerSound(mixer, std::move(sound));
+    stageMixerSounds.push_back(mixerSound);
+
+    return addStageSound(audioStage, priority, mixerSoundSeconds(mixer, mixerSound));
+}
+
+int runMusicDecoder(void *)
+{
+    while (isMusicPlaying.load(std::memory_order_relaxed) && !musicStream.hasEnded())
     {
-        ballVelocityY *= -1;
-        Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
+        musicStream.fill(*music);
+
+        // A few buffers' worth, far inside the ring's 170 ms.
+        SDL_Delay(5);
     }
 
-    for (auto actualBrick = bricks.begin(); actualBrick != bricks.end();)
+    return 0;
+}
+
+bool hasExtension(const char *path, const char *extension)
+{
+    size_t length = strlen(path);
+    size_t extensionLength = strlen(extension);
+
+    return length >= extensionLength && SDL_strcasecmp(path + length - extensionLength, extension) == 0;
+}
+
+void startMusic(const char *path)
+{
+    if (hasExtension(path, ".mod"))
     {
-        if (!actualBrick->isDestroyed && SDL_HasIntersection(&actualBrick->bounds, &ball))
+        music = &modMusic;
+
+        if (!modMusic.loadFile(path, mixer.rate, true))
         {
-            ballVelocityY *= -1;
-            actualBrick->isDestroyed = true;
+            return;
+        }
+    }
+    else if (!wavMusic.open(path, mixer.rate, true))
+    {
+        return;
+    }
 
-            playerScore += actualBrick->points;
+    // Full before the callback first reads it.
+    musicStream.fill(*music);
+    isMusicPlaying = true;
 
-            std::string scoreString = "score: " + std::to_string(playerScore);
+    musicThread = SDL_CreateThread(runMusicDecoder, "music", NULL);
 
-            updateTextureText(scoreTexture, scoreString.c_str());
+    if (musicThread == nullptr)
+    {
+        printf("Unable to start the music thread! SDL Error: %s\n", SDL_GetError());
+        isMusicPlaying = false;
+    }
+}
 
-            Mix_PlayChannel(-1, collisionSound, 0);
-        }
+void playSounds()
+{
+    voiceStarts.clear();
+    runAudioStage(audioStage, soundEvents, counterSeconds(SDL_GetPerformanceCounter()), voiceStarts);
+
+    for (const VoiceStart &start : voiceStarts)
+    {
+        MixerCommand command = {start.voice, stageMixerSounds[start.sound], MIXER_FULL_VOLUME, start.time};
+        mixerCommands.push(command);
+    }
+}
+
+void publishSnapshot(long long tick)
+{
+    takeGameSnapshot(snapshots.writeBuffer(), game, previousPlayer, previousBall, tick, SDL_GetPerformanceCounter());
+    snapshots.publish();
+}
+
+int runSimulation(void *)
+{
+    FixedTimestep timestep;
+    initFixedTimestep(timestep, ticksPerSecond, MAX_TICKS_PER_FRAME, SDL_GetPerformanceFrequency());
+
+    long long tick = 0;
+    Uint64 previousTime = SDL_GetPerformanceCounter();
 
-        if (actualBrick->isDestroyed)
+    while (isSimulationRunning.load(std::memory_order_relaxed))
+    {
+        Uint64 currentTime = SDL_GetPerformanceCounter();
+        int ticks = advanceFixedTimestep(timestep, currentTime - previousTime);
+        previousTime = currentTime;
+
+        double endTime = counterSeconds(fixedTimestepEndTime(timestep, currentTime));
+
+        for (int i = 0; i < ticks; i++)
         {
-            bricks.erase(actualBrick);
+            update(fixedTimestepDelta(timestep), endTime - (double)(ticks - i) / ticksPerSecond);
+            publishSnapshot(++tick);
         }
-        else
+
+        // Shorter than a tick even at 240 Hz, so ticks run on time without spinning.
+        SDL_Delay(1);
+    }
+
+    return 0;
+}
+
+// Times score changes drawn the old way, rendering the string with SDL_ttf into a new
+// texture each time, and through the glyph atlas.
+void runTextBench()
+{
+    const int updates = 1000;
+
+    char text[32];
+    SDL_Texture *texture = nullptr;
+    SDL_Rect bounds = {200, 0, 0, 0};
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int score = 0; score < updates; score++)
+    {
+        snprintf(text, sizeof(text), "score: %d", score);
+
+        updateTextureText(texture, text);
+        SDL_QueryTexture(texture, NULL, NULL, &bounds.w, &bounds.h);
+        SDL_RenderCopy(renderer, texture, NULL, &bounds);
+    }
+
+    SDL_RenderFlush(renderer);
+    Uint64 textureTicks = SDL_GetPerformanceCounter() - start;
+
+    SDL_DestroyTexture(texture);
+
+    start = SDL_GetPerformanceCounter();
+
+    for (int score = 0; score < updates; score++)
+    {
+        snprintf(text, sizeof(text), "score: %d", score);
+
+        drawText(renderer, hudAtlasTexture, hudAtlas, text, 200, 0);
+    }
+
+    SDL_RenderFlush(renderer);
+    Uint64 atlasTicks = SDL_GetPerformanceCounter() - start;
+
+    double microsecondsPerTick = 1000000.0 / SDL_GetPerformanceFrequency();
+
+    printf("score updates: %d\n", updates);
+    printf("SDL_ttf texture per update: %.2f us\n", textureTicks * microsecondsPerTick / updates);
+    printf("glyph atlas per update: %.2f us\n", atlasTicks * microsecondsPerTick / updates);
+}
+
+AtlasRect toAtlasRect(const Bounds &bounds)
+{
+    AtlasRect rect = {(int)bounds.x, (int)bounds.y, (int)bounds.w, (int)bounds.h};
+
+    return rect;
+}
+
+void initParticles()
+{
+    initParticlePool(particles, MAX_PARTICLES, SDL_GetTicks() + 1);
+
+    particleXY.resize(MAX_PARTICLES * 8);
+    particleRGBA.resize(MAX_PARTICLES * 16);
+    makeParticleIndices(particleIndices, MAX_PARTICLES);
+
+    burstBricks = game.bricks;
+    previousParticleTime = SDL_GetPerformanceCounter();
+}
+
+void updateParticleBursts(const GameSnapshot &snapshot)
+{
+    if (burstBricks.aliveMasks != snapshot.bricks.aliveMasks)
+    {
+        destroyedBricks.clear();
+
+        if (findClearedBricks(game.config, burstBricks, snapshot.bricks, destroyedBricks))
         {
-            actualBrick++;
+            for (const Bounds &brick : destroyedBricks)
+            {
+                emitParticleBurst(particles, brick, particleBurst, CYAN, PARTICLE_SPEED, PARTICLE_LIFE);
+            }
         }
+
+        burstBricks = snapshot.bricks;
+    }
+
+    Uint64 currentTime = SDL_GetPerformanceCounter();
+    float deltaTime = (float)(currentTime - previousParticleTime) / SDL_GetPerformanceFrequency();
+    previousParticleTime = currentTime;
+
+    // A long hitch shouldn't fling the particles off the screen.
+    updateParticles(particles, deltaTime < 0.1f ? deltaTime : 0.1f, PARTICLE_GRAVITY);
+}
+
+// All the particles in one call.
+void drawParticles()
+{
+    if (particles.count == 0)
+    {
+        return;
     }
 
-    ball.x += ballVelocityX * deltaTime;
-    ball.y += ballVelocityY * deltaTime;
+    int vertexCount = writeParticleVertices(particles, PARTICLE_SIZE, particleXY.data(), particleRGBA.data());
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometryRaw(renderer, NULL, particleXY.data(), 2 * sizeof(float), (const SDL_Color *)particleRGBA.data(), 4, NULL, 0, vertexCount,
+                          particleIndices.data(), particles.count * 6, sizeof(int));
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    renderBackend->drawCalls++;
+}
+
+void printRenderStats(const GameSnapshot &snapshot)
+{
+    double milliseconds = renderCounterTicks * 1000.0 / SDL_GetPerformanceFrequency();
+    double seconds = (double)(SDL_GetPerformanceCounter() - renderStatsStart) / SDL_GetPerformanceFrequency();
+
+    printf("bricks: %d, particles: %d, draw calls per frame: %.1f, state changes per frame: %.1f, render ms per frame: %.3f, "
+           "ticks per second: %.1f\n",
+           countBricks(snapshot.bricks), particles.count, (double)renderBackend->drawCalls / renderedFrames,
+           (double)renderBackend->stateChanges / renderedFrames, milliseconds / renderedFrames, (snapshot.tick - renderStatsFirstTick) / seconds);
+    printf("sounds played: %lld, coalesced: %lld, stolen: %lld, dropped: %lld, queue full: %lld, music underruns: %lld\n", audioStage.played,
+           audioStage.coalesced, audioStage.stolen, audioStage.dropped, soundEvents.droppedCount(), musicStream.underrunCount());
 }
 
 void render()
 {
+    Uint64 renderStart = SDL_GetPerformanceCounter();
+
+    snapshots.update();
+    const GameSnapshot &snapshot = snapshots.readBuffer();
+
+    updateParticleBursts(snapshot);
+
+    // How far between the snapshot's tick and the next one this frame is.
+    Uint64 sinceTick = SDL_GetPerformanceCounter() - snapshot.tickTime;
+    float alpha = (float)sinceTick * ticksPerSecond / SDL_GetPerformanceFrequency();
+    alpha = alpha < 1 ? alpha : 1;
+
+    if (snapshot.playerScore != shownScore)
+    {
+        snprintf(scoreText, sizeof(scoreText), "score: %d", snapshot.playerScore);
+        shownScore = snapshot.playerScore;
+    }
+
+    if (snapshot.playerLives != shownLives)
+    {
+        snprintf(livesText, sizeof(livesText), "lives: %d", snapshot.playerLives);
+        shownLives = snapshot.playerLives;
+    }
+
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    SDL_QueryTexture(scoreTexture, NULL, NULL, &scoreBounds.w, &scoreBounds.h);
-    scoreBounds.x = 200;
-    scoreBounds.y = scoreBounds.h / 2 - 10;
-    SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreBounds);
+    clearRenderList(renderList);
 
-    SDL_QueryTexture(liveTexture, NULL, NULL, &liveBounds.w, &liveBounds.h);
-    liveBounds.x = 600;
-    liveBounds.y = liveBounds.h / 2 - 10;
-    SDL_RenderCopy(renderer, liveTexture, NULL, &liveBounds);
+    addRenderText(renderList, SCENE_LAYER, hudAtlasTextureId, hudAtlas, scoreText, 200, hudAtlas.lineHeight / 2 - 10, WHITE);
+    addRenderText(renderList, SCENE_LAYER, hudAtlasTextureId, hudAtlas, livesText, 600, hudAtlas.lineHeight / 2 - 10, WHITE);
+
+    if (brickLayer.texture != nullptr)
+    {
+        updateBrickLayer(renderer, brickLayer, game.config, snapshot.bricks);
 
-    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
+        AtlasRect source = {0, 0, brickLayer.bounds.w, brickLayer.bounds.h};
+        AtlasRect destination = {brickLayer.bounds.x, brickLayer.bounds.y, brickLayer.bounds.w, brickLayer.bounds.h};
 
-    for (Brick brick : bricks)
+        addRenderImage(renderList, SCENE_LAYER, brickLayerTextureId, source, destination, WHITE);
+    }
+    else
     {
-        if (!brick.isDestroyed)
-            SDL_RenderFillRect(renderer, &brick.bounds);
+        for (int row = 0; row < snapshot.bricks.rows; row++)
+        {
+            for (int column = findNextBrick(snapshot.bricks, row, 0); column >= 0; column = findNextBrick(snapshot.bricks, row, column + 1))
+            {
+                addRenderRect(renderList, SCENE_LAYER, toAtlasRect(getBrickBounds(game.config, row, column)), CYAN);
+            }
+        }
     }
 
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    addRenderRect(renderList, PLAYER_LAYER, toAtlasRect(interpolateBounds(snapshot.previousPlayer, snapshot.player, alpha)), WHITE);
+    addRenderRect(renderList, PLAYER_LAYER, toAtlasRect(interpolateBounds(snapshot.previousBall, snapshot.ball, alpha)), WHITE);
 
-    SDL_RenderFillRect(renderer, &player);
-    SDL_RenderFillRect(renderer, &ball);
+    sortRenderList(renderList);
+    submitRenderList(renderList, *renderBackend);
 
-    SDL_RenderPresent(renderer);
-}
+    drawParticles();
 
-Mix_Chunk *loadSound(const char *p_filePath)
-{
-    Mix_Chunk *sound = nullptr;
+    // Everything up to the present: with vsync the present only waits.
+    renderCounterTicks += SDL_GetPerformanceCounter() - renderStart;
+    renderedFrames++;
 
-    sound = Mix_LoadWAV(p_filePath);
-    if (sound == nullptr)
+    if (presentHitchMilliseconds > 0 && renderedFrames % PRESENT_HITCH_FRAMES == 0)
     {
-        printf("Failed to load scratch sound effect! SDL_mixer Error: %s\n", Mix_GetError());
+        SDL_Delay(presentHitchMilliseconds);
     }
 
-    return sound;
+    SDL_RenderPresent(renderer);
+
+    if (renderedFrames == RENDER_STATS_FRAMES)
+    {
+        if (isPrintingRenderStats)
+        {
+            printRenderStats(snapshot);
+        }
+
+        renderBackend->drawCalls = 0;
+        renderBackend->stateChanges = 0;
+        renderedFrames = 0;
+        renderCounterTicks = 0;
+        renderStatsStart = SDL_GetPerformanceCounter();
+        renderStatsFirstTick = snapshot.tick;
+    }
 }
 
 int main(int argc, char *args[])
 {
+    // --tick-rate 60|120|240|1000 picks the simulation rate, --software uses SDL's software
+    // renderer, --half-cleared starts with every other brick gone and --text-bench times
+    // HUD text updates and quits. --present-hitch MS stalls every 60th present and
+    // --particle-burst N sets the particles per destroyed brick. --audio-buffer N sets the
+    // audio device's buffer in frames and --music PATH plays a WAV or a .mod module in the
+    // background.
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+    bool isHalfCleared = false;
+    bool isRunningTextBench = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(args[i], "--tick-rate") == 0 && i + 1 < argc)
+        {
+            ticksPerSecond = atoi(args[++i]);
+        }
+        else if (strcmp(args[i], "--software") == 0)
+        {
+            rendererFlags = SDL_RENDERER_SOFTWARE;
+        }
+        else if (strcmp(args[i], "--half-cleared") == 0)
+        {
+            isHalfCleared = true;
+        }
+        else if (strcmp(args[i], "--render-stats") == 0)
+        {
+            isPrintingRenderStats = true;
+        }
+        else if (strcmp(args[i], "--text-bench") == 0)
+        {
+            isRunningTextBench = true;
+        }
+        else if (strcmp(args[i], "--present-hitch") == 0 && i + 1 < argc)
+        {
+            presentHitchMilliseconds = atoi(args[++i]);
+        }
+        else if (strcmp(args[i], "--particle-burst") == 0 && i + 1 < argc)
+        {
+            particleBurst = atoi(args[++i]);
+        }
+        else if (strcmp(args[i], "--music") == 0 && i + 1 < argc)
+        {
+            musicPath = args[++i];
+        }
+        else if (strcmp(args[i], "--audio-buffer") == 0 && i + 1 < argc)
+        {
+            audioBufferFrames = atoi(args[++i]);
+        }
+    }
+
+    if (ticksPerSecond <= 0)
+    {
+        ticksPerSecond = 120;
+    }
+
+    if (audioBufferFrames <= 0)
+    {
+        audioBufferFrames = 256;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
     {
         std::cout << "SDL crashed. Error: " << SDL_GetError();
@@ -262,7 +727,7 @@ int main(int argc, char *args[])
         return 1;
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (renderer == nullptr)
     {
         std::cerr << "Failed to create renderer: " << SDL_GetError() << std::endl;
@@ -271,36 +736,96 @@ int main(int argc, char *args[])
         return 1;
     }
 
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
-    {
-        printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
-    }
+    openAudio();
 
     if (TTF_Init() == -1)
     {
         return 1;
     }
 
-    fontSquare = TTF_OpenFont("res/fonts/square_sans_serif_7.ttf", 32);
+    hudAtlasTexture = loadCookedGlyphAtlas(renderer, "res/cooked/square_sans_serif_7.font", hudAtlas);
+
+    // The font is only opened when its atlas hasn't been cooked, and for --text-bench.
+    if (hudAtlasTexture == nullptr || isRunningTextBench)
+    {
+        fontSquare = TTF_OpenFont("res/fonts/square_sans_serif_7.ttf", 32);
+    }
+
+    if (hudAtlasTexture == nullptr)
+    {
+        hudAtlasTexture = bakeGlyphAtlas(renderer, fontSquare, hudAtlas);
+    }
+
+    if (isRunningTextBench)
+    {
+        runTextBench();
+        quitGame();
+        return 0;
+    }
 
-    updateTextureText(scoreTexture, "Score: 0");
-    updateTextureText(liveTexture, "Lives: 2");
+    initAudioStage(audioStage, SOUND_VOICES);
+    audioStage.startDelay = mixer.startDelay;
 
-    collisionSound = loadSound("res/sounds/magic.wav");
-    collisionWithPlayerSound = loadSound("res/sounds/drop.wav");
+    // The paddle and ceiling bounces are rarer, they win a voice over brick and wall hits.
+    collisionSoundId = addStageSoundFile("res/cooked/magic.pcm", "res/sounds/magic.wav", 1);
+    collisionWithPlayerSoundId = addStageSoundFile("res/cooked/drop.pcm", "res/sounds/drop.wav", 2);
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    if (musicPath != nullptr && audioDevice != 0)
+    {
+        startMusic(musicPath);
+    }
 
-    while (true)
+    // The mixer's sounds are all added, the callback can start.
+    if (audioDevice != 0)
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
-        previousFrameTime = currentFrameTime;
+        SDL_PauseAudioDevice(audioDevice, 0);
+    }
+
+    initGame(game, PC_CONFIG);
+
+    if (isHalfCleared)
+    {
+        for (int row = 0; row < game.bricks.rows; row++)
+        {
+            for (int column = row % 2; column < game.bricks.columns; column += 2)
+            {
+                destroyBrick(game.bricks, row, column);
+            }
+        }
+    }
 
+    createBrickLayer(renderer, brickLayer, game.config);
+
+    renderBackend = new SdlRenderBackend(renderer);
+    hudAtlasTextureId = renderBackend->addTexture(hudAtlasTexture);
+    brickLayerTextureId = renderBackend->addTexture(brickLayer.texture);
+
+    previousPlayer = game.player;
+    previousBall = game.ball;
+
+    initParticles();
+
+    // The first frame draws the game as it starts.
+    publishSnapshot(0);
+
+    isSimulationRunning = true;
+    simulationThread = SDL_CreateThread(runSimulation, "simulation", NULL);
+
+    if (simulationThread == nullptr)
+    {
+        printf("Unable to start the simulation thread! SDL Error: %s\n", SDL_GetError());
+        quitGame();
+        return 1;
+    }
+
+    renderStatsStart = SDL_GetPerformanceCounter();
+
+    while (true)
+    {
         handleEvents();
-        update(deltaTime);
+        readInput();
+
+        playSounds();
         render();
     }
 
@@ -3,6 +3,11 @@
 #include <SDL2/SDL_ttf.h>
 #include <iostream>
 #include <vector>
+#include "game.h"
+#include "presets.h"
+#include "sdl_draw.h"
+#include "text.h"
+#include "timestep.h"
 
 const int SCREEN_WIDTH = 480;
 const int SCREEN_HEIGHT = 272;
@@ -13,66 +18,25 @@ SDL_GameController* controller = nullptr;
 
 TTF_Font *fontSquare = nullptr;
 
-SDL_Texture *scoreTexture = nullptr;
-SDL_Rect scoreBounds;
+GlyphAtlas hudAtlas;
+SDL_Texture *hudAtlasTexture = nullptr;
 
-SDL_Texture *liveTexture = nullptr;
-SDL_Rect liveBounds;
-
-SDL_Color fontColor = {255, 255, 255};
+char scoreText[32] = "Score: 0";
+char livesText[32] = "Lives: 2";
 
 Mix_Chunk *collisionSound = nullptr;
 Mix_Chunk *collisionWithPlayerSound = nullptr;
 
-SDL_Rect player = {SCREEN_WIDTH / 2, SCREEN_HEIGHT - 16, 36, 8};
-
-int playerScore;
-int playerLives = 2;
-
-SDL_Rect ball = {SCREEN_WIDTH / 2 - 8, SCREEN_HEIGHT / 2 - 8, 8, 8};
-
-int playerSpeed = 400;
-int ballVelocityX = 225;
-int ballVelocityY = 225;
-
-bool isAutoPlayMode = true;
-
-typedef struct
-{
-    SDL_Rect bounds;
-    bool isDestroyed;
-    int points;
-} Brick;
-
-std::vector<Brick> createBricks()
-{
-    std::vector<Brick> bricks;
-    bricks.reserve(112);
+Game game;
 
-    int brickPoints = 8;
-    int positionX;
-    int positionY = 20;
-
-    for (int row = 0; row < 8; row++)
-    {
-        positionX = 2;
-
-        for (int column = 0; column < 14; column++)
-        {
-            Brick actualBrick = {{positionX, positionY, 32, 8}, false, brickPoints};
-
-            bricks.push_back(actualBrick);
-            positionX += 34;
-        }
-
-        brickPoints--;
-        positionY += 10;
-    }
+// The game is simulated at a fixed rate and rendered between the last two ticks.
+const int TICKS_PER_SECOND = 120;
+const int MAX_TICKS_PER_FRAME = 8;
 
-    return bricks;
-}
+Bounds previousPlayer;
+Bounds previousBall;
 
-std::vector<Brick> bricks = createBricks();
+BrickLayer brickLayer;
 
 Mix_Chunk *loadSound(const char *p_filePath)
 {
@@ -101,6 +65,11 @@ void handleEvents() {
 
     while (SDL_PollEvent(&event)) {
 
+        // Render target contents are lost with the device on some backends.
+        if (event.type == SDL_RENDER_TARGETS_RESET) {
+            brickLayer.isDirty = true;
+        }
+
         if (event.type == SDL_QUIT) {
             
             quitGame();
@@ -109,139 +78,66 @@ void handleEvents() {
     }
 }
 
-void updateTextureText(SDL_Texture *&texture, const char *text) {
-
-    if (fontSquare == nullptr) {
-        printf("TTF_OpenFont fontSquare: %s\n", TTF_GetError());
-    }
-
-    SDL_Surface *surface = TTF_RenderUTF8_Blended(fontSquare, text, fontColor);
-    if (surface == nullptr) {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create text surface! SDL Error: %s\n", SDL_GetError());
-        exit(3);
-    }
-
-    SDL_DestroyTexture(texture);
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr) {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
-    }
-
-    SDL_FreeSurface(surface);
-}
- 
-void update(float deltaTime) {
-
+void update(Number deltaTime)
+{
     SDL_GameControllerUpdate();
 
     if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_START))
     {
-        isAutoPlayMode = !isAutoPlayMode;
+        game.isAutoPlayMode = !game.isAutoPlayMode;
     }
 
-    if (isAutoPlayMode && ball.x < SCREEN_WIDTH - player.w)
-    {
-        player.x = ball.x;
-    }
+    GameInput input = {
+        SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) != 0,
+        SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) != 0,
+    };
 
-    if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) && player.x > 0)
-    {
-        player.x -= playerSpeed * deltaTime;
-    }
+    previousPlayer = game.player;
+    previousBall = game.ball;
 
-    else if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) && player.x < SCREEN_WIDTH - player.w)
-    {
-        player.x += playerSpeed * deltaTime;
-    }
+    int events = updateGame(game, input, deltaTime);
 
-    if (ball.y > SCREEN_HEIGHT + ball.h)
+    if (events & GAME_EVENT_LIFE_LOST)
     {
-        ball.x = SCREEN_WIDTH / 2 - ball.w;
-        ball.y = SCREEN_HEIGHT / 2 - ball.h;
-
-        ballVelocityX *= -1;
-
-        if (playerLives > 0)
-        {
-            playerLives--;
+        // The ball was served again, don't slide it across the screen.
+        previousBall = game.ball;
 
-            std::string livesString = "lives: " + std::to_string(playerLives);
-
-            updateTextureText(liveTexture, livesString.c_str());
-        }
+        snprintf(livesText, sizeof(livesText), "lives: %d", game.playerLives);
     }
 
-    if (ball.x < 0 || ball.x > SCREEN_WIDTH - ball.w)
+    if (events & GAME_EVENT_BRICK_HIT)
     {
-        ballVelocityX *= -1;
-        Mix_PlayChannel(-1, collisionSound, 0);
+        snprintf(scoreText, sizeof(scoreText), "score: %d", game.playerScore);
     }
 
-    if (SDL_HasIntersection(&player, &ball) || ball.y < 0)
+    if (events & (GAME_EVENT_WALL_HIT | GAME_EVENT_BRICK_HIT))
     {
-        ballVelocityY *= -1;
-        Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
+        Mix_PlayChannel(-1, collisionSound, 0);
     }
 
-    for (auto actualBrick = bricks.begin(); actualBrick != bricks.end();)
+    if (events & (GAME_EVENT_PLAYER_HIT | GAME_EVENT_CEILING_HIT))
     {
-        if (!actualBrick->isDestroyed && SDL_HasIntersection(&actualBrick->bounds, &ball))
-        {
-            ballVelocityY *= -1;
-            actualBrick->isDestroyed = true;
-
-            playerScore += actualBrick->points;
-
-            std::string scoreString = "score: " + std::to_string(playerScore);
-
-            updateTextureText(scoreTexture, scoreString.c_str());
-
-            Mix_PlayChannel(-1, collisionSound, 0);
-        }
-
-        if (actualBrick->isDestroyed)
-        {
-            bricks.erase(actualBrick);
-        }
-        else
-        {
-            actualBrick++;
-        }
+        Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
     }
-
-    ball.x += ballVelocityX * deltaTime;
-    ball.y += ballVelocityY * deltaTime;
 }
 
-void render()
+void render(float alpha)
 {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    SDL_QueryTexture(scoreTexture, NULL, NULL, &scoreBounds.w, &scoreBounds.h);
-    scoreBounds.x = 100;
-    scoreBounds.y = scoreBounds.h / 2 - 5;
-    SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreBounds);
-
-    SDL_QueryTexture(liveTexture, NULL, NULL, &liveBounds.w, &liveBounds.h);
-    liveBounds.x = 300;
-    liveBounds.y = liveBounds.h / 2 - 5;
-    SDL_RenderCopy(renderer, liveTexture, NULL, &liveBounds);
+    drawText(renderer, hudAtlasTexture, hudAtlas, scoreText, 100, hudAtlas.lineHeight / 2 - 5);
+    drawText(renderer, hudAtlasTexture, hudAtlas, livesText, 300, hudAtlas.lineHeight / 2 - 5);
 
-    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
+    drawBrickLayer(renderer, brickLayer, game.config, game.bricks);
 
-    for (Brick brick : bricks)
-    {
-        if (!brick.isDestroyed)
-            SDL_RenderFillRect(renderer, &brick.bounds);
-    }
+    SDL_Rect playerAndBall[2] = {
+        toRect(interpolateBounds(previousPlayer, game.player, alpha)),
+        toRect(interpolateBounds(previousBall, game.ball, alpha)),
+    };
 
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-
-    SDL_RenderFillRect(renderer, &player);
-    SDL_RenderFillRect(renderer, &ball);
+    SDL_RenderFillRects(renderer, playerAndBall, 2);
 
     SDL_RenderPresent(renderer);
 }
@@ -286,25 +182,37 @@ int main(int argc, char *args[]) {
 
     fontSquare = TTF_OpenFont("square_sans_serif_7.ttf", 16);
 
-    updateTextureText(scoreTexture, "Score: 0");
-    updateTextureText(liveTexture, "Lives: 2");
+    hudAtlasTexture = bakeGlyphAtlas(renderer, fontSquare, hudAtlas);
 
     collisionSound = loadSound("magic.wav");
     collisionWithPlayerSound = loadSound("drop.wav");
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    initGame(game, PSP_CONFIG);
+    createBrickLayer(renderer, brickLayer, game.config);
+
+    previousPlayer = game.player;
+    previousBall = game.ball;
+
+    FixedTimestep timestep;
+    initFixedTimestep(timestep, TICKS_PER_SECOND, MAX_TICKS_PER_FRAME, SDL_GetPerformanceFrequency());
+
+    Uint64 previousFrameTime = SDL_GetPerformanceCounter();
+    Uint64 currentFrameTime = previousFrameTime;
 
     while (true)
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
+        currentFrameTime = SDL_GetPerformanceCounter();
+        int ticks = advanceFixedTimestep(timestep, currentFrameTime - previousFrameTime);
         previousFrameTime = currentFrameTime;
 
         handleEvents();
-        update(deltaTime);
-        render();
+
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            update(fixedTimestepDelta(timestep));
+        }
+
+        render(fixedTimestepAlpha(timestep));
     }
 
     return 0;
@@ -1,6 +1,11 @@
 #include "sdl_starter.h"
 #include "sdl_assets_loader.h"
 #include <vector>
+#include "audio_stage.h"
+#include "game.h"
+#include "presets.h"
+#include "sdl_draw.h"
+#include "timestep.h"
 
 SDL_Window *window = nullptr;
 SDL_Renderer *renderer = nullptr;
@@ -9,69 +14,52 @@ SDL_GameController *controller = nullptr;
 bool isGamePaused;
 int shouldCloseTheGame = 0;
 
-SDL_Texture *pauseGameTexture = nullptr;
-SDL_Rect pauseGameBounds;
-
 TTF_Font *font = nullptr;
 
-SDL_Texture *scoreTexture = nullptr;
-SDL_Rect scoreBounds;
+GlyphAtlas hudAtlas;
+SDL_Texture *hudAtlasTexture = nullptr;
 
-SDL_Texture *liveTexture = nullptr;
-SDL_Rect liveBounds;
+char scoreText[32] = "score: 0";
+char livesText[32] = "lives: 2";
 
 Mix_Chunk *collisionSound = nullptr;
 Mix_Chunk *collisionWithPlayerSound = nullptr;
 
-SDL_Rect player = {SCREEN_WIDTH / 2, SCREEN_HEIGHT - 32, 74, 16};
-
-int playerScore;
-int playerLives = 2;
-int playerSpeed = 800;
-
-SDL_Rect ball = {SCREEN_WIDTH / 2 - 20, SCREEN_HEIGHT / 2 - 20, 20, 20};
+// Sounds are queued wherever they happen and started once per frame through the audio
+// stage, which shares out the 5 mixer channels and steals one when all of them are busy.
+const int SOUND_VOICES = 5;
 
-int ballVelocityX = 425;
-int ballVelocityY = 425;
+SpscQueue<SoundEvent> soundEvents(64);
+AudioStage audioStage;
+std::vector<VoiceStart> voiceStarts;
+std::vector<Mix_Chunk *> stageChunks;
+int collisionSoundId = -1;
+int collisionWithPlayerSoundId = -1;
 
-bool isAutoPlayMode = true;
-
-typedef struct
+void queueSound(int sound)
 {
-    SDL_Rect bounds;
-    bool isDestroyed;
-    int points;
-} Brick;
+    SoundEvent event = {sound};
+    soundEvents.push(event);
+}
 
-std::vector<Brick> createBricks()
-{
-    std::vector<Brick> bricks;
-    bricks.reserve(200);
+Game game;
 
-    int brickPoints = 10;
-    int positionX;
-    int positionY = 50;
+// The game is simulated at a fixed rate and rendered between the last two ticks.
+const int TICKS_PER_SECOND = 120;
+const int MAX_TICKS_PER_FRAME = 8;
 
-    for (int row = 0; row < 10; row++)
-    {
-        positionX = 0;
+Bounds previousPlayer;
+Bounds previousBall;
 
-        for (int column = 0; column < 20; column++)
-        {
-            Brick actualBrick = {{positionX, positionY, 60, 20}, false, brickPoints};
+BrickLayer brickLayer;
 
-            bricks.push_back(actualBrick);
-            positionX += 64;
-        }
+// The paddle and the ball are sprites on one atlas page, so both copies use one texture.
+const int SPRITE_PAGE_SIZE = 256;
 
-        brickPoints--;
-        positionY += 22;
-    }
-
-    return bricks;
-}
-
-std::vector<Brick> bricks = createBricks();
+SpriteAtlas sprites;
+int playerSprite = -1;
+int ballSprite = -1;
+bool areSpritesBuilt = false;
 
 void quitGame()
 {
@@ -90,6 +78,12 @@ void handleEvents()
 
     while (SDL_PollEvent(&event))
     {
+        // Render target contents are lost with the device on some backends.
+        if (event.type == SDL_RENDER_TARGETS_RESET)
+        {
+            brickLayer.isDirty = true;
+        }
+
         if (event.type == SDL_QUIT)
         {
             shouldCloseTheGame = 1;
@@ -105,128 +99,125 @@ void handleEvents()
             if (event.jbutton.button == JOY_PLUS)
             {
                 isGamePaused = !isGamePaused;
-                Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
+                queueSound(collisionWithPlayerSoundId);
             }
 
             if (event.jbutton.button == JOY_A)
             {
-                isAutoPlayMode = !isAutoPlayMode;
-                Mix_PlayChannel(-1, collisionSound, 0);
+                game.isAutoPlayMode = !game.isAutoPlayMode;
+                queueSound(collisionSoundId);
             }
         }
     }
 }
 
-void update(float deltaTime)
+void update(Number deltaTime)
 {
-    if (isAutoPlayMode && ball.x < SCREEN_WIDTH - player.w)
-    {
-        player.x = ball.x;
-    }
+    GameInput input = {
+        SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) != 0,
+        SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) != 0,
+    };
+
+    previousPlayer = game.player;
+    previousBall = game.ball;
+
+    int events = updateGame(game, input, deltaTime);
 
-    if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) && player.x > 0)
+    if (events & GAME_EVENT_LIFE_LOST)
     {
-        player.x -= playerSpeed * deltaTime;
+        // The ball was served again, don't slide it across the screen.
+        previousBall = game.ball;
+
+        snprintf(livesText, sizeof(livesText), "lives: %d", game.playerLives);
     }
 
-    else if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) && player.x < SCREEN_WIDTH - player.w)
+    if (events & GAME_EVENT_BRICK_HIT)
     {
-        player.x += playerSpeed * deltaTime;
+        snprintf(scoreText, sizeof(scoreText), "score: %d", game.playerScore);
     }
 
-    if (ball.y > SCREEN_HEIGHT + ball.h)
+    if (events & (GAME_EVENT_WALL_HIT | GAME_EVENT_BRICK_HIT))
     {
-        ball.x = SCREEN_WIDTH / 2 - ball.w;
-        ball.y = SCREEN_HEIGHT / 2 - ball.h;
-
-        ballVelocityX *= -1;
-
-        if (playerLives > 0)
-        {
-            playerLives--;
-
-            std::string livesString = "lives: " + std::to_string(playerLives);
-
-            updateTextureText(liveTexture, livesString.c_str(), font, renderer);
-        }
+        queueSound(collisionSoundId);
     }
 
-    if (ball.x < 0 || ball.x > SCREEN_WIDTH - ball.w)
+    if (events & (GAME_EVENT_PLAYER_HIT | GAME_EVENT_CEILING_HIT))
     {
-        ballVelocityX *= -1;
-        Mix_PlayChannel(-1, collisionSound, 0);
+        queueSound(collisionWithPlayerSoundId);
     }
+}
+
+SDL_Surface *createSpriteImage(const Bounds &bounds)
+{
+    SDL_Surface *image = SDL_CreateRGBSurfaceWithFormat(0, (int)bounds.w, (int)bounds.h, 32, SDL_PIXELFORMAT_RGBA32);
 
-    if (SDL_HasIntersection(&player, &ball) || ball.y < 0)
+    if (image != nullptr)
     {
-        ballVelocityY *= -1;
-        Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
+        SDL_FillRect(image, NULL, SDL_MapRGBA(image->format, 255, 255, 255, 255));
     }
 
-    for (auto actualBrick = bricks.begin(); actualBrick != bricks.end();)
-    {
-        if (!actualBrick->isDestroyed && SDL_HasIntersection(&actualBrick->bounds, &ball))
-        {
-            ballVelocityY *= -1;
-            actualBrick->isDestroyed = true;
+    return image;
+}
 
-            playerScore += actualBrick->points;
-            
-            std::string scoreString = "score: " + std::to_string(playerScore);
+void buildSprites()
+{
+    playerSprite = addSpriteImage(sprites, createSpriteImage(game.player));
+    ballSprite = addSpriteImage(sprites, createSpriteImage(game.ball));
 
-            updateTextureText(scoreTexture, scoreString.c_str(), font, renderer);
+    areSpritesBuilt = playerSprite >= 0 && ballSprite >= 0 && buildSpriteAtlas(renderer, sprites, SPRITE_PAGE_SIZE);
+}
 
-            Mix_PlayChannel(-1, collisionSound, 0);
-        }
+int addStageChunk(Mix_Chunk *chunk, int priority)
+{
+    stageChunks.push_back(chunk);
 
-        if (actualBrick->isDestroyed)
-        {
-            bricks.erase(actualBrick);
-        }
-        else
-        {
-            actualBrick++;
-        }
-    }
+    return addStageSound(audioStage, priority, chunkSeconds(chunk));
+}
 
-    ball.x += ballVelocityX * deltaTime;
-    ball.y += ballVelocityY * deltaTime;
+void playSounds()
+{
+    voiceStarts.clear();
+    runAudioStage(audioStage, soundEvents, SDL_GetTicks() / 1000.0, voiceStarts);
+
+    for (const VoiceStart &start : voiceStarts)
+    {
+        Mix_PlayChannel(start.voice, stageChunks[start.sound], 0);
+    }
 }
 
-void render()
+void render(float alpha)
 {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    SDL_QueryTexture(scoreTexture, NULL, NULL, &scoreBounds.w, &scoreBounds.h);
-    scoreBounds.x = 300;
-    scoreBounds.y = scoreBounds.h / 2 - 10;
-    SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreBounds);
-
-    SDL_QueryTexture(liveTexture, NULL, NULL, &liveBounds.w, &liveBounds.h);
-    liveBounds.x = 800;
-    liveBounds.y = liveBounds.h / 2 - 10;
-    SDL_RenderCopy(renderer, liveTexture, NULL, &liveBounds);
+    drawText(renderer, hudAtlasTexture, hudAtlas, scoreText, 300, hudAtlas.lineHeight / 2 - 10);
+    drawText(renderer, hudAtlasTexture, hudAtlas, livesText, 800, hudAtlas.lineHeight / 2 - 10);
 
     if (isGamePaused)
     {
-        SDL_RenderCopy(renderer, pauseGameTexture, NULL, &pauseGameBounds);
+        const char *pauseText = "Game Paused";
+
+        drawText(renderer, hudAtlasTexture, hudAtlas, pauseText, SCREEN_WIDTH / 2 - measureText(hudAtlas, pauseText) / 2,
+                 SCREEN_HEIGHT / 2 - hudAtlas.lineHeight / 2);
     }
 
-    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
+    drawBrickLayer(renderer, brickLayer, game.config, game.bricks);
 
-    for (Brick brick : bricks)
+    SDL_Rect playerAndBall[2] = {
+        toRect(interpolateBounds(previousPlayer, game.player, alpha)),
+        toRect(interpolateBounds(previousBall, game.ball, alpha)),
+    };
+
+    if (areSpritesBuilt)
     {
-        if (!brick.isDestroyed)
-        {
-            SDL_RenderFillRect(renderer, &brick.bounds);
-        }
+        drawSprite(renderer, sprites, playerSprite, playerAndBall[0]);
+        drawSprite(renderer, sprites, ballSprite, playerAndBall[1]);
+    }
+    else
+    {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderFillRects(renderer, playerAndBall, 2);
     }
-
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-
-    SDL_RenderFillRect(renderer, &player);
-    SDL_RenderFillRect(renderer, &ball);
 
     SDL_RenderPresent(renderer);
 }
@@ -256,40 +247,62 @@ int main(int argc, char **argv)
         }
     }
 
-    font = TTF_OpenFont("data/LeroyLetteringLightBeta01.ttf", 36);
+    // What breakout_cook made is loaded as it is, otherwise the sources are decoded.
+    hudAtlasTexture = loadCookedGlyphAtlas(renderer, "data/cooked/LeroyLetteringLightBeta01.font", hudAtlas);
+
+    if (hudAtlasTexture == nullptr)
+    {
+        font = TTF_OpenFont("data/LeroyLetteringLightBeta01.ttf", 36);
+        hudAtlasTexture = bakeGlyphAtlas(renderer, font, hudAtlas);
+    }
+
+    collisionSound = loadCookedSound("data/cooked/pop1.pcm");
+    collisionWithPlayerSound = loadCookedSound("data/cooked/pop2.pcm");
+
+    if (collisionSound == nullptr)
+    {
+        collisionSound = loadSound("data/pop1.wav");
+    }
+
+    if (collisionWithPlayerSound == nullptr)
+    {
+        collisionWithPlayerSound = loadSound("data/pop2.wav");
+    }
 
-    updateTextureText(scoreTexture, "score: 0", font, renderer);
-    updateTextureText(liveTexture, "lives: 2", font, renderer);
+    initAudioStage(audioStage, SOUND_VOICES);
+    collisionSoundId = addStageChunk(collisionSound, 1);
+    collisionWithPlayerSoundId = addStageChunk(collisionWithPlayerSound, 2);
 
-    updateTextureText(pauseGameTexture, "Game Paused", font, renderer);
+    initGame(game, SWITCH_CONFIG);
+    createBrickLayer(renderer, brickLayer, game.config);
+    buildSprites();
 
-    SDL_QueryTexture(pauseGameTexture, NULL, NULL, &pauseGameBounds.w, &pauseGameBounds.h);
-    pauseGameBounds.x = SCREEN_WIDTH / 2 - pauseGameBounds.w / 2;
-    pauseGameBounds.y = SCREEN_HEIGHT / 2 - pauseGameBounds.h / 2;
+    previousPlayer = game.player;
+    previousBall = game.ball;
 
-    collisionSound = loadSound("data/pop1.wav");
-    collisionWithPlayerSound = loadSound("data/pop2.wav");
+    FixedTimestep timestep;
+    initFixedTimestep(timestep, TICKS_PER_SECOND, MAX_TICKS_PER_FRAME, SDL_GetPerformanceFrequency());
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    Uint64 previousFrameTime = SDL_GetPerformanceCounter();
+    Uint64 currentFrameTime = previousFrameTime;
 
     while (!shouldCloseTheGame && appletMainLoop())
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
+        currentFrameTime = SDL_GetPerformanceCounter();
+        int ticks = advanceFixedTimestep(timestep, currentFrameTime - previousFrameTime);
         previousFrameTime = currentFrameTime;
 
         SDL_GameControllerUpdate();
 
         handleEvents();
 
-        if (!isGamePaused)
+        for (int tick = 0; tick < ticks && !isGamePaused; tick++)
         {
-            update(deltaTime);
+            update(fixedTimestepDelta(timestep));
         }
 
-        render();
+        playSounds();
+        render(fixedTimestepAlpha(timestep));
     }
 
     quitGame();
@@ -1,4 +1,6 @@
 #include "sdl_assets_loader.h"
+#include <deque>
+#include <utility>
 
 Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY)
 {
@@ -11,7 +13,7 @@ Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, i
         SDL_QueryTexture(texture, NULL, NULL, &textureBounds.w, &textureBounds.h);
     }
 
-    Sprite sprite = {texture, textureBounds}; 
+    Sprite sprite = {texture, textureBounds};
 
     return sprite;
 }
@@ -29,43 +31,56 @@ Mix_Chunk *loadSound(const char *filePath)
     return sound;
 }
 
-Mix_Music *loadMusic(const char *filePath)
+// Mix_QuickLoad_RAW() plays the samples where they are, so they are kept here for good.
+static std::deque<PcmSound> cookedSounds;
+
+Mix_Chunk *loadCookedSound(const char *filePath)
 {
-    Mix_Music *music = nullptr;
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
 
-    music = Mix_LoadMUS(filePath);
-    if (music == nullptr)
+    if (Mix_QuerySpec(&frequency, &format, &channels) == 0 || format != AUDIO_S16SYS)
     {
-        printf("Failed to load music! SDL_mixer Error: %s\n", Mix_GetError());
+        return nullptr;
     }
 
-    return music;
+    PcmSound sound;
+
+    if (!loadCookedPcm(filePath, sound) || sound.rate != frequency || sound.channels != channels)
+    {
+        return nullptr;
+    }
+
+    cookedSounds.push_back(std::move(sound));
+    std::vector<int16_t> &samples = cookedSounds.back().samples;
+
+    return Mix_QuickLoad_RAW((Uint8 *)samples.data(), (Uint32)(samples.size() * sizeof(int16_t)));
 }
 
-void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer)
+double chunkSeconds(Mix_Chunk *chunk)
 {
-    SDL_Color fontColor = {255, 255, 255};
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
 
-    if (fontSquare == nullptr)
+    if (chunk == nullptr || Mix_QuerySpec(&frequency, &format, &channels) == 0)
     {
-        printf("TTF_OpenFont fontSquare: %s\n", TTF_GetError());
+        return 0;
     }
 
-    SDL_Surface *surface = TTF_RenderUTF8_Blended(fontSquare, text, fontColor);
-    if (surface == nullptr)
-    {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create text surface! SDL Error: %s\n", SDL_GetError());
-        exit(3);
-    }
+    return (double)chunk->alen / (SDL_AUDIO_BITSIZE(format) / 8 * channels) / frequency;
+}
+
+Mix_Music *loadMusic(const char *filePath)
+{
+    Mix_Music *music = nullptr;
 
-    SDL_DestroyTexture(texture);
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr)
+    music = Mix_LoadMUS(filePath);
+    if (music == nullptr)
     {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
+        printf("Failed to load music! SDL_mixer Error: %s\n", Mix_GetError());
     }
 
-    SDL_FreeSurface(surface);
-}
\ No newline at end of file
+    return music;
+}
@@ -5,6 +5,7 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <iostream>
+#include "cooked.h"
 
 typedef struct
 {
@@ -16,6 +17,11 @@ Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, i
 
 Mix_Chunk *loadSound(const char *filePath);
 
-Mix_Music *loadMusic(const char *filePath);
+// The sound breakout_cook made for this port, handed to SDL_mixer as it is. nullptr when
+// it hasn't been cooked or the audio device didn't open in the cooked format.
+Mix_Chunk *loadCookedSound(const char *filePath);
+
+// How long chunk plays on the opened audio device, 0 when it can't tell.
+double chunkSeconds(Mix_Chunk *chunk);
 
-void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer);
\ No newline at end of file
+Mix_Music *loadMusic(const char *filePath);
@@ -4,6 +4,10 @@
 #include <romfs-wiiu.h>
 #include <whb/proc.h>
 #include <vector>
+#include "game.h"
+#include "presets.h"
+#include "sdl_draw.h"
+#include "timestep.h"
 
 SDL_Window *window = nullptr;
 SDL_Renderer *renderer = nullptr;
@@ -12,69 +16,27 @@ SDL_GameController *controller = nullptr;
 bool isGamePaused;
 int shouldCloseTheGame = 0;
 
-SDL_Texture *pauseGameTexture = nullptr;
-SDL_Rect pauseGameBounds;
-
 TTF_Font *font = nullptr;
 
-SDL_Texture *scoreTexture = nullptr;
-SDL_Rect scoreBounds;
+GlyphAtlas hudAtlas;
+SDL_Texture *hudAtlasTexture = nullptr;
 
-SDL_Texture *liveTexture = nullptr;
-SDL_Rect liveBounds;
+char scoreText[32] = "score: 0";
+char livesText[32] = "lives: 2";
 
 Mix_Chunk *collisionSound = nullptr;
 Mix_Chunk *collisionWithPlayerSound = nullptr;
 
-SDL_Rect player = {SCREEN_WIDTH / 2, SCREEN_HEIGHT - 32, 74, 16};
-
-int playerScore;
-int playerLives = 2;
-int playerSpeed = 800;
-
-SDL_Rect ball = {SCREEN_WIDTH / 2 - 20, SCREEN_HEIGHT / 2 - 20, 20, 20};
-
-int ballVelocityX = 425;
-int ballVelocityY = 425;
-
-bool isAutoPlayMode = true;
-
-typedef struct
-{
-    SDL_Rect bounds;
-    bool isDestroyed;
-    int points;
-} Brick;
-
-std::vector<Brick> createBricks()
-{
-    std::vector<Brick> bricks;
-    bricks.reserve(200);
-
-    int brickPoints = 10;
-    int positionX;
-    int positionY = 50;
-
-    for (int row = 0; row < 10; row++)
-    {
-        positionX = 0;
-
-        for (int column = 0; column < 20; column++)
-        {
-            Brick actualBrick = {{positionX, positionY, 60, 20}, false, brickPoints};
-
-            bricks.push_back(actualBrick);
-            positionX += 64;
-        }
+Game game;
 
-        brickPoints--;
-        positionY += 22;
-    }
+// The game is simulated at a fixed rate and rendered between the last two ticks.
+const int TICKS_PER_SECOND = 120;
+const int MAX_TICKS_PER_FRAME = 8;
 
-    return bricks;
-}
+Bounds previousPlayer;
+Bounds previousBall;
 
-std::vector<Brick> bricks = createBricks();
+BrickLayer brickLayer;
 
 void quitGame()
 {
@@ -93,6 +55,12 @@ void handleEvents()
 
     while (SDL_PollEvent(&event))
     {
+        // Render target contents are lost with the device on some backends.
+        if (event.type == SDL_RENDER_TARGETS_RESET)
+        {
+            brickLayer.isDirty = true;
+        }
+
         if (event.type == SDL_QUIT)
         {
             shouldCloseTheGame = 1;
@@ -113,123 +81,74 @@ void handleEvents()
 
             if (event.jbutton.button == BUTTON_A)
             {
-                isAutoPlayMode = !isAutoPlayMode;
+                game.isAutoPlayMode = !game.isAutoPlayMode;
                 Mix_PlayChannel(-1, collisionSound, 0);
             }
         }
     }
 }
 
-void update(float deltaTime)
+void update(Number deltaTime)
 {
-    if (isAutoPlayMode && ball.x < SCREEN_WIDTH - player.w)
-    {
-        player.x = ball.x;
-    }
+    GameInput input = {
+        SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) != 0,
+        SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) != 0,
+    };
 
-    if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) && player.x > 0)
-    {
-        player.x -= playerSpeed * deltaTime;
-    }
+    previousPlayer = game.player;
+    previousBall = game.ball;
 
-    else if (SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) && player.x < SCREEN_WIDTH - player.w)
-    {
-        player.x += playerSpeed * deltaTime;
-    }
+    int events = updateGame(game, input, deltaTime);
 
-    if (ball.y > SCREEN_HEIGHT + ball.h)
+    if (events & GAME_EVENT_LIFE_LOST)
     {
-        ball.x = SCREEN_WIDTH / 2 - ball.w;
-        ball.y = SCREEN_HEIGHT / 2 - ball.h;
-
-        ballVelocityX *= -1;
-
-        if (playerLives > 0)
-        {
-            playerLives--;
+        // The ball was served again, don't slide it across the screen.
+        previousBall = game.ball;
 
-            std::string livesString = "lives: " + std::to_string(playerLives);
-
-            updateTextureText(liveTexture, livesString.c_str(), font, renderer);
-        }
+        snprintf(livesText, sizeof(livesText), "lives: %d", game.playerLives);
     }
 
-    if (ball.x < 0 || ball.x > SCREEN_WIDTH - ball.w)
+    if (events & GAME_EVENT_BRICK_HIT)
     {
-        ballVelocityX *= -1;
-        Mix_PlayChannel(-1, collisionSound, 0);
+        snprintf(scoreText, sizeof(scoreText), "score: %d", game.playerScore);
     }
 
-    if (SDL_HasIntersection(&player, &ball) || ball.y < 0)
+    if (events & (GAME_EVENT_WALL_HIT | GAME_EVENT_BRICK_HIT))
     {
-        ballVelocityY *= -1;
-        Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
+        Mix_PlayChannel(-1, collisionSound, 0);
     }
 
-    for (auto actualBrick = bricks.begin(); actualBrick != bricks.end();)
+    if (events & (GAME_EVENT_PLAYER_HIT | GAME_EVENT_CEILING_HIT))
     {
-        if (!actualBrick->isDestroyed && SDL_HasIntersection(&actualBrick->bounds, &ball))
-        {
-            ballVelocityY *= -1;
-            actualBrick->isDestroyed = true;
-
-            playerScore += actualBrick->points;
-
-            std::string scoreString = "score: " + std::to_string(playerScore);
-
-            updateTextureText(scoreTexture, scoreString.c_str(), font, renderer);
-
-            Mix_PlayChannel(-1, collisionSound, 0);
-        }
-
-        if (actualBrick->isDestroyed)
-        {
-            bricks.erase(actualBrick);
-        }
-        else
-        {
-            actualBrick++;
-        }
+        Mix_PlayChannel(-1, collisionWithPlayerSound, 0);
     }
-
-    ball.x += ballVelocityX * deltaTime;
-    ball.y += ballVelocityY * deltaTime;
 }
 
-void render()
+void render(float alpha)
 {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    SDL_QueryTexture(scoreTexture, NULL, NULL, &scoreBounds.w, &scoreBounds.h);
-    scoreBounds.x = 300;
-    scoreBounds.y = scoreBounds.h / 2 - 10;
-    SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreBounds);
-
-    SDL_QueryTexture(liveTexture, NULL, NULL, &liveBounds.w, &liveBounds.h);
-    liveBounds.x = 800;
-    liveBounds.y = liveBounds.h / 2 - 10;
-    SDL_RenderCopy(renderer, liveTexture, NULL, &liveBounds);
+    drawText(renderer, hudAtlasTexture, hudAtlas, scoreText, 300, hudAtlas.lineHeight / 2 - 10);
+    drawText(renderer, hudAtlasTexture, hudAtlas, livesText, 800, hudAtlas.lineHeight / 2 - 10);
 
     if (isGamePaused)
     {
-        SDL_RenderCopy(renderer, pauseGameTexture, NULL, &pauseGameBounds);
+        const char *pauseText = "Game Paused";
+
+        drawText(renderer, hudAtlasTexture, hudAtlas, pauseText, SCREEN_WIDTH / 2 - measureText(hudAtlas, pauseText) / 2,
+                 SCREEN_HEIGHT / 2 - hudAtlas.lineHeight / 2);
     }
 
-    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
+    drawBrickLayer(renderer, brickLayer, game.config, game.bricks);
 
-    for (Brick brick : bricks)
-    {
-        if (!brick.isDestroyed)
-        {
-            SDL_RenderFillRect(renderer, &brick.bounds);
-        }
-    }
+    SDL_Rect playerAndBall[2] = {
+        toRect(interpolateBounds(previousPlayer, game.player, alpha)),
+        toRect(interpolateBounds(previousBall, game.ball, alpha)),
+    };
 
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-
-    SDL_RenderFillRect(renderer, &player);
-    SDL_RenderFillRect(renderer, &ball);
+    SDL_RenderFillRects(renderer, playerAndBall, 2);
 
     SDL_RenderPresent(renderer);
 }
@@ -255,38 +174,39 @@ int main(int argc, char **argv)
 
     font = TTF_OpenFont("fonts/LeroyLetteringLightBeta01.ttf", 36);
 
-    updateTextureText(scoreTexture, "score: 0", font, renderer);
-    updateTextureText(liveTexture, "lives: 2", font, renderer);
-
-    updateTextureText(pauseGameTexture, "Game Paused", font, renderer);
-
-    SDL_QueryTexture(pauseGameTexture, NULL, NULL, &pauseGameBounds.w, &pauseGameBounds.h);
-    pauseGameBounds.x = SCREEN_WIDTH / 2 - pauseGameBounds.w / 2;
-    pauseGameBounds.y = SCREEN_HEIGHT / 2 - pauseGameBounds.h / 2;
+    hudAtlasTexture = bakeGlyphAtlas(renderer, font, hudAtlas);
 
     collisionSound = loadSound("sounds/pop1.wav");
     collisionWithPlayerSound = loadSound("sounds/pop2.wav");
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    initGame(game, WII_U_CONFIG);
+    createBrickLayer(renderer, brickLayer, game.config);
+
+    previousPlayer = game.player;
+    previousBall = game.ball;
+
+    FixedTimestep timestep;
+    initFixedTimestep(timestep, TICKS_PER_SECOND, MAX_TICKS_PER_FRAME, SDL_GetPerformanceFrequency());
+
+    Uint64 previousFrameTime = SDL_GetPerformanceCounter();
+    Uint64 currentFrameTime = previousFrameTime;
 
     while (!shouldCloseTheGame && WHBProcIsRunning())
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
+        currentFrameTime = SDL_GetPerformanceCounter();
+        int ticks = advanceFixedTimestep(timestep, currentFrameTime - previousFrameTime);
         previousFrameTime = currentFrameTime;
 
         SDL_GameControllerUpdate();
 
         handleEvents();
 
-        if (!isGamePaused)
+        for (int tick = 0; tick < ticks && !isGamePaused; tick++)
         {
-            update(deltaTime);
+            update(fixedTimestepDelta(timestep));
         }
 
-        render();
+        render(fixedTimestepAlpha(timestep));
     }
 
     quitGame();
@@ -11,7 +11,7 @@ Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, i
         SDL_QueryTexture(texture, NULL, NULL, &textureBounds.w, &textureBounds.h);
     }
 
-    Sprite sprite = {texture, textureBounds}; 
+    Sprite sprite = {texture, textureBounds};
 
     return sprite;
 }
@@ -29,43 +29,29 @@ Mix_Chunk *loadSound(const char *filePath)
     return sound;
 }
 
-Mix_Music *loadMusic(const char *filePath)
+double chunkSeconds(Mix_Chunk *chunk)
 {
-    Mix_Music *music = nullptr;
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
 
-    music = Mix_LoadMUS(filePath);
-    if (music == nullptr)
+    if (chunk == nullptr || Mix_QuerySpec(&frequency, &format, &channels) == 0)
     {
-        printf("Failed to load music! SDL_mixer Error: %s\n", Mix_GetError());
+        return 0;
     }
 
-    return music;
+    return (double)chunk->alen / (SDL_AUDIO_BITSIZE(format) / 8 * channels) / frequency;
 }
 
-void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer)
+Mix_Music *loadMusic(const char *filePath)
 {
-    SDL_Color fontColor = {255, 255, 255};
-
-    if (fontSquare == nullptr)
-    {
-        printf("TTF_OpenFont fontSquare: %s\n", TTF_GetError());
-    }
-
-    SDL_Surface *surface = TTF_RenderUTF8_Blended(fontSquare, text, fontColor);
-    if (surface == nullptr)
-    {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create text surface! SDL Error: %s\n", SDL_GetError());
-        exit(3);
-    }
+    Mix_Music *music = nullptr;
 
-    SDL_DestroyTexture(texture);
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr)
+    music = Mix_LoadMUS(filePath);
+    if (music == nullptr)
     {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
+        printf("Failed to load music! SDL_mixer Error: %s\n", Mix_GetError());
     }
 
-    SDL_FreeSurface(surface);
-}
\ No newline at end of file
+    return music;
+}
@@ -16,6 +16,7 @@ Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, i
 
 Mix_Chunk *loadSound(const char *filePath);
 
-Mix_Music *loadMusic(const char *filePath);
+// How long chunk plays on the opened audio device, 0 when it can't tell.
+double chunkSeconds(Mix_Chunk *chunk);
 
-void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer);
\ No newline at end of file
+Mix_Music *loadMusic(const char *filePath);